@@ -100,3 +100,9 @@ dune_check_cxx_source_compiles("
   #include <functional>
   int main() { std::identity{}; }
 " DUNE_HAVE_CXX_STD_IDENTITY)
+
+# Check for `std::experimental::simd<...>`
+dune_check_cxx_source_compiles("
+  #include <experimental/simd>
+  int main() { return std::experimental::native_simd<double>(1.0)[0] == 1.0 ? 0 : 1; }
+" DUNE_HAVE_CXX_EXPERIMENTAL_SIMD)
@@ -0,0 +1,308 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_ARENA_ALLOCATOR_HH
+#define DUNE_ARENA_ALLOCATOR_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+/**
+ * @file
+ * @brief A monotonic arena and an allocator using it or any other
+ *        std::pmr::memory_resource.
+ */
+namespace Dune
+{
+  /**
+     @ingroup Allocators
+     @brief A monotonic memory resource handing out memory by bumping a pointer
+
+     The memory is taken in blocks of growing size from an upstream
+     std::pmr::memory_resource. Deallocation does nothing, all memory is
+     returned at once by release() or on destruction. This suits data
+     structures like RemoteIndices that allocate many small nodes during a
+     setup phase and free them all together.
+
+     After release() the next block is large enough for all memory
+     used before, such that a repeated setup phase only needs one block.
+
+     The arena is not thread-safe.
+   */
+  class Arena : public std::pmr::memory_resource
+  {
+  public:
+    /**
+     * @brief Create an arena.
+     * @param blockSize The size of the first block in bytes.
+     * @param upstream The resource to take the blocks from.
+     */
+    explicit Arena(std::size_t blockSize = 4096,
+                   std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+      : upstream_(upstream), initialBlockSize_(blockSize), nextBlockSize_(blockSize)
+    {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    //! return all memory to the upstream resource
+    ~Arena()
+    {
+      release();
+    }
+
+    /**
+     * @brief Return all memory to the upstream resource.
+     *
+     * The cost depends only on the number of blocks, not on the number
+     * of allocations.
+     */
+    void release() noexcept
+    {
+      std::size_t capacity = 0;
+      while(blocks_) {
+        Block* block = blocks_;
+        blocks_ = block->next_;
+        capacity += block->size_;
+        upstream_->deallocate(block, block->size_, alignof(std::max_align_t));
+      }
+      current_ = end_ = nullptr;
+      used_ = 0;
+      if(capacity > 0)
+        nextBlockSize_ = std::max(capacity, initialBlockSize_);
+    }
+
+    //! the number of bytes handed out since the last release()
+    std::size_t used() const noexcept
+    {
+      return used_;
+    }
+
+    //! the resource the blocks are taken from
+    std::pmr::memory_resource* upstream() const noexcept
+    {
+      return upstream_;
+    }
+
+  private:
+    //! header at the start of each block
+    struct Block
+    {
+      Block* next_;
+      std::size_t size_;
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+      std::uintptr_t current = reinterpret_cast<std::uintptr_t>(current_);
+      std::uintptr_t aligned = (current + alignment - 1) & ~std::uintptr_t(alignment - 1);
+      if(current_ && aligned <= reinterpret_cast<std::uintptr_t>(end_)
+         && bytes <= reinterpret_cast<std::uintptr_t>(end_) - aligned) {
+        current_ = reinterpret_cast<char*>(aligned + bytes);
+        used_ += bytes;
+        return reinterpret_cast<void*>(aligned);
+      }
+      grow(bytes + alignment);
+      return do_allocate(bytes, alignment);
+    }
+
+    //! nothing to do, the memory is returned by release()
+    void do_deallocate(void*, std::size_t, std::size_t) override
+    {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+      return this == &other;
+    }
+
+    //! take a new block with at least the given number of free bytes
+    void grow(std::size_t bytes)
+    {
+      std::size_t size = std::max(nextBlockSize_, bytes + sizeof(Block));
+      Block* block = static_cast<Block*>(upstream_->allocate(size, alignof(std::max_align_t)));
+      block->next_ = blocks_;
+      block->size_ = size;
+      blocks_ = block;
+      current_ = reinterpret_cast<char*>(block + 1);
+      end_ = reinterpret_cast<char*>(block) + size;
+      nextBlockSize_ = 2*size;
+    }
+
+    std::pmr::memory_resource* upstream_;
+    Block* blocks_ = nullptr;
+    char* current_ = nullptr;
+    char* end_ = nullptr;
+    std::size_t used_ = 0;
+    std::size_t initialBlockSize_;
+    std::size_t nextBlockSize_;
+  };
+
+  /**
+     @ingroup Allocators
+     @brief Select the memory resource of default constructed ArenaAllocators
+
+     Containers like SLList, ArrayList and RemoteIndices default construct
+     their allocators. While a scope is alive, the ArenaAllocators that are
+     default constructed in the same thread use its resource, e.g. an Arena.
+     Scopes may be nested. Without a scope std::pmr::get_default_resource()
+     is used.
+   */
+  class ArenaScope
+  {
+  public:
+    //! make resource the current resource of this thread
+    explicit ArenaScope(std::pmr::memory_resource& resource) noexcept
+      : previous_(top())
+    {
+      top() = &resource;
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    //! restore the previous resource
+    ~ArenaScope()
+    {
+      top() = previous_;
+    }
+
+    //! the resource used by default constructed ArenaAllocators
+    static std::pmr::memory_resource* current() noexcept
+    {
+      std::pmr::memory_resource* resource = top();
+      return resource ? resource : std::pmr::get_default_resource();
+    }
+
+  private:
+    static std::pmr::memory_resource*& top() noexcept
+    {
+      thread_local std::pmr::memory_resource* resource = nullptr;
+      return resource;
+    }
+
+    std::pmr::memory_resource* previous_;
+  };
+
+  /**
+     @ingroup Allocators
+     @brief Allocator taking its memory from a std::pmr::memory_resource
+
+     A default constructed allocator uses ArenaScope::current(), such that
+     containers like SLList, ArrayList and RemoteIndices allocate from an
+     Arena while an ArenaScope for it is alive. Each allocator keeps its
+     resource, i.e. the memory is returned to the resource it came from,
+     even after the scope ended.
+
+     @tparam T type of the object one wants to allocate
+   */
+  template <class T>
+  class ArenaAllocator {
+  public:
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T value_type;
+    template <class U> struct rebind {
+      typedef ArenaAllocator<U> other;
+    };
+
+    //! create a new ArenaAllocator using the current resource of ArenaScope
+    ArenaAllocator() noexcept
+      : resource_(ArenaScope::current())
+    {}
+    //! create a new ArenaAllocator using the given resource
+    ArenaAllocator(std::pmr::memory_resource* resource) noexcept
+      : resource_(resource)
+    {}
+    //! copy construct from an other ArenaAllocator, possibly for a different result type
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+      : resource_(other.resource())
+    {}
+
+    pointer address(reference x) const
+    {
+      return &x;
+    }
+    const_pointer address(const_reference x) const
+    {
+      return &x;
+    }
+
+    //! allocate n objects of type T
+    pointer allocate(size_type n,
+                     [[maybe_unused]] const void* hint = 0)
+    {
+      if (n > this->max_size())
+        throw std::bad_alloc();
+
+      return static_cast<pointer>(resource_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    //! deallocate n objects of type T at address p
+    void deallocate(pointer p, size_type n)
+    {
+      resource_->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    //! max size for allocate
+    size_type max_size() const noexcept
+    {
+      return size_type(-1) / sizeof(T);
+    }
+
+    //! construct an object of type T from variadic parameters
+    template<typename ... Args>
+    void construct(pointer p, Args&&... args)
+    {
+      ::new((void *)p)T(std::forward<Args>(args) ...);
+    }
+
+    //! destroy an object of type T (i.e. call the destructor)
+    void destroy(pointer p)
+    {
+      p->~T();
+    }
+
+    //! the resource the memory is taken from
+    std::pmr::memory_resource* resource() const noexcept
+    {
+      return resource_;
+    }
+
+    //! convert to the std::pmr allocator using the same resource
+    operator std::pmr::polymorphic_allocator<T>() const noexcept
+    {
+      return std::pmr::polymorphic_allocator<T>(resource_);
+    }
+
+  private:
+    std::pmr::memory_resource* resource_;
+  };
+
+  //! check whether allocators are equivalent
+  template<class T, class U>
+  bool
+  operator==(const ArenaAllocator<T> & a, const ArenaAllocator<U> & b)
+  {
+    return *a.resource() == *b.resource();
+  }
+
+  //! check whether allocators are not equivalent
+  template<class T, class U>
+  bool
+  operator!=(const ArenaAllocator<T> & a, const ArenaAllocator<U> & b)
+  {
+    return !(a == b);
+  }
+}
+
+#endif // DUNE_ARENA_ALLOCATOR_HH
@@ -0,0 +1,122 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark comparing the eager DenseVector operators with the
+ * expression templates of densevectorexpression.hh.
+ *
+ * The update a = b + alpha*c - d is evaluated for DynamicVector and
+ * FieldVector in three ways: with the eager operators, with a hand-written
+ * sequence of in-place operations, and with lazy().  For each variant the
+ * time per update and the number of heap allocations per update are reported;
+ * the latter are counted by replacing the global operator new.
+ *
+ * Usage: ./densevectorexpression_benchmark [options]
+ *
+ * options:
+ * -iterations: default: 1000000. Number of updates for the smallest
+ *              DynamicVector, scaled down for larger vectors.
+ *
+ * options are passed at the command-line (-key value).
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include <dune/common/densevectorexpression.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/timer.hh>
+
+// count all heap allocations of the program
+static std::size_t allocations = 0;
+
+void* operator new (std::size_t size)
+{
+  ++allocations;
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete (void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete (void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+Dune::ParameterTree options;
+
+// avoid that the compiler optimizes away the benchmarked kernels
+volatile double sink = 0;
+
+template<class F>
+void report(const std::string& name, int calls, F&& f)
+{
+  f(); // warm up
+  const std::size_t before = allocations;
+  Dune::Timer watch;
+  for (int r = 0; r < calls; ++r)
+    f();
+  const double time = watch.elapsed() / calls;
+  const double allocs = double(allocations - before) / calls;
+  std::cout << std::setw(12) << name << std::setw(14) << time << std::setw(14) << allocs;
+}
+
+template<class Vector>
+void run(const std::string& label, std::size_t n, int calls)
+{
+  Vector a, b, c, d;
+  if constexpr (requires { a.resize(n); })
+  {
+    a.resize(n); b.resize(n); c.resize(n); d.resize(n);
+  }
+  for (std::size_t i = 0; i < b.size(); ++i)
+  {
+    b[i] = 1.0 + i;
+    c[i] = 2.0 - i;
+    d[i] = 0.5 * i;
+  }
+  const double alpha = 0.25;
+
+  std::cout << std::setw(24) << label;
+  if constexpr (requires { alpha * c; })
+    report("eager", calls, [&]{ a = b + alpha*c - d; sink = sink + a[0]; });
+  else
+    report("eager", calls, [&]{ Vector ac = c; ac *= alpha; a = b + ac - d; sink = sink + a[0]; });
+  report("in-place", calls, [&]{ a = b; a.axpy(alpha, c); a -= d; sink = sink + a[0]; });
+  report("lazy", calls, [&]{ a = Dune::lazy(b) + alpha*Dune::lazy(c) - d; sink = sink + a[0]; });
+  std::cout << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  Dune::ParameterTreeParser::readOptions(argc, argv, options);
+  const int iterations = options.get("iterations", 1000000);
+
+  std::cout << "time per update [s] and heap allocations per update" << std::endl;
+  std::cout << std::scientific << std::setprecision(3);
+  std::cout << std::setw(24) << "vector"
+            << std::setw(12) << "variant" << std::setw(14) << "time" << std::setw(14) << "allocs"
+            << std::setw(12) << "variant" << std::setw(14) << "time" << std::setw(14) << "allocs"
+            << std::setw(12) << "variant" << std::setw(14) << "time" << std::setw(14) << "allocs"
+            << std::endl;
+
+  run<Dune::FieldVector<double,3>>("FieldVector<double,3>", 3, iterations);
+  run<Dune::FieldVector<double,16>>("FieldVector<double,16>", 16, iterations);
+  for (std::size_t n : {16, 1000, 100000})
+    run<Dune::DynamicVector<double>>("DynamicVector n=" + std::to_string(n), n,
+                                     std::max<int>(1, iterations * 16 / n));
+  return 0;
+}
@@ -0,0 +1,99 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark comparing the vectorized DenseVector reductions with
+ * sequential loops.
+ *
+ * For DynamicVector<double> of several sizes the time per call of dot(),
+ * two_norm2() and infinity_norm() is reported, next to the time of the
+ * corresponding sequential loop over the entries.  Compile with
+ * -DDUNE_DENSEVECTOR_COMPENSATED_SUMMATION=1 to measure the compensated
+ * variants.
+ *
+ * Usage: ./densevectorreduction_benchmark [options]
+ *
+ * options:
+ * -iterations: default: 100000000. Total number of entries processed per
+ *              reduction and size.
+ *
+ * options are passed at the command-line (-key value).
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <dune/common/dynvector.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/timer.hh>
+
+Dune::ParameterTree options;
+
+// avoid that the compiler optimizes away the benchmarked kernels
+volatile double sink = 0;
+
+template<class F>
+void report(int calls, F&& f)
+{
+  sink = sink + f(); // warm up
+  Dune::Timer watch;
+  for (int r = 0; r < calls; ++r)
+    sink = sink + f();
+  std::cout << std::setw(14) << watch.elapsed() / calls;
+}
+
+int main(int argc, char** argv)
+{
+  Dune::ParameterTreeParser::readOptions(argc, argv, options);
+  const double iterations = options.get("iterations", 1e8);
+
+  std::cout << "time per call [s]" << std::endl;
+  std::cout << std::scientific << std::setprecision(3);
+  std::cout << std::setw(10) << "n"
+            << std::setw(14) << "dot loop" << std::setw(14) << "dot"
+            << std::setw(14) << "norm2 loop" << std::setw(14) << "two_norm2"
+            << std::setw(14) << "max loop" << std::setw(14) << "inf_norm"
+            << std::endl;
+
+  for (std::size_t n : {64, 1000, 10000, 100000, 1000000})
+  {
+    Dune::DynamicVector<double> x(n), y(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      x[i] = std::sin(0.1*i);
+      y[i] = std::cos(0.3*i);
+    }
+    const int calls = std::max(1, int(iterations / n));
+
+    std::cout << std::setw(10) << n;
+    report(calls, [&]{
+      double s = 0;
+      for (std::size_t i = 0; i < n; ++i)
+        s += x[i]*y[i];
+      return s;
+    });
+    report(calls, [&]{ return x.dot(y); });
+    report(calls, [&]{
+      double s = 0;
+      for (std::size_t i = 0; i < n; ++i)
+        s += x[i]*x[i];
+      return s;
+    });
+    report(calls, [&]{ return x.two_norm2(); });
+    report(calls, [&]{
+      double m = 0;
+      for (std::size_t i = 0; i < n; ++i)
+        m = std::max(std::abs(x[i]), m);
+      return m;
+    });
+    report(calls, [&]{ return x.infinity_norm(); });
+    std::cout << std::endl;
+  }
+  return 0;
+}
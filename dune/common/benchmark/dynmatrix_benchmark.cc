@@ -0,0 +1,103 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark comparing the row-wise storage of DynamicMatrix with the
+ * contiguous storage of ContiguousDynamicMatrix.
+ *
+ * For each matrix size the time per call of mv(), mtv(), solve() and
+ * rightmultiply() is reported for both matrix types.  Matrices with at least
+ * DenseBlas::threshold() rows use BLAS/LAPACK if available, run with a
+ * huge -threshold to compare with the generic implementation.
+ *
+ * Usage: ./dynmatrix_benchmark [options]
+ *
+ * options:
+ * -iterations: default: 10. Number of calls of solve() for the largest
+ *              size, the number of calls of the other methods and for
+ *              smaller sizes is scaled up accordingly.
+ * -threshold:  default: DUNE_DENSE_BLAS_THRESHOLD. Minimal matrix size for
+ *              which BLAS/LAPACK are used.
+ *
+ * options are passed at the command-line (-key value).
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include <dune/common/contiguousdynmatrix.hh>
+#include <dune/common/denseblas.hh>
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/timer.hh>
+
+Dune::ParameterTree options;
+
+// avoid that the compiler optimizes away the benchmarked kernels
+volatile double sink = 0;
+
+template<class F>
+double timePerCall(int calls, F&& f)
+{
+  Dune::Timer watch;
+  for (int r = 0; r < calls; ++r)
+    f();
+  return watch.elapsed() / calls;
+}
+
+template<class Matrix>
+void run(std::size_t n)
+{
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(-1, 1);
+
+  Matrix A(n, n);
+  Dune::DynamicVector<double> x(n), y(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    x[i] = dist(gen);
+    for (std::size_t j = 0; j < n; ++j)
+      A[i][j] = dist(gen) + (i == j ? n : 0);
+  }
+
+  const int iterations = options.get("iterations", 10);
+  const int solveCalls = iterations * std::max<std::size_t>(1, (500*500*500) / (n*n*n));
+  const int mmCalls = solveCalls;
+  const int mvCalls = iterations * std::max<std::size_t>(1, (500*500*500) / (n*n));
+
+  double mv = timePerCall(mvCalls, [&]{ A.mv(x, y); sink = sink + y[0]; });
+  double mtv = timePerCall(mvCalls, [&]{ A.mtv(x, y); sink = sink + y[0]; });
+  double solve = timePerCall(solveCalls, [&]{ A.solve(y, x); sink = sink + y[0]; });
+  Matrix B = A;
+  double mm = timePerCall(mmCalls, [&]{ B = A; B.rightmultiply(A); sink = sink + B[0][0]; });
+
+  std::cout << std::setw(14) << mv << std::setw(14) << mtv << std::setw(14) << solve
+            << std::setw(14) << mm;
+}
+
+int main(int argc, char** argv)
+{
+  Dune::ParameterTreeParser::readOptions(argc, argv, options);
+  Dune::DenseBlas::threshold() = options.get("threshold", Dune::DenseBlas::threshold());
+
+  std::cout << "time per call [s]" << std::endl;
+  std::cout << std::scientific << std::setprecision(3);
+  std::cout << std::setw(6) << "n"
+            << std::setw(14) << "mv" << std::setw(14) << "mtv" << std::setw(14) << "solve"
+            << std::setw(14) << "mm"
+            << std::setw(14) << "mv_contig" << std::setw(14) << "mtv_contig"
+            << std::setw(14) << "solve_contig" << std::setw(14) << "mm_contig" << std::endl;
+  for (std::size_t n : {50, 100, 200, 500})
+  {
+    std::cout << std::setw(6) << n;
+    run<Dune::DynamicMatrix<double>>(n);
+    run<Dune::ContiguousDynamicMatrix<double>>(n);
+    std::cout << std::endl;
+  }
+  return 0;
+}
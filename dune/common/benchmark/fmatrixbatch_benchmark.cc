@@ -0,0 +1,125 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark comparing the batched FieldMatrix kernels from
+ * fmatrixbatch.hh with a loop calling the DenseMatrix methods for each
+ * matrix separately.
+ *
+ * For each matrix size the time per matrix is reported for
+ * determinant(), solve() and invert(), once for the per-matrix loop and
+ * once for the batched variant.
+ *
+ * Usage: ./fmatrixbatch_benchmark [options]
+ *
+ * options:
+ * -count: default: 100000. Number of matrices in the batch.
+ * -repetitions: default: 10. Number of times each kernel is run.
+ *
+ * options are passed at the command-line (-key value).
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fmatrixbatch.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/timer.hh>
+
+Dune::ParameterTree options;
+
+// avoid that the compiler optimizes away the benchmarked kernels
+volatile double sink = 0;
+
+template<class F>
+double timePerMatrix(std::size_t count, F&& f)
+{
+  int repetitions = options.get("repetitions", 10);
+  Dune::Timer watch;
+  for (int r = 0; r < repetitions; ++r)
+    f();
+  return watch.elapsed() / repetitions / count;
+}
+
+template<int n>
+void run()
+{
+  std::size_t count = options.get("count", 100000);
+
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(-1, 1);
+  std::vector<Dune::FieldMatrix<double,n,n>> matrices(count);
+  std::vector<Dune::FieldVector<double,n>> b(count), x(count);
+  for (std::size_t k = 0; k < count; ++k)
+    for (int i = 0; i < n; ++i)
+    {
+      b[k][i] = dist(gen);
+      for (int j = 0; j < n; ++j)
+        matrices[k][i][j] = dist(gen) + (i == j ? n : 0);
+    }
+  std::vector<double> det(count);
+  auto inverses = matrices;
+
+  double loopDet = timePerMatrix(count, [&]{
+    for (std::size_t k = 0; k < count; ++k)
+      det[k] = matrices[k].determinant();
+    sink = sink + det[0];
+  });
+  double batchDet = timePerMatrix(count, [&]{
+    Dune::batchDeterminant(matrices, det);
+    sink = sink + det[0];
+  });
+
+  double loopSolve = timePerMatrix(count, [&]{
+    for (std::size_t k = 0; k < count; ++k)
+      matrices[k].solve(x[k], b[k]);
+    sink = sink + x[0][0];
+  });
+  double batchSolve = timePerMatrix(count, [&]{
+    Dune::batchSolve(matrices, x, b);
+    sink = sink + x[0][0];
+  });
+
+  double loopInvert = timePerMatrix(count, [&]{
+    for (std::size_t k = 0; k < count; ++k)
+      inverses[k].invert();
+    sink = sink + inverses[0][0][0];
+  });
+  double batchInvert = timePerMatrix(count, [&]{
+    Dune::batchInvert(inverses);
+    sink = sink + inverses[0][0][0];
+  });
+
+  std::cout << std::setw(4) << n
+            << std::setw(14) << loopDet << std::setw(14) << batchDet
+            << std::setw(14) << loopSolve << std::setw(14) << batchSolve
+            << std::setw(14) << loopInvert << std::setw(14) << batchInvert
+            << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  Dune::ParameterTreeParser::readOptions(argc, argv, options);
+
+  std::cout << "time per matrix [s], "
+            << Dune::defaultBatchLanes<double> << " lanes" << std::endl;
+  std::cout << std::scientific << std::setprecision(3);
+  std::cout << std::setw(4) << "n"
+            << std::setw(14) << "det" << std::setw(14) << "det_batch"
+            << std::setw(14) << "solve" << std::setw(14) << "solve_batch"
+            << std::setw(14) << "invert" << std::setw(14) << "invert_batch"
+            << std::endl;
+  run<2>();
+  run<3>();
+  run<4>();
+  run<6>();
+  run<8>();
+  return 0;
+}
@@ -0,0 +1,110 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark for the product of two square FieldMatrix objects.
+ *
+ * For each matrix size the performance in GFLOP/s is reported for a naive
+ * triple loop and for FieldMatrix::operator*, which uses a register-tiled
+ * kernel for matrices of size 8x8 and larger.
+ *
+ * Usage: ./fmatrixproduct_benchmark [options]
+ *
+ * options:
+ * -flops: default: 1e9. Approximate number of floating point operations
+ *         carried out per size and variant.
+ *
+ * options are passed at the command-line (-key value).
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/timer.hh>
+
+Dune::ParameterTree options;
+
+// avoid that the compiler optimizes away the benchmarked kernels
+volatile double sink = 0;
+
+template<class K, int n>
+[[gnu::noinline]] void naiveProduct(const Dune::FieldMatrix<K,n,n>& A,
+                                    const Dune::FieldMatrix<K,n,n>& B,
+                                    Dune::FieldMatrix<K,n,n>& C)
+{
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+    {
+      C[i][j] = 0;
+      for (int k = 0; k < n; ++k)
+        C[i][j] += A[i][k] * B[k][j];
+    }
+}
+
+template<class K, int n>
+[[gnu::noinline]] void fieldMatrixProduct(const Dune::FieldMatrix<K,n,n>& A,
+                                          const Dune::FieldMatrix<K,n,n>& B,
+                                          Dune::FieldMatrix<K,n,n>& C)
+{
+  C = A * B;
+}
+
+template<class F>
+double gflops(double flopsPerCall, F&& f)
+{
+  const long calls = std::max(1L, long(options.get("flops", 1e9) / flopsPerCall));
+  Dune::Timer watch;
+  for (long r = 0; r < calls; ++r)
+    f();
+  return flopsPerCall * calls / watch.elapsed() * 1e-9;
+}
+
+template<class K, int n>
+void run()
+{
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<K> dist(-1, 1);
+  Dune::FieldMatrix<K,n,n> A, B, C;
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+    {
+      A[i][j] = dist(gen);
+      B[i][j] = dist(gen);
+    }
+
+  const double flops = 2.0 * n * n * n;
+  double naive = gflops(flops, [&]{ naiveProduct(A, B, C); sink = sink + C[0][0]; });
+  double tiled = gflops(flops, [&]{ fieldMatrixProduct(A, B, C); sink = sink + C[0][0]; });
+
+  std::cout << std::setw(6) << n << std::setw(12) << naive << std::setw(12) << tiled << std::endl;
+}
+
+template<class K>
+void runAll(const std::string& name)
+{
+  std::cout << "GFLOP/s for " << name << std::endl;
+  std::cout << std::setw(6) << "n" << std::setw(12) << "naive" << std::setw(12) << "operator*" << std::endl;
+  run<K,4>();
+  run<K,8>();
+  run<K,16>();
+  run<K,24>();
+  run<K,32>();
+  run<K,48>();
+  run<K,64>();
+}
+
+int main(int argc, char** argv)
+{
+  Dune::ParameterTreeParser::readOptions(argc, argv, options);
+
+  std::cout << std::fixed << std::setprecision(2);
+  runAll<double>("double");
+  runAll<float>("float");
+  return 0;
+}
@@ -0,0 +1,136 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark comparing the LoopSIMD operators with plain loops over the
+ * lanes.
+ *
+ * For LoopSIMD<float,S> and LoopSIMD<double,S> with S = 2, 4, 8, 16 the time
+ * per lane of an arithmetic expression (x*y + x), of a comparison with
+ * cond() and of max() is reported, next to the time of the same expression
+ * written as loops over the lanes of std::array.  Whether the intrinsics
+ * kernels are used depends on the target flags, e.g. compile with
+ * -march=native to use AVX or AVX-512, and with
+ * -DDUNE_SIMD_LOOP_INTRINSICS=0 to measure the generic LoopSIMD loops.
+ *
+ * Usage: ./loopsimd_benchmark [options]
+ *
+ * options:
+ * -iterations: default: 100000000. Total number of lanes processed per
+ *              expression and type.
+ *
+ * options are passed at the command-line (-key value).
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <dune/common/classname.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/simd/loop.hh>
+#include <dune/common/timer.hh>
+
+Dune::ParameterTree options;
+
+// avoid that the compiler optimizes away the benchmarked kernels
+volatile double sink = 0;
+
+// number of vectors in each operand, small enough to stay in the L1 cache
+constexpr std::size_t m = 256;
+
+template<class F>
+void report(int calls, std::size_t lanes, F&& f)
+{
+  sink = sink + f(); // warm up
+  Dune::Timer watch;
+  for (int r = 0; r < calls; ++r)
+    sink = sink + f();
+  std::cout << std::setw(14) << watch.elapsed() / calls / (m*lanes);
+}
+
+template<class T, std::size_t S>
+void benchmark(double iterations)
+{
+  using V = Dune::LoopSIMD<T,S>;
+  using A = std::array<T,S>;
+  std::vector<V> x(m), y(m), z(m);
+  std::vector<A> xa(m), ya(m), za(m);
+  for (std::size_t i = 0; i < m; ++i)
+    for (std::size_t l = 0; l < S; ++l)
+    {
+      xa[i][l] = x[i][l] = T(std::sin(0.1*(i*S+l)));
+      ya[i][l] = y[i][l] = T(std::cos(0.3*(i*S+l)));
+    }
+  const int calls = std::max(1, int(iterations / (m*S)));
+
+  std::cout << std::setw(28) << Dune::className<V>();
+  report(calls, S, [&]{
+    for (std::size_t i = 0; i < m; ++i)
+      for (std::size_t l = 0; l < S; ++l)
+        za[i][l] = xa[i][l]*ya[i][l] + xa[i][l];
+    return za[m/2][0];
+  });
+  report(calls, S, [&]{
+    for (std::size_t i = 0; i < m; ++i)
+      z[i] = x[i]*y[i] + x[i];
+    return z[m/2][0];
+  });
+  report(calls, S, [&]{
+    for (std::size_t i = 0; i < m; ++i)
+      for (std::size_t l = 0; l < S; ++l)
+        za[i][l] = xa[i][l] < ya[i][l] ? ya[i][l] - xa[i][l] : xa[i][l];
+    return za[m/2][0];
+  });
+  report(calls, S, [&]{
+    for (std::size_t i = 0; i < m; ++i)
+      z[i] = Dune::Simd::cond(x[i] < y[i], y[i] - x[i], x[i]);
+    return z[m/2][0];
+  });
+  report(calls, S, [&]{
+    for (std::size_t i = 0; i < m; ++i)
+      for (std::size_t l = 0; l < S; ++l)
+        za[i][l] = std::max(xa[i][l], ya[i][l]);
+    return za[m/2][0];
+  });
+  report(calls, S, [&]{
+    for (std::size_t i = 0; i < m; ++i)
+      z[i] = max(x[i], y[i]);
+    return z[m/2][0];
+  });
+  std::cout << std::endl;
+}
+
+template<class T>
+void benchmark(double iterations)
+{
+  benchmark<T,2>(iterations);
+  benchmark<T,4>(iterations);
+  benchmark<T,8>(iterations);
+  benchmark<T,16>(iterations);
+}
+
+int main(int argc, char** argv)
+{
+  Dune::ParameterTreeParser::readOptions(argc, argv, options);
+  const double iterations = options.get("iterations", 1e8);
+
+  std::cout << "time per lane [s]" << std::endl;
+  std::cout << std::scientific << std::setprecision(3);
+  std::cout << std::setw(28) << "type"
+            << std::setw(14) << "axpy loop" << std::setw(14) << "axpy"
+            << std::setw(14) << "cond loop" << std::setw(14) << "cond"
+            << std::setw(14) << "max loop" << std::setw(14) << "max"
+            << std::endl;
+
+  benchmark<float>(iterations);
+  benchmark<double>(iterations);
+  return 0;
+}
@@ -0,0 +1,170 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark for the throughput of allocating and freeing single
+ * objects from several threads.
+ *
+ * Each thread repeatedly allocates a batch of objects with an allocator and
+ * frees them again. The time per allocation and deallocation of one object,
+ * i.e. the total time divided by the number of pairs of all threads, is
+ * reported for std::allocator, for PoolAllocator with one allocator per
+ * thread, as the pool of PoolAllocator is not thread-safe, and for
+ * ConcurrentPoolAllocator. In addition, the time is reported for
+ * std::allocator and ConcurrentPoolAllocator when every thread frees the
+ * objects allocated by another thread.
+ *
+ * Usage: ./poolallocator_benchmark [options]
+ *
+ * options:
+ * -iterations: default: 10000000. Number of objects allocated and freed
+ *              by each thread.
+ * -batch: default: 1000. Number of objects allocated before they are freed.
+ * -threads: default: number of hardware threads. Runs the benchmark for
+ *           1, 2, 4, ... threads up to this number.
+ *
+ * options are passed at the command-line (-key value).
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <dune/common/concurrentpoolallocator.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/poolallocator.hh>
+#include <dune/common/timer.hh>
+
+Dune::ParameterTree options;
+
+// the allocated object, roughly the size of a node of SLList<double>
+struct Node
+{
+  double value;
+  Node* next;
+};
+
+// Start the threads together and return the time until all have finished.
+template<class F>
+double measure(int numThreads, F&& f)
+{
+  std::atomic<int> ready(0);
+  std::atomic<bool> go(false);
+  std::vector<std::thread> threads;
+  for(int t = 0; t < numThreads; ++t)
+    threads.emplace_back([&, t](){
+        ++ready;
+        while(!go)
+          std::this_thread::yield();
+        f(t);
+      });
+  while(ready < numThreads)
+    std::this_thread::yield();
+  Dune::Timer watch;
+  go = true;
+  for(auto& t : threads)
+    t.join();
+  return watch.elapsed();
+}
+
+// Every thread allocates and frees with its own allocator.
+template<class Allocator>
+double allocFree(int numThreads)
+{
+  const int iterations = options.get("iterations", 10000000);
+  const int batch = options.get("batch", 1000);
+  double time = measure(numThreads, [&](int){
+      Allocator alloc;
+      std::vector<Node*> nodes(batch);
+      for(int i = 0; i < iterations; i += batch) {
+        for(auto& n : nodes) {
+          n = alloc.allocate(1);
+          n->value = i;
+        }
+        for(auto n : nodes)
+          alloc.deallocate(n, 1);
+      }
+    });
+  return time/iterations/numThreads;
+}
+
+// Every thread frees the objects allocated by its neighbour.
+template<class Allocator>
+double crossFree(int numThreads)
+{
+  const int iterations = options.get("iterations", 10000000);
+  const int batch = options.get("batch", 1000);
+  const int rounds = std::max(iterations / batch, 1);
+  std::vector<std::vector<Node*> > nodes(numThreads, std::vector<Node*>(batch));
+  std::vector<std::atomic<int> > done(numThreads);
+  for(auto& d : done)
+    d = 0;
+
+  double time = measure(numThreads, [&](int t){
+      Allocator alloc;
+      const int other = (t + 1) % numThreads;
+      const int previous = (t + numThreads - 1) % numThreads;
+      for(int r = 0; r < rounds; ++r) {
+        for(auto& n : nodes[t]) {
+          n = alloc.allocate(1);
+          n->value = r;
+        }
+        ++done[t];
+        // wait until the neighbour has finished this round
+        while(done[other] < 2*r + 1)
+          std::this_thread::yield();
+        for(auto n : nodes[other])
+          alloc.deallocate(n, 1);
+        ++done[t];
+        // wait until the previous thread has freed our objects
+        while(done[previous] < 2*r + 2)
+          std::this_thread::yield();
+      }
+    });
+  return time/rounds/batch/numThreads;
+}
+
+void run(int numThreads)
+{
+  typedef std::allocator<Node> Std;
+  typedef Dune::PoolAllocator<Node,1000> Pool;
+  typedef Dune::ConcurrentPoolAllocator<Node,1000> Concurrent;
+
+  std::cout << std::setw(10) << numThreads
+            << std::setw(16) << allocFree<Std>(numThreads)
+            << std::setw(16) << allocFree<Pool>(numThreads)
+            << std::setw(16) << allocFree<Concurrent>(numThreads)
+            << std::setw(16) << crossFree<Std>(numThreads)
+            << std::setw(16) << crossFree<Concurrent>(numThreads)
+            << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  Dune::ParameterTreeParser::readOptions(argc, argv, options);
+
+  std::cout << std::left << std::scientific;
+  std::cout << "time per allocation and deallocation [s]" << std::endl;
+  std::cout << std::setw(10) << "threads"
+            << std::setw(16) << "std"
+            << std::setw(16) << "Pool"
+            << std::setw(16) << "Concurrent"
+            << std::setw(16) << "std cross"
+            << std::setw(16) << "Concurrent cross"
+            << std::endl;
+  const int maxThreads = options.get("threads", int(std::max(std::thread::hardware_concurrency(), 1u)));
+  int s = 1;
+  while(s < maxThreads) {
+    run(s);
+    s *= 2;
+  }
+  run(maxThreads);
+  return 0;
+}
@@ -9,20 +9,84 @@
     \brief Efficient implementation of a dynamic array of static arrays of booleans
  */
 
-#include <vector>
+#include <algorithm>
+#include <bit>
 #include <bitset>
+#include <cstdint>
 #include <iostream>
-#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <vector>
 
 #include <dune/common/boundschecking.hh>
 #include <dune/common/genericiterator.hh>
 #include <dune/common/exceptions.hh>
+#include <dune/common/iteratorrange.hh>
+#include <dune/common/typetraits.hh>
 
 namespace Dune {
 
   template <int block_size, class Alloc> class BitSetVector;
   template <int block_size, class Alloc> class BitSetVectorReference;
 
+  /**
+     \brief A proxy class that acts as a mutable reference to a single
+     bit in a BitSetVector.
+
+     It provides the interface of std::vector<bool>::reference.
+   */
+  class BitSetVectorBitReference
+  {
+  public:
+    //! The type of the words the bits are stored in
+    typedef std::uint64_t Word;
+
+    BitSetVectorBitReference(Word& word, Word mask) :
+      word_(&word),
+      mask_(mask)
+    {}
+
+    BitSetVectorBitReference(const BitSetVectorBitReference&) = default;
+
+    //! Returns the value of the bit
+    operator bool() const
+    {
+      return *word_ & mask_;
+    }
+
+    //! Assignment from bool
+    BitSetVectorBitReference& operator=(bool b)
+    {
+      if(b)
+        *word_ |= mask_;
+      else
+        *word_ &= ~mask_;
+      return *this;
+    }
+
+    //! Assignment of the value of another bit
+    BitSetVectorBitReference& operator=(const BitSetVectorBitReference& b)
+    {
+      return (*this) = bool(b);
+    }
+
+    //! Returns the flipped value of the bit
+    bool operator~() const
+    {
+      return !bool(*this);
+    }
+
+    //! Flips the bit
+    void flip()
+    {
+      *word_ ^= mask_;
+    }
+
+  private:
+    Word* word_;
+    Word mask_;
+  };
+
   /**
      \brief A proxy class that acts as a const reference to a single
      bitset in a BitSetVector.
@@ -56,8 +120,8 @@ namespace Dune {
     typedef std::bitset<block_size> bitset;
 
     // bitset interface typedefs
-    typedef typename std::vector<bool, Alloc>::const_reference reference;
-    typedef typename std::vector<bool, Alloc>::const_reference const_reference;
+    typedef bool reference;
+    typedef bool const_reference;
     typedef size_t size_type;
 
     //! Returns a copy of *this shifted left by n bits.
@@ -94,15 +158,20 @@ namespace Dune {
     size_type count() const
     {
       size_type n = 0;
-      for(size_type i=0; i<block_size; ++i)
-        n += getBit(i);
+      blockBitField.forEachChunk(block_number, [&](auto bits, int){
+          n += std::popcount(bits);
+        });
       return n;
     }
 
     //! Returns true if any bits are set.
     bool any() const
     {
-      return count();
+      bool any = false;
+      blockBitField.forEachChunk(block_number, [&](auto bits, int){
+          any |= (bits != 0);
+        });
+      return any;
     }
 
     //! Returns true if no bits are set.
@@ -114,10 +183,11 @@ namespace Dune {
     //! Returns true if all bits are set
     bool all() const
     {
-      for(size_type i=0; i<block_size; ++i)
-        if(not test(i))
-          return false;
-      return true;
+      bool all = true;
+      blockBitField.forEachChunk(block_number, [&](auto bits, int n){
+          all &= (bits == BitSetVector::lowMask(n));
+        });
+      return all;
     }
 
     //! Returns true if bit n is set.
@@ -189,10 +259,7 @@ namespace Dune {
     template<class BS>
     bool equals(const BS & bs) const
     {
-      bool eq = true;
-      for(int i=0; i<block_size; ++i)
-        eq &= (getBit(i) == bs[i]);
-      return eq;
+      return bitset(*this) == bitset(bs);
     }
 
   private:
@@ -238,9 +305,9 @@ namespace Dune {
     //! bitset interface typedefs
     //! \{
     //! A proxy class that acts as a reference to a single bit.
-    typedef typename std::vector<bool, Alloc>::reference reference;
-    //! A proxy class that acts as a const reference to a single bit.
-    typedef typename std::vector<bool, Alloc>::const_reference const_reference;
+    typedef BitSetVectorBitReference reference;
+    //! The value of a single bit.
+    typedef bool const_reference;
     //! \}
 
     //! size_type typedef (an unsigned integral type)
@@ -249,33 +316,27 @@ namespace Dune {
     //! Assignment from bool, sets each bit in the bitset to b
     BitSetVectorReference& operator=(bool b)
     {
-      for(int i=0; i<block_size; ++i)
-        getBit(i) = b;
+      blockBitField.setBlock(this->block_number, b);
       return (*this);
     }
 
     //! Assignment from bitset
     BitSetVectorReference& operator=(const bitset & b)
     {
-      for(int i=0; i<block_size; ++i)
-        getBit(i) = b.test(i);
+      blockBitField.setRepr(this->block_number, b);
       return (*this);
     }
 
     //! Assignment from BitSetVectorConstReference
     BitSetVectorReference& operator=(const BitSetVectorConstReference & b)
     {
-      for(int i=0; i<block_size; ++i)
-        getBit(i) = b.test(i);
-      return (*this);
+      return (*this) = bitset(b);
     }
 
     //! Assignment from BitSetVectorReference
     BitSetVectorReference& operator=(const BitSetVectorReference & b)
     {
-      for(int i=0; i<block_size; ++i)
-        getBit(i) = b.test(i);
-      return (*this);
+      return (*this) = bitset(b);
     }
 
     //! Bitwise and (for bitset).
@@ -329,17 +390,13 @@ namespace Dune {
     //! Sets every bit.
     BitSetVectorReference& set()
     {
-      for (size_type i=0; i<block_size; i++)
-        set(i);
-      return *this;
+      return (*this) = true;
     }
 
     //! Flips the value of every bit.
     BitSetVectorReference& flip()
     {
-      for (size_type i=0; i<block_size; i++)
-        flip(i);
-      return *this;
+      return (*this) = ~bitset(*this);
     }
 
     //! Clears every bit.
@@ -417,15 +474,83 @@ namespace Dune {
     typedef BitSetVectorReference<block_size,Alloc> type;
   };
 
+  /**
+     \brief Iterator over the blocks of a BitSetVector with at least one bit set
+
+     Words without set bits are skipped. Besides dereferencing to the
+     block, the iterator provides the index of the block by index(), such
+     that it can be used with sparseRange().
+
+     \tparam BSV The BitSetVector, const for a constant iterator.
+   */
+  template <class BSV>
+  class BitSetVectorSetBlockIterator :
+    public ForwardIteratorFacade<BitSetVectorSetBlockIterator<BSV>,
+                                 typename BSV::value_type,
+                                 std::conditional_t<std::is_const_v<BSV>,
+                                                    typename BSV::const_reference,
+                                                    typename BSV::reference>,
+                                 std::ptrdiff_t>
+  {
+  public:
+    //! The reference to a block
+    typedef std::conditional_t<std::is_const_v<BSV>,
+                               typename BSV::const_reference,
+                               typename BSV::reference> Reference;
+
+    BitSetVectorSetBlockIterator() = default;
+
+    //! Iterator to the first block at or after block i with a set bit
+    BitSetVectorSetBlockIterator(BSV& vector, std::size_t i) :
+      vector_(&vector),
+      block_(vector.nextSetBlock(i))
+    {}
+
+    Reference dereference() const
+    {
+      return (*vector_)[block_];
+    }
+
+    bool equals(const BitSetVectorSetBlockIterator& other) const
+    {
+      return block_ == other.block_;
+    }
+
+    void increment()
+    {
+      block_ = vector_->nextSetBlock(block_+1);
+    }
+
+    //! The index of the current block
+    std::size_t index() const
+    {
+      return block_;
+    }
+
+  private:
+    BSV* vector_ = nullptr;
+    std::size_t block_ = 0;
+  };
+
   /**
      \brief A dynamic %array of blocks of booleans
+
+     The bits are stored contiguously in 64-bit words, such that counting,
+     logical operations and the search for set bits process whole words.
+     The unused bits of the last word are always zero.
    */
   template <int block_size, class Allocator=std::allocator<bool> >
-  class BitSetVector : private std::vector<bool, Allocator>
+  class BitSetVector
   {
-    /** \brief The implementation class: an unblocked bitfield */
+    /** \brief The type of an unblocked bitfield */
     typedef std::vector<bool, Allocator> BlocklessBaseClass;
 
+    /** \brief The type of the words the bits are stored in */
+    typedef BitSetVectorBitReference::Word Word;
+
+    /** \brief The allocator of the words */
+    using WordAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Word>;
+
   public:
     //! container interface typedefs
     //! \{
@@ -446,7 +571,7 @@ namespace Dune {
     typedef BitSetVectorConstReference<block_size,Allocator>* const_pointer;
 
     /** \brief size type */
-    typedef typename std::vector<bool, Allocator>::size_type size_type;
+    typedef typename std::vector<Word, WordAllocator>::size_type size_type;
 
     /** \brief The type of the allocator */
     typedef Allocator allocator_type;
@@ -478,57 +603,98 @@ namespace Dune {
       return const_iterator(*this, size());
     }
 
+    //! iterators over the blocks with at least one bit set
+    //! \{
+    typedef BitSetVectorSetBlockIterator<BitSetVector<block_size,Allocator> > SetBlockIterator;
+    typedef BitSetVectorSetBlockIterator<const BitSetVector<block_size,Allocator> > ConstSetBlockIterator;
+    //! \}
+
+    /** \brief Range of the blocks with at least one bit set
+     *
+     * The indices of the blocks are available with sparseRange():
+     * \code
+     * for(auto&& [block, i] : sparseRange(mask.setBlocks()))
+     *   doSomethingWithBlockAndIndex(block, i);
+     * \endcode
+     */
+    IteratorRange<SetBlockIterator> setBlocks()
+    {
+      return {SetBlockIterator(*this, 0), SetBlockIterator(*this, size())};
+    }
+
+    //! Range of the blocks with at least one bit set
+    IteratorRange<ConstSetBlockIterator> setBlocks() const
+    {
+      return {ConstSetBlockIterator(*this, 0), ConstSetBlockIterator(*this, size())};
+    }
+
     //! Default constructor
     BitSetVector() :
-      BlocklessBaseClass()
+      bits_(0)
     {}
 
     //! Construction from an unblocked bitfield
     BitSetVector(const BlocklessBaseClass& blocklessBitField) :
-      BlocklessBaseClass(blocklessBitField)
+      bits_(0)
     {
       if (blocklessBitField.size()%block_size != 0)
         DUNE_THROW(RangeError, "Vector size is not a multiple of the block size!");
+      resize(blocklessBitField.size()/block_size);
+      for(size_type i=0; i<bits_; ++i)
+        if(blocklessBitField[i])
+          words_[i/wordSize] |= Word(1) << (i%wordSize);
     }
 
     /** Constructor with a given length
         \param n Number of blocks
      */
     explicit BitSetVector(int n) :
-      BlocklessBaseClass(n*block_size)
-    {}
+      bits_(0)
+    {
+      resize(n);
+    }
 
     //! Constructor which initializes the field with true or false
     BitSetVector(int n, bool v) :
-      BlocklessBaseClass(n*block_size,v)
-    {}
+      bits_(0)
+    {
+      resize(n, v);
+    }
 
     //! Erases all of the elements.
     void clear()
     {
-      BlocklessBaseClass::clear();
+      words_.clear();
+      bits_ = 0;
     }
 
     //! Resize field
     void resize(int n, bool v = bool())
     {
-      BlocklessBaseClass::resize(n*block_size, v);
+      size_type bits = n*block_size;
+      // the unused bits of the last word become the first new bits
+      if(v && bits > bits_ && bits_%wordSize != 0)
+        words_.back() |= ~lowMask(bits_%wordSize);
+      words_.resize((bits + wordSize - 1)/wordSize, v ? ~Word(0) : Word(0));
+      bits_ = bits;
+      clearUnusedBits();
     }
 
     /** \brief Return the number of blocks */
     size_type size() const
     {
-      return BlocklessBaseClass::size()/block_size;
+      return bits_/block_size;
     }
 
     //! Sets all entries to <tt> true </tt>
     void setAll() {
-      this->assign(BlocklessBaseClass::size(), true);
+      std::fill(words_.begin(), words_.end(), ~Word(0));
+      clearUnusedBits();
     }
 
     //! Sets all entries to <tt> false </tt>
     void unsetAll() {
-      this->assign(BlocklessBaseClass::size(), false);
+      std::fill(words_.begin(), words_.end(), Word(0));
     }
 
     /** \brief Return reference to i-th block */
@@ -558,7 +724,10 @@ namespace Dune {
     //! Returns the number of bits that are set.
     size_type count() const
     {
-      return std::count(BlocklessBaseClass::begin(), BlocklessBaseClass::end(), true);
+      size_type n = 0;
+      for(Word word : words_)
+        n += std::popcount(word);
+      return n;
     }
 
     //! Returns the number of set bits, while each block is masked with 1<<i
@@ -571,6 +740,102 @@ namespace Dune {
       return n;
     }
 
+    //! Returns true if any bit is set.
+    bool any() const
+    {
+      return std::any_of(words_.begin(), words_.end(), [](Word word){ return word != 0; });
+    }
+
+    //! Returns true if no bit is set.
+    bool none() const
+    {
+      return ! any();
+    }
+
+    //! Returns true if all bits are set.
+    bool all() const
+    {
+      size_type full = bits_/wordSize;
+      for(size_type w=0; w<full; ++w)
+        if(words_[w] != ~Word(0))
+          return false;
+      return bits_%wordSize == 0 || words_[full] == lowMask(bits_%wordSize);
+    }
+
+    //! Bitwise and with a vector of the same size
+    BitSetVector& operator&=(const BitSetVector& x)
+    {
+      DUNE_ASSERT_BOUNDS(x.bits_ == bits_);
+      for(size_type w=0; w<words_.size(); ++w)
+        words_[w] &= x.words_[w];
+      return *this;
+    }
+
+    //! Bitwise inclusive or with a vector of the same size
+    BitSetVector& operator|=(const BitSetVector& x)
+    {
+      DUNE_ASSERT_BOUNDS(x.bits_ == bits_);
+      for(size_type w=0; w<words_.size(); ++w)
+        words_[w] |= x.words_[w];
+      return *this;
+    }
+
+    //! Bitwise exclusive or with a vector of the same size
+    BitSetVector& operator^=(const BitSetVector& x)
+    {
+      DUNE_ASSERT_BOUNDS(x.bits_ == bits_);
+      for(size_type w=0; w<words_.size(); ++w)
+        words_[w] ^= x.words_[w];
+      return *this;
+    }
+
+    /** \brief Call f(i,j) for every set bit j of every block i
+     *
+     * The blocks are visited in ascending order. Words without set bits
+     * are skipped.
+     */
+    template<class F>
+    void forEachSetBit(F&& f) const
+    {
+      for(size_type w=0; w<words_.size(); ++w)
+        for(Word word = words_[w]; word != 0; word &= word - 1) {
+          size_type bit = w*wordSize + std::countr_zero(word);
+          f(bit/block_size, bit%block_size);
+        }
+    }
+
+    /** \brief Copy the entries of x at the set bits to out
+     *
+     * x is either a vector of blocks, accessed by x[i][j], or a flat vector
+     * of numbers, accessed by x[i*block_size+j]. The entries are written in
+     * the order of the bits.
+     *
+     * \returns The output iterator past the last written entry.
+     */
+    template<class V, class OutputIterator>
+    OutputIterator gather(const V& x, OutputIterator out) const
+    {
+      forEachSetBit([&](size_type i, size_type j){
+          *out++ = entry(x, i, j);
+        });
+      return out;
+    }
+
+    /** \brief Copy consecutive values from in to the entries of x at the set bits
+     *
+     * This is the inverse of gather(), x is accessed in the same way.
+     *
+     * \returns The input iterator past the last read value.
+     */
+    template<class InputIterator, class V>
+    InputIterator scatter(InputIterator in, V& x) const
+    {
+      forEachSetBit([&](size_type i, size_type j){
+          entry(x, i, j) = *in++;
+        });
+      return in;
+    }
+
     //! Send bitfield to an output stream
     friend std::ostream& operator<< (std::ostream& s, const BitSetVector& v)
     {
@@ -581,29 +846,137 @@ namespace Dune {
 
   private:
 
+    //! The number of bits in a word
+    static constexpr int wordSize = 64;
+
+    //! A word with the lowest n bits set, for 0 < n <= wordSize
+    static constexpr Word lowMask(int n)
+    {
+      return (n == wordSize) ? ~Word(0) : (Word(1) << n) - 1;
+    }
+
+    //! Return the first block at or after block i with a set bit, or size()
+    size_type nextSetBlock(size_type i) const
+    {
+      size_type bit = i*block_size;
+      if(bit >= bits_)
+        return size();
+      size_type w = bit/wordSize;
+      Word word = words_[w] & (~Word(0) << (bit%wordSize));
+      while(word == 0) {
+        if(++w == words_.size())
+          return size();
+        word = words_[w];
+      }
+      return (w*wordSize + std::countr_zero(word))/block_size;
+    }
+
+    //! Access bit j of block i in a blocked or flat vector
+    template<class V>
+    static decltype(auto) entry(V& x, size_type i, size_type j)
+    {
+      if constexpr (IsNumber<std::decay_t<decltype(x[i])> >::value)
+        return x[i*block_size+j];
+      else
+        return x[i][j];
+    }
+
+    //! Clear the bits of the last word that are not part of the vector
+    void clearUnusedBits()
+    {
+      if(bits_%wordSize != 0)
+        words_.back() &= lowMask(bits_%wordSize);
+    }
+
+    //! Get the n <= wordSize bits starting at bit pos
+    Word getBits(size_type pos, int n) const
+    {
+      size_type w = pos/wordSize;
+      int offset = pos%wordSize;
+      Word bits = words_[w] >> offset;
+      if(offset + n > wordSize)
+        bits |= words_[w+1] << (wordSize - offset);
+      return bits & lowMask(n);
+    }
+
+    //! Set the n <= wordSize bits starting at bit pos
+    void setBits(size_type pos, int n, Word bits)
+    {
+      size_type w = pos/wordSize;
+      int offset = pos%wordSize;
+      Word mask = lowMask(n);
+      bits &= mask;
+      words_[w] = (words_[w] & ~(mask << offset)) | (bits << offset);
+      if(offset + n > wordSize) {
+        int shift = wordSize - offset;
+        words_[w+1] = (words_[w+1] & ~(mask >> shift)) | (bits >> shift);
+      }
+    }
+
+    //! Call f(bits, n) for the consecutive chunks of n <= wordSize bits of block i
+    template<class F>
+    void forEachChunk(size_type i, F&& f) const
+    {
+      for(int offset=0; offset<block_size; offset+=wordSize) {
+        int n = std::min(wordSize, block_size - offset);
+        f(getBits(i*block_size + offset, n), n);
+      }
+    }
+
     //! Get a representation as value_type
     value_type getRepr(int i) const
     {
-      value_type bits;
-      for(int j=0; j<block_size; ++j)
-        bits.set(j, getBit(i,j));
-      return bits;
+      if constexpr (block_size <= wordSize)
+        return value_type(getBits(i*block_size, block_size));
+      else {
+        value_type bits;
+        for(int offset=0; offset<block_size; offset+=wordSize)
+          bits |= value_type(getBits(i*block_size + offset, std::min(wordSize, block_size - offset))) << offset;
+        return bits;
+      }
     }
 
-    typename std::vector<bool>::reference getBit(size_type i, size_type j) {
+    //! Set block i from a value_type
+    void setRepr(int i, const value_type& bits)
+    {
+      if constexpr (block_size <= wordSize)
+        setBits(i*block_size, block_size, bits.to_ullong());
+      else
+        for(int offset=0; offset<block_size; offset+=wordSize)
+          setBits(i*block_size + offset, std::min(wordSize, block_size - offset),
+                  ((bits >> offset) & value_type(~Word(0))).to_ullong());
+    }
+
+    //! Set all bits of block i to v
+    void setBlock(int i, bool v)
+    {
+      for(int offset=0; offset<block_size; offset+=wordSize)
+        setBits(i*block_size + offset, std::min(wordSize, block_size - offset), v ? ~Word(0) : Word(0));
+    }
+
+    BitSetVectorBitReference getBit(size_type i, size_type j) {
       DUNE_ASSERT_BOUNDS(j < block_size);
       DUNE_ASSERT_BOUNDS(i < size());
-      return BlocklessBaseClass::operator[](i*block_size+j);
+      size_type bit = i*block_size+j;
+      return BitSetVectorBitReference(words_[bit/wordSize], Word(1) << (bit%wordSize));
     }
 
-    typename std::vector<bool>::const_reference getBit(size_type i, size_type j) const {
+    bool getBit(size_type i, size_type j) const {
       DUNE_ASSERT_BOUNDS(j < block_size);
       DUNE_ASSERT_BOUNDS(i < size());
-      return BlocklessBaseClass::operator[](i*block_size+j);
+      size_type bit = i*block_size+j;
+      return words_[bit/wordSize] & (Word(1) << (bit%wordSize));
     }
 
+    //! The words storing the bits
+    std::vector<Word, WordAllocator> words_;
+
+    //! The number of bits
+    size_type bits_;
+
     friend class BitSetVectorReference<block_size,Allocator>;
     friend class BitSetVectorConstReference<block_size,Allocator>;
+    template <class BSV> friend class BitSetVectorSetBlockIterator;
   };
 
 }  // namespace Dune
@@ -0,0 +1,471 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_CONCURRENTPOOLALLOCATOR_HH
+#define DUNE_COMMON_CONCURRENTPOOLALLOCATOR_HH
+
+/** \file
+ * \brief A thread-safe stl-compliant pool allocator with per-thread caches
+ */
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include <dune/common/poolallocator.hh>
+
+namespace Dune
+{
+  /**
+   * @addtogroup Allocators
+   *
+   * @{
+   */
+
+  /**
+   * @brief A thread-safe memory pool of objects.
+   *
+   * The memory is organized in chunks like in Pool, and there is
+   * exactly one pool per type and chunk size in the program. Each thread
+   * allocates from and frees to its own cache of free objects without
+   * any synchronization. If the cache of a thread runs empty, it is
+   * refilled with batches of free objects from a global list, and if it
+   * holds too many free objects, a batch is returned to that list. The
+   * global list of batches and the list of chunks are lock-free stacks.
+   * Objects may be freed by a different thread than the one that allocated
+   * them.
+   *
+   * The chunks are released when the program ends.
+   *
+   * \tparam T The type that is allocated by us.
+   * \tparam s The size of a memory chunk in bytes.
+   */
+  template<class T, std::size_t s>
+  class ConcurrentPool
+  {
+  private:
+    /** @brief Reference to next free element. */
+    struct Reference
+    {
+      Reference *next_;
+    };
+
+  public:
+    /** @brief The type of object we allocate memory for. */
+    typedef T MemberType;
+
+    /** @brief The alignment that suits both the MemberType and a Reference. */
+    constexpr static int alignment = Pool<T,s>::alignment;
+
+    /** @brief The aligned size of the type. */
+    constexpr static int alignedSize = Pool<T,s>::alignedSize;
+
+    /** @brief The size of each memory chunk. */
+    constexpr static int chunkSize = Pool<T,s>::chunkSize;
+
+    /** @brief The number of elements each chunk can hold. */
+    constexpr static int elements = Pool<T,s>::elements;
+
+    /**
+     * @brief The number of free elements exchanged with the global list at once.
+     *
+     * A thread caches up to twice as many free elements.
+     */
+    constexpr static int batchSize = (elements < 64) ? 64 : elements;
+
+    /** @brief Get the pool of the program. */
+    static ConcurrentPool& instance();
+
+    /** @brief Destructor. */
+    inline ~ConcurrentPool();
+
+    /**
+     * @brief Get a new or recycled object
+     * @return A pointer to the object memory.
+     */
+    inline void* allocate();
+
+    /**
+     * @brief Free an object.
+     * @param o The pointer to memory block of the object.
+     */
+    inline void free(void* o);
+
+  private:
+    /** @brief Chunk of memory managed by the pool. */
+    struct Chunk
+    {
+      /** @brief The memory we hold. */
+      alignas(alignment) char chunk_[chunkSize];
+
+      /** @brief The next chunk */
+      Chunk *next_;
+    };
+
+    /** @brief A list of free elements exchanged between the threads. */
+    struct Batch
+    {
+      /** @brief The first free element. */
+      Reference *head_;
+      /** @brief The number of free elements. */
+      std::size_t count_;
+      /** @brief The next batch */
+      Batch *next_;
+    };
+
+    /** @brief The free elements cached by a thread. */
+    struct Cache
+    {
+      /** @brief Return the cached elements to the global list. */
+      ~Cache();
+
+      /** @brief The first free element. */
+      Reference *head_ = nullptr;
+      /** @brief The number of free elements. */
+      std::size_t count_ = 0;
+    };
+
+    ConcurrentPool() = default;
+    ConcurrentPool(const ConcurrentPool&) = delete;
+    ConcurrentPool& operator=(const ConcurrentPool&) = delete;
+
+    /** @brief Get the cache of the calling thread. */
+    static Cache& cache();
+
+    /** @brief Refill the empty cache from the global list or a new chunk. */
+    inline void refill(Cache& cache);
+
+    /** @brief Allocate a new chunk and put its elements into the cache. */
+    inline void grow(Cache& cache);
+
+    /** @brief Push a list of batches to the global list. */
+    inline void push(Batch* first);
+
+    /** @brief The free batches. */
+    std::atomic<Batch*> batches_ = nullptr;
+    /** @brief Our memory chunks. */
+    std::atomic<Chunk*> chunks_ = nullptr;
+  };
+
+  /**
+   * @brief A thread-safe allocator managing a pool of objects for reuse.
+   *
+   * Like PoolAllocator, but all allocators of the same type share one
+   * ConcurrentPool that can be used by many threads at once, each of them
+   * using its own cache of free objects. Thus the allocator is stateless
+   * and all instances compare equal, i.e. memory allocated by one of them
+   * can be freed by any other, in any thread.
+   *
+   * Single objects are allocated from the pool. Arrays of objects, as
+   * requested e.g. by std::vector, are allocated by std::allocator,
+   * such that the allocator can be used for all standard containers as
+   * well as for SLList and ArrayList.
+   *
+   * \tparam T The type that will be allocated.
+   * \tparam s The number of elements to fit into one memory chunk.
+   */
+  template<class T, std::size_t s>
+  class ConcurrentPoolAllocator
+  {
+  public:
+    /**
+     * @brief Type of the values we construct and allocate.
+     */
+    typedef T value_type;
+
+    /**
+     * @brief The size of a memory chunk in bytes.
+     */
+    constexpr static int size = s * sizeof(value_type);
+
+    /**
+     * @brief The pointer type.
+     */
+    typedef T* pointer;
+
+    /**
+     * @brief The constant pointer type.
+     */
+    typedef const T* const_pointer;
+
+    /**
+     * @brief The reference type.
+     */
+    typedef T& reference;
+
+    /**
+     * @brief The constant reference type.
+     */
+    typedef const T& const_reference;
+
+    /**
+     * @brief The size type.
+     */
+    typedef std::size_t size_type;
+
+    /**
+     * @brief The difference_type.
+     */
+    typedef std::ptrdiff_t difference_type;
+
+    /**
+     * @brief All instances are equal.
+     */
+    typedef std::true_type is_always_equal;
+
+    /** @brief The type of the memory pool we use. */
+    typedef ConcurrentPool<T,size> PoolType;
+
+    /**
+     * @brief Constructor.
+     */
+    ConcurrentPoolAllocator() = default;
+
+    /**
+     * @brief Converting constructor.
+     */
+    template<typename U, std::size_t u>
+    ConcurrentPoolAllocator(const ConcurrentPoolAllocator<U,u>&)
+    {}
+
+    /**
+     * @brief Allocates objects.
+     * @param n The number of objects to allocate.
+     * @param hint Ignored hint.
+     * @return A pointer tp the allocated elements.
+     */
+    inline pointer allocate(std::size_t n, const_pointer hint=0);
+
+    /**
+     * @brief Free objects.
+     *
+     * Does not call the destructor!
+     * @param n The number of objects to free.
+     * @param p Pointer to the first object.
+     */
+    inline void deallocate(pointer p, std::size_t n);
+
+    /**
+     * @brief Construct an object.
+     * @param p Pointer to the object.
+     * @param value The value to initialize it to.
+     */
+    inline void construct(pointer p, const_reference value);
+
+    /**
+     * @brief Destroy an object without freeing memory.
+     * @param p Pointer to the object.
+     */
+    inline void destroy(pointer p);
+
+    /**
+     * @brief Convert a reference to a pointer.
+     */
+    inline pointer  address(reference x) const { return &x; }
+
+    /**
+     * @brief Convert a reference to a pointer.
+     */
+    inline const_pointer address(const_reference x) const { return &x; }
+
+    /**
+     * @brief The maximum number of objects that can be allocated at once.
+     */
+    inline size_type max_size() const noexcept { return std::numeric_limits<size_type>::max() / sizeof(T); }
+
+    /**
+     * @brief Rebind the allocator to another type.
+     */
+    template<class U>
+    struct rebind
+    {
+      typedef ConcurrentPoolAllocator<U,s> other;
+    };
+  };
+
+  template<typename T1, std::size_t t1, typename T2, std::size_t t2>
+  bool operator==(const ConcurrentPoolAllocator<T1,t1>&, const ConcurrentPoolAllocator<T2,t2>&)
+  {
+    return true;
+  }
+
+  template<typename T1, std::size_t t1, typename T2, std::size_t t2>
+  bool operator!=(const ConcurrentPoolAllocator<T1,t1>&, const ConcurrentPoolAllocator<T2,t2>&)
+  {
+    return false;
+  }
+
+  template<class T, std::size_t S>
+  ConcurrentPool<T,S>& ConcurrentPool<T,S>::instance()
+  {
+    static ConcurrentPool pool;
+    return pool;
+  }
+
+  template<class T, std::size_t S>
+  typename ConcurrentPool<T,S>::Cache& ConcurrentPool<T,S>::cache()
+  {
+    thread_local Cache cache;
+    return cache;
+  }
+
+  template<class T, std::size_t S>
+  ConcurrentPool<T,S>::Cache::~Cache()
+  {
+    if(head_)
+      instance().push(new Batch{head_, count_, nullptr});
+  }
+
+  template<class T, std::size_t S>
+  inline ConcurrentPool<T,S>::~ConcurrentPool()
+  {
+    Batch *batch = batches_.load(std::memory_order_acquire);
+    while(batch) {
+      Batch *tmp = batch;
+      batch = batch->next_;
+      delete tmp;
+    }
+
+    // delete the allocated chunks.
+    Chunk *current = chunks_.load(std::memory_order_acquire);
+    while(current) {
+      Chunk *tmp = current;
+      current = current->next_;
+      delete tmp;
+    }
+  }
+
+  template<class T, std::size_t S>
+  inline void ConcurrentPool<T,S>::push(Batch* first)
+  {
+    Batch *last = first;
+    while(last->next_)
+      last = last->next_;
+
+    Batch *head = batches_.load(std::memory_order_relaxed);
+    do
+      last->next_ = head;
+    while(!batches_.compare_exchange_weak(head, first, std::memory_order_release,
+                                          std::memory_order_relaxed));
+  }
+
+  template<class T, std::size_t S>
+  inline void ConcurrentPool<T,S>::grow(Cache& cache)
+  {
+    Chunk *newChunk = new Chunk;
+    newChunk->next_ = chunks_.load(std::memory_order_relaxed);
+    while(!chunks_.compare_exchange_weak(newChunk->next_, newChunk, std::memory_order_release,
+                                         std::memory_order_relaxed))
+      ;
+
+    char* start = newChunk->chunk_;
+    char* last  = &start[elements*alignedSize];
+    Reference* ref = new (start) (Reference);
+    cache.head_ = ref;
+
+    for(char* element=start+alignedSize; element<last; element=element+alignedSize) {
+      Reference* next = new (element) (Reference);
+      ref->next_ = next;
+      ref = next;
+    }
+    ref->next_ = nullptr;
+    cache.count_ = elements;
+  }
+
+  template<class T, std::size_t S>
+  inline void ConcurrentPool<T,S>::refill(Cache& cache)
+  {
+    // Taking all batches at once avoids the ABA problem of popping a
+    // single one. All but the first are pushed back.
+    Batch *batch = batches_.exchange(nullptr, std::memory_order_acquire);
+    if(!batch) {
+      grow(cache);
+      return;
+    }
+    cache.head_ = batch->head_;
+    cache.count_ = batch->count_;
+    if(batch->next_)
+      push(batch->next_);
+    delete batch;
+  }
+
+  template<class T, std::size_t S>
+  inline void* ConcurrentPool<T,S>::allocate()
+  {
+    Cache& c = cache();
+    if(!c.head_)
+      refill(c);
+
+    Reference* p = c.head_;
+    c.head_ = p->next_;
+    --c.count_;
+    return p;
+  }
+
+  template<class T, std::size_t S>
+  inline void ConcurrentPool<T,S>::free(void* b)
+  {
+    if(!b) {
+      std::cerr<< "Tried to free null pointer! "<<b<<std::endl;
+      throw std::bad_alloc();
+    }
+
+    Cache& c = cache();
+    Reference* freed = static_cast<Reference*>(b);
+    freed->next_ = c.head_;
+    c.head_ = freed;
+    ++c.count_;
+
+    if(c.count_ >= 2*batchSize) {
+      // Return the most recently freed elements to the global list
+      Reference* last = c.head_;
+      for(int i = 1; i < batchSize; ++i)
+        last = last->next_;
+      Batch* batch = new Batch{c.head_, batchSize, nullptr};
+      c.head_ = last->next_;
+      c.count_ -= batchSize;
+      last->next_ = nullptr;
+      push(batch);
+    }
+  }
+
+  template<class T, std::size_t s>
+  inline typename ConcurrentPoolAllocator<T,s>::pointer
+  ConcurrentPoolAllocator<T,s>::allocate(std::size_t n, const_pointer)
+  {
+    if(n==1)
+      return static_cast<T*>(PoolType::instance().allocate());
+    else
+      return std::allocator<T>().allocate(n);
+  }
+
+  template<class T, std::size_t s>
+  inline void ConcurrentPoolAllocator<T,s>::deallocate(pointer p, std::size_t n)
+  {
+    if(n==1)
+      PoolType::instance().free(p);
+    else
+      std::allocator<T>().deallocate(p, n);
+  }
+
+  template<class T, std::size_t s>
+  inline void ConcurrentPoolAllocator<T,s>::construct(pointer p, const_reference value)
+  {
+    ::new (static_cast<void*>(p))T(value);
+  }
+
+  template<class T, std::size_t s>
+  inline void ConcurrentPoolAllocator<T,s>::destroy(pointer p)
+  {
+    p->~T();
+  }
+
+  /** @} */
+}
+#endif
@@ -0,0 +1,548 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_CONTIGUOUSDYNMATRIX_HH
+#define DUNE_COMMON_CONTIGUOUSDYNMATRIX_HH
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/boundschecking.hh>
+#include <dune/common/denseblas.hh>
+#include <dune/common/densematrix.hh>
+#include <dune/common/densevector.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/common/ftraits.hh>
+#include <dune/common/scalarvectorview.hh>
+#include <dune/common/typetraits.hh>
+
+namespace Dune
+{
+
+  /**
+      @addtogroup DenseMatVec
+      @{
+   */
+
+  /*! \file
+   *  \brief A dense matrix with dynamic size whose entries are stored in a
+   *         single contiguous row-major buffer.
+   */
+
+  template< class K > class ContiguousDynamicMatrix;
+
+  namespace Impl {
+
+    /** \brief A row of a ContiguousDynamicMatrix
+     *
+     * This stores a pointer to the first entry of the row and its length, and
+     * provides the DenseVector interface on this memory.  Copying a row view
+     * is shallow, assigning to it and swapping copies the entries.
+     */
+    template<class K>
+    class ContiguousRowView :
+      public DenseVector<ContiguousRowView<K>>
+    {
+      K* dataP_;
+      std::size_t size_;
+      using Base = DenseVector<ContiguousRowView<K>>;
+
+      template <class>
+      friend class ContiguousRowView;
+    public:
+
+      /** \brief The type used for array indices and sizes */
+      using size_type = typename Base::size_type;
+
+      //===== construction
+
+      /** \brief Default constructor, creates an empty view */
+      constexpr ContiguousRowView ()
+        : dataP_(nullptr), size_(0)
+      {}
+
+      /** \brief Construct from a pointer to the first entry and the length */
+      ContiguousRowView (K* p, size_type size) :
+        dataP_(p), size_(size)
+      {}
+
+      //! Copy constructor, the view refers to the same row as \p other
+      ContiguousRowView (const ContiguousRowView &other) :
+        Base(),
+        dataP_(other.dataP_), size_(other.size_)
+      {}
+
+      //! Copy assignment operator, copies the entries
+      ContiguousRowView& operator= (const ContiguousRowView& other)
+      {
+        DUNE_ASSERT_BOUNDS(other.size() == size());
+        std::copy_n(other.dataP_, size_, dataP_);
+        return *this;
+      }
+
+      using Base::operator=;
+
+      /** \brief Number of entries in the row */
+      size_type size () const
+      {
+        return size_;
+      }
+
+      /** \brief Random access operator */
+      K& operator[] (size_type i)
+      {
+        DUNE_ASSERT_BOUNDS(i < size_);
+        return dataP_[i];
+      }
+
+      /** \brief Const random access operator */
+      const K& operator[] (size_type i) const
+      {
+        DUNE_ASSERT_BOUNDS(i < size_);
+        return dataP_[i];
+      }
+
+      /** \brief Pointer to the first entry of the row */
+      K* data () noexcept
+      {
+        return dataP_;
+      }
+
+      /** \brief Pointer to the first entry of the row */
+      const K* data () const noexcept
+      {
+        return dataP_;
+      }
+
+      //! Swap the entries of two rows of equal length
+      friend void swap (ContiguousRowView& a, ContiguousRowView& b)
+      {
+        DUNE_ASSERT_BOUNDS(a.size() == b.size());
+        std::swap_ranges(a.dataP_, a.dataP_ + a.size_, b.dataP_);
+      }
+    };
+
+  } // end namespace Impl
+
+  template< class K >
+  struct DenseMatVecTraits< Impl::ContiguousRowView<K> >
+  {
+    using derived_type = Impl::ContiguousRowView<K>;
+    using value_type = std::remove_const_t<K>;
+    using size_type = std::size_t;
+  };
+
+  template< class K >
+  struct FieldTraits< Impl::ContiguousRowView<K> > : public FieldTraits<std::remove_const_t<K>> {};
+
+  template<class K>
+  struct AutonomousValueType<Impl::ContiguousRowView<K>>
+  {
+    using type = DynamicVector<std::remove_const_t<K>>;
+  };
+
+  template< class K >
+  struct DenseMatVecTraits< ContiguousDynamicMatrix<K> >
+  {
+    typedef ContiguousDynamicMatrix<K> derived_type;
+
+    typedef Impl::ContiguousRowView<K> row_type;
+
+    typedef row_type &row_reference;
+    typedef const row_type &const_row_reference;
+
+    typedef std::vector<K> container_type;
+    typedef K value_type;
+    typedef typename container_type::size_type size_type;
+  };
+
+  template< class K >
+  struct FieldTraits< ContiguousDynamicMatrix<K> >
+  {
+    typedef typename FieldTraits<K>::field_type field_type;
+    typedef typename FieldTraits<K>::real_type real_type;
+  };
+
+  /** \brief A dense matrix with dynamic size and contiguous row-major storage
+   *
+   * In contrast to DynamicMatrix, which stores each row in a separate
+   * DynamicVector, all entries are kept in a single buffer.  Rows are accessed
+   * through views onto this buffer, which are kept in a second array so that
+   * rows can be handed out by reference as for DynamicMatrix.  This avoids
+   * one heap allocation per row and improves locality in matrix-vector
+   * products and the LU decomposition.  Resizing only reallocates if the
+   * capacity of the buffer is exceeded.
+   *
+   * \tparam K is the field type (use float, double, complex, etc)
+   */
+  template<class K>
+  class ContiguousDynamicMatrix : public DenseMatrix< ContiguousDynamicMatrix<K> >
+  {
+    std::vector<K> _data;
+    std::vector< Impl::ContiguousRowView<K> > _rowViews;
+    std::size_t _cols = 0;
+    typedef DenseMatrix< ContiguousDynamicMatrix<K> > Base;
+
+    // vectors whose entries can be handed to BLAS without copying
+    template<class X, class Y>
+    static constexpr bool blasVectors = DenseBlas::isBlasField<K> &&
+      requires (const X& x, Y& y) {
+        { x.data() } -> std::convertible_to<const K*>;
+        { y.data() } -> std::convertible_to<K*>;
+      };
+
+    // (re-)create the row views after the buffer or the shape has changed
+    void updateRowViews (std::size_t r)
+    {
+      _rowViews.clear();
+      _rowViews.reserve(r);
+      for (std::size_t i = 0; i < r; ++i)
+        _rowViews.emplace_back(_data.data() + i*_cols, _cols);
+    }
+
+  public:
+    typedef typename Base::size_type size_type;
+    typedef typename Base::value_type value_type;
+    typedef typename Base::row_type row_type;
+    typedef typename Base::row_reference row_reference;
+    typedef typename Base::const_row_reference const_row_reference;
+
+    //===== constructors
+    //! \brief Default constructor
+    ContiguousDynamicMatrix () {}
+
+    //! \brief Constructor initializing the whole matrix with a scalar
+    ContiguousDynamicMatrix (size_type r, size_type c, value_type v = value_type() ) :
+      _data(r*c, v), _cols(c)
+    {
+      updateRowViews(r);
+    }
+
+    //! Copy constructor
+    ContiguousDynamicMatrix (const ContiguousDynamicMatrix& other) :
+      Base(), _data(other._data), _cols(other._cols)
+    {
+      updateRowViews(other.N());
+    }
+
+    //! Move constructor, the row views stay valid as the buffer is moved
+    ContiguousDynamicMatrix (ContiguousDynamicMatrix&& other) :
+      Base(), _data(std::move(other._data)),
+      _rowViews(std::move(other._rowViews)), _cols(other._cols)
+    {
+      other.resize(0, 0);
+    }
+
+    /** \brief Constructor initializing the matrix from a list of vector
+     */
+    ContiguousDynamicMatrix (std::initializer_list<DynamicVector<K>> const &ll)
+      : _cols(ll.size() > 0 ? ll.begin()->size() : 0)
+    {
+      _data.reserve(ll.size()*_cols);
+      for (const auto& row : ll)
+      {
+        DUNE_ASSERT_BOUNDS(row.size() == _cols);
+        _data.insert(_data.end(), row.begin(), row.end());
+      }
+      updateRowViews(ll.size());
+    }
+
+    template <class T,
+              typename = std::enable_if_t<!Dune::IsNumber<T>::value>>
+    ContiguousDynamicMatrix(T const& rhs)
+    {
+      *this = rhs;
+    }
+
+    //==== resize related methods
+    /**
+     * \brief resize matrix to <code>r × c</code>
+     *
+     * Resize the matrix to <code>r × c</code>, using <code>v</code>
+     * as the value of all entries.  No memory is allocated if
+     * <code>r*c</code> does not exceed capacity().
+     *
+     * \warning All previous entries are lost, even when the matrix
+     *          was not actually resized.
+     *
+     * \param r number of rows
+     * \param c number of columns
+     * \param v value of matrix entries
+     */
+    void resize (size_type r, size_type c, value_type v = value_type() )
+    {
+      _data.assign(r*c, v);
+      _cols = c;
+      updateRowViews(r);
+    }
+
+    //! Reserve memory for at least \p n entries
+    void reserve (size_type n)
+    {
+      _data.reserve(n);
+    }
+
+    //! Number of entries for which memory has been allocated
+    size_type capacity () const
+    {
+      return _data.capacity();
+    }
+
+    //===== assignment
+    //! Copy assignment, reuses the buffer if its capacity suffices
+    ContiguousDynamicMatrix& operator=(const ContiguousDynamicMatrix& other) {
+      if (this != &other)
+      {
+        _data.assign(other._data.begin(), other._data.end());
+        _cols = other._cols;
+        updateRowViews(other.N());
+      }
+      return *this;
+    }
+
+    //! Move assignment
+    ContiguousDynamicMatrix& operator=(ContiguousDynamicMatrix&& other) {
+      if (this != &other)
+      {
+        _data = std::move(other._data);
+        _rowViews = std::move(other._rowViews);
+        _cols = other._cols;
+        other.resize(0, 0);
+      }
+      return *this;
+    }
+
+    // General assignment with resizing
+    template <typename T,
+              typename = std::enable_if_t<!Dune::IsNumber<T>::value>>
+    ContiguousDynamicMatrix& operator=(T const& rhs) {
+      resize(rhs.N(), rhs.M());
+      for (size_type i = 0; i < rhs.N(); ++i)
+        for (size_type j = 0; j < _cols; ++j)
+          _data[i*_cols + j] = rhs[i][j];
+      return *this;
+    }
+
+    // Specialisation: scalar assignment (no resizing)
+    template <typename T,
+              typename = std::enable_if_t<Dune::IsNumber<T>::value>>
+    ContiguousDynamicMatrix& operator=(T scalar) {
+      std::fill(_data.begin(), _data.end(), scalar);
+      return *this;
+    }
+
+    //! Return transposed of the matrix as ContiguousDynamicMatrix
+    ContiguousDynamicMatrix transposed() const
+    {
+      ContiguousDynamicMatrix AT(this->M(), this->N());
+      for( size_type i = 0; i < this->N(); ++i )
+        for( size_type j = 0; j < this->M(); ++j )
+          AT._data[j*AT._cols + i] = _data[i*_cols + j];
+      return AT;
+    }
+
+    //===== linear maps
+    // These hide the generic DenseMatrix implementations and traverse the
+    // buffer row by row with unit stride.  Large matrices with float, double
+    // or complex entries use BLAS if available (see dune/common/denseblas.hh).
+
+    //! y = A x
+    template<class X, class Y>
+    void mv (const X& x, Y& y) const
+    {
+      auto&& xx = Impl::asVector(x);
+      auto&& yy = Impl::asVector(y);
+      DUNE_ASSERT_BOUNDS((void*)(&x) != (void*)(&y));
+      DUNE_ASSERT_BOUNDS(xx.N() == this->M());
+      DUNE_ASSERT_BOUNDS(yy.N() == this->N());
+
+      if constexpr (blasVectors<X,Y>)
+        if (DenseBlas::useBlas<K>(this->N(), this->M()))
+          return DenseBlas::rowMajorGemv(false, this->N(), _cols,
+                                         K(1), _data.data(), x.data(), K(0), y.data());
+
+      using y_field_type = typename FieldTraits<Y>::field_type;
+      const K* a = _data.data();
+      for (size_type i=0; i<this->N(); ++i, a += _cols)
+      {
+        y_field_type sum(0);
+        for (size_type j=0; j<_cols; j++)
+          sum += a[j] * xx[j];
+        yy[i] = sum;
+      }
+    }
+
+    //! y = A^T x
+    template<class X, class Y>
+    void mtv (const X& x, Y& y) const
+    {
+      auto&& yy = Impl::asVector(y);
+      DUNE_ASSERT_BOUNDS((void*)(&x) != (void*)(&y));
+
+      if constexpr (blasVectors<X,Y>)
+        if (DenseBlas::useBlas<K>(this->N(), this->M()))
+        {
+          DUNE_ASSERT_BOUNDS(x.size() == this->N());
+          DUNE_ASSERT_BOUNDS(y.size() == this->M());
+          return DenseBlas::rowMajorGemv(true, this->N(), _cols,
+                                         K(1), _data.data(), x.data(), K(0), y.data());
+        }
+
+      using y_field_type = typename FieldTraits<Y>::field_type;
+      for (size_type j=0; j<yy.N(); ++j)
+        yy[j] = y_field_type(0);
+      umtv(x, y);
+    }
+
+    //! y += A x
+    template<class X, class Y>
+    void umv (const X& x, Y& y) const
+    {
+      auto&& xx = Impl::asVector(x);
+      auto&& yy = Impl::asVector(y);
+      DUNE_ASSERT_BOUNDS(xx.N() == this->M());
+      DUNE_ASSERT_BOUNDS(yy.N() == this->N());
+
+      if constexpr (blasVectors<X,Y>)
+        if (DenseBlas::useBlas<K>(this->N(), this->M()))
+          return DenseBlas::rowMajorGemv(false, this->N(), _cols,
+                                         K(1), _data.data(), x.data(), K(1), y.data());
+
+      using y_field_type = typename FieldTraits<Y>::field_type;
+      const K* a = _data.data();
+      for (size_type i=0; i<this->N(); ++i, a += _cols)
+      {
+        y_field_type sum(0);
+        for (size_type j=0; j<_cols; j++)
+          sum += a[j] * xx[j];
+        yy[i] += sum;
+      }
+    }
+
+    //! y += A^T x
+    template<class X, class Y>
+    void umtv (const X& x, Y& y) const
+    {
+      auto&& xx = Impl::asVector(x);
+      auto&& yy = Impl::asVector(y);
+      DUNE_ASSERT_BOUNDS(xx.N() == this->N());
+      DUNE_ASSERT_BOUNDS(yy.N() == this->M());
+
+      if constexpr (blasVectors<X,Y>)
+        if (DenseBlas::useBlas<K>(this->N(), this->M()))
+          return DenseBlas::rowMajorGemv(true, this->N(), _cols,
+                                         K(1), _data.data(), x.data(), K(1), y.data());
+
+      const K* a = _data.data();
+      for (size_type i=0; i<this->N(); ++i, a += _cols)
+      {
+        const auto xi = xx[i];
+        for (size_type j=0; j<_cols; j++)
+          yy[j] += a[j] * xi;
+      }
+    }
+
+    //===== BLAS/LAPACK dispatch
+    // LAPACK always pivots, hence it is only used when doPivoting is set.
+
+    /** \brief Solve system A x = b
+     *
+     * \exception FMatrixError if the matrix is singular
+     */
+    template <class V1, class V2>
+    void solve (V1& x, const V2& b, bool doPivoting = true) const
+    {
+      if constexpr (DenseBlas::isBlasField<K>)
+        if (doPivoting && DenseBlas::useLapack<K>(this->N(), this->M()))
+          return DenseBlas::solve(*this, x, b);
+      Base::solve(x, b, doPivoting);
+    }
+
+    /** \brief Compute inverse
+     *
+     * \exception FMatrixError if the matrix is singular
+     */
+    void invert (bool doPivoting = true)
+    {
+      if constexpr (DenseBlas::isBlasField<K>)
+        if (doPivoting && DenseBlas::useLapack<K>(this->N(), this->M()))
+          return DenseBlas::invert(*this);
+      Base::invert(doPivoting);
+    }
+
+    //! calculates the determinant of this matrix
+    value_type determinant (bool doPivoting = true) const
+    {
+      if constexpr (DenseBlas::isBlasField<K>)
+        if (doPivoting && DenseBlas::useLapack<K>(this->N(), this->M()))
+          return DenseBlas::determinant(*this);
+      return Base::determinant(doPivoting);
+    }
+
+    //! Multiplies M from the left to this matrix
+    template<typename M2>
+    ContiguousDynamicMatrix& leftmultiply (const DenseMatrix<M2>& M)
+    {
+      if constexpr (std::is_same_v<typename DenseMatrix<M2>::value_type, K> && DenseBlas::isBlasField<K>)
+        if (DenseBlas::useBlas<K>(this->N(), this->M()))
+        {
+          DUNE_ASSERT_BOUNDS(M.rows() == M.cols());
+          DUNE_ASSERT_BOUNDS(M.rows() == this->rows());
+          DenseBlas::multiply(M, *this, *this);
+          return *this;
+        }
+      return Base::leftmultiply(M);
+    }
+
+    //! Multiplies M from the right to this matrix
+    template<typename M2>
+    ContiguousDynamicMatrix& rightmultiply (const DenseMatrix<M2>& M)
+    {
+      if constexpr (std::is_same_v<typename DenseMatrix<M2>::value_type, K> && DenseBlas::isBlasField<K>)
+        if (DenseBlas::useBlas<K>(this->N(), this->M()))
+        {
+          DUNE_ASSERT_BOUNDS(M.rows() == M.cols());
+          DUNE_ASSERT_BOUNDS(M.cols() == this->cols());
+          DenseBlas::multiply(*this, M, *this);
+          return *this;
+        }
+      return Base::rightmultiply(M);
+    }
+
+    //! Pointer to the row-major buffer of all entries
+    K* data () noexcept
+    {
+      return _data.data();
+    }
+
+    //! Pointer to the row-major buffer of all entries
+    const K* data () const noexcept
+    {
+      return _data.data();
+    }
+
+    // make this thing a matrix
+    size_type mat_rows() const { return _rowViews.size(); }
+    size_type mat_cols() const { return _cols; }
+    row_reference mat_access(size_type i) {
+      DUNE_ASSERT_BOUNDS(i < _rowViews.size());
+      return _rowViews[i];
+    }
+    const_row_reference mat_access(size_type i) const {
+      DUNE_ASSERT_BOUNDS(i < _rowViews.size());
+      return _rowViews[i];
+    }
+  };
+
+  /** @} end documentation */
+
+} // end namespace
+
+#endif
@@ -0,0 +1,192 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <complex>
+
+#include <dune-common-config.hh>  // HAVE_BLAS, HAVE_LAPACK, LAPACK_NEEDS_UNDERLINE
+
+#include <dune/common/denseblas.hh>
+
+#if HAVE_BLAS
+
+#ifdef LAPACK_NEEDS_UNDERLINE
+  #define DENSEBLAS_MANGLE(name) name##_
+#else
+  #define DENSEBLAS_MANGLE(name) name
+#endif
+
+// Fortran interfaces of BLAS and LAPACK.  Complex arguments are passed as
+// std::complex, which is layout compatible with the Fortran COMPLEX types.
+extern "C" {
+
+  // y := alpha*op(A)*x + beta*y
+#define DENSEBLAS_DECLARE_GEMV(prefix, K)                                    \
+  void DENSEBLAS_MANGLE(prefix##gemv) (const char* trans, const int* m,       \
+                                       const int* n, const K* alpha,          \
+                                       const K* a, const int* lda,            \
+                                       const K* x, const int* incx,           \
+                                       const K* beta, K* y, const int* incy);
+
+  // C := alpha*op(A)*op(B) + beta*C
+#define DENSEBLAS_DECLARE_GEMM(prefix, K)                                    \
+  void DENSEBLAS_MANGLE(prefix##gemm) (const char* transa, const char* transb, \
+                                       const int* m, const int* n,            \
+                                       const int* k, const K* alpha,          \
+                                       const K* a, const int* lda,            \
+                                       const K* b, const int* ldb,            \
+                                       const K* beta, K* c, const int* ldc);
+
+  DENSEBLAS_DECLARE_GEMV(s, float)
+  DENSEBLAS_DECLARE_GEMV(d, double)
+  DENSEBLAS_DECLARE_GEMV(c, std::complex<float>)
+  DENSEBLAS_DECLARE_GEMV(z, std::complex<double>)
+
+  DENSEBLAS_DECLARE_GEMM(s, float)
+  DENSEBLAS_DECLARE_GEMM(d, double)
+  DENSEBLAS_DECLARE_GEMM(c, std::complex<float>)
+  DENSEBLAS_DECLARE_GEMM(z, std::complex<double>)
+
+#if HAVE_LAPACK
+  // LU decomposition with partial pivoting, A = P*L*U
+#define DENSEBLAS_DECLARE_GETRF(prefix, K)                                   \
+  void DENSEBLAS_MANGLE(prefix##getrf) (const int* m, const int* n, K* a,     \
+                                        const int* lda, int* ipiv, int* info);
+
+  // solve op(A)*X = B with the factorization computed by xgetrf
+#define DENSEBLAS_DECLARE_GETRS(prefix, K)                                   \
+  void DENSEBLAS_MANGLE(prefix##getrs) (const char* trans, const int* n,      \
+                                        const int* nrhs, const K* a,          \
+                                        const int* lda, const int* ipiv,      \
+                                        K* b, const int* ldb, int* info);
+
+  // inverse of A from the factorization computed by xgetrf
+#define DENSEBLAS_DECLARE_GETRI(prefix, K)                                   \
+  void DENSEBLAS_MANGLE(prefix##getri) (const int* n, K* a, const int* lda,   \
+                                        const int* ipiv, K* work,             \
+                                        const int* lwork, int* info);
+
+  DENSEBLAS_DECLARE_GETRF(s, float)
+  DENSEBLAS_DECLARE_GETRF(d, double)
+  DENSEBLAS_DECLARE_GETRF(c, std::complex<float>)
+  DENSEBLAS_DECLARE_GETRF(z, std::complex<double>)
+
+  DENSEBLAS_DECLARE_GETRS(s, float)
+  DENSEBLAS_DECLARE_GETRS(d, double)
+  DENSEBLAS_DECLARE_GETRS(c, std::complex<float>)
+  DENSEBLAS_DECLARE_GETRS(z, std::complex<double>)
+
+  DENSEBLAS_DECLARE_GETRI(s, float)
+  DENSEBLAS_DECLARE_GETRI(d, double)
+  DENSEBLAS_DECLARE_GETRI(c, std::complex<float>)
+  DENSEBLAS_DECLARE_GETRI(z, std::complex<double>)
+
+  // selected eigenvalues and -vectors of a symmetric matrix (MRRR algorithm)
+#define DENSEBLAS_DECLARE_SYEVR(prefix, K)                                   \
+  void DENSEBLAS_MANGLE(prefix##syevr) (const char* jobz, const char* range,  \
+                                        const char* uplo, const int* n, K* a, \
+                                        const int* lda, const K* vl,          \
+                                        const K* vu, const int* il,           \
+                                        const int* iu, const K* abstol,       \
+                                        int* m, K* w, K* z, const int* ldz,   \
+                                        int* isuppz, K* work,                 \
+                                        const int* lwork, int* iwork,         \
+                                        const int* liwork, int* info);
+
+  // eigenvalues and -vectors of a nonsymmetric matrix
+#define DENSEBLAS_DECLARE_GEEV(prefix, K)                                    \
+  void DENSEBLAS_MANGLE(prefix##geev) (const char* jobvl, const char* jobvr,  \
+                                       const int* n, K* a, const int* lda,    \
+                                       K* wr, K* wi, K* vl, const int* ldvl,  \
+                                       K* vr, const int* ldvr, K* work,       \
+                                       const int* lwork, int* info);
+
+  DENSEBLAS_DECLARE_SYEVR(s, float)
+  DENSEBLAS_DECLARE_SYEVR(d, double)
+
+  DENSEBLAS_DECLARE_GEEV(s, float)
+  DENSEBLAS_DECLARE_GEEV(d, double)
+#endif // HAVE_LAPACK
+
+} // end extern C
+
+namespace Dune {
+
+  namespace DenseBlas {
+
+#define DENSEBLAS_DEFINE_BLAS(prefix, K)                                     \
+    void gemv (char trans, int m, int n, K alpha, const K* a, int lda,       \
+               const K* x, K beta, K* y)                                     \
+    {                                                                        \
+      const int inc = 1;                                                     \
+      DENSEBLAS_MANGLE(prefix##gemv)(&trans, &m, &n, &alpha, a, &lda,        \
+                                     x, &inc, &beta, y, &inc);               \
+    }                                                                        \
+                                                                             \
+    void gemm (char transa, char transb, int m, int n, int k, K alpha,       \
+               const K* a, int lda, const K* b, int ldb, K beta,             \
+               K* c, int ldc)                                                \
+    {                                                                        \
+      DENSEBLAS_MANGLE(prefix##gemm)(&transa, &transb, &m, &n, &k, &alpha,   \
+                                     a, &lda, b, &ldb, &beta, c, &ldc);      \
+    }
+
+    DENSEBLAS_DEFINE_BLAS(s, float)
+    DENSEBLAS_DEFINE_BLAS(d, double)
+    DENSEBLAS_DEFINE_BLAS(c, std::complex<float>)
+    DENSEBLAS_DEFINE_BLAS(z, std::complex<double>)
+
+#if HAVE_LAPACK
+#define DENSEBLAS_DEFINE_LAPACK(prefix, K)                                   \
+    void getrf (int n, K* a, int lda, int* ipiv, int* info)                  \
+    {                                                                        \
+      DENSEBLAS_MANGLE(prefix##getrf)(&n, &n, a, &lda, ipiv, info);          \
+    }                                                                        \
+                                                                             \
+    void getrs (char trans, int n, int nrhs, const K* a, int lda,            \
+                const int* ipiv, K* b, int ldb, int* info)                   \
+    {                                                                        \
+      DENSEBLAS_MANGLE(prefix##getrs)(&trans, &n, &nrhs, a, &lda, ipiv,      \
+                                      b, &ldb, info);                        \
+    }                                                                        \
+                                                                             \
+    void getri (int n, K* a, int lda, const int* ipiv, K* work,              \
+                int lwork, int* info)                                        \
+    {                                                                        \
+      DENSEBLAS_MANGLE(prefix##getri)(&n, a, &lda, ipiv, work, &lwork, info); \
+    }
+
+    DENSEBLAS_DEFINE_LAPACK(s, float)
+    DENSEBLAS_DEFINE_LAPACK(d, double)
+    DENSEBLAS_DEFINE_LAPACK(c, std::complex<float>)
+    DENSEBLAS_DEFINE_LAPACK(z, std::complex<double>)
+
+#define DENSEBLAS_DEFINE_LAPACK_EIGEN(prefix, K)                             \
+    void syevr (char jobz, char range, char uplo, int n, K* a, int lda,      \
+                K vl, K vu, int il, int iu, K abstol, int* m, K* w,          \
+                K* z, int ldz, int* isuppz, K* work, int lwork,              \
+                int* iwork, int liwork, int* info)                           \
+    {                                                                        \
+      DENSEBLAS_MANGLE(prefix##syevr)(&jobz, &range, &uplo, &n, a, &lda,     \
+                                      &vl, &vu, &il, &iu, &abstol, m, w,     \
+                                      z, &ldz, isuppz, work, &lwork,         \
+                                      iwork, &liwork, info);                 \
+    }                                                                        \
+                                                                             \
+    void geev (char jobvl, char jobvr, int n, K* a, int lda, K* wr,          \
+               K* wi, K* vl, int ldvl, K* vr, int ldvr, K* work,             \
+               int lwork, int* info)                                         \
+    {                                                                        \
+      DENSEBLAS_MANGLE(prefix##geev)(&jobvl, &jobvr, &n, a, &lda, wr, wi,    \
+                                     vl, &ldvl, vr, &ldvr, work, &lwork,     \
+                                     info);                                  \
+    }
+
+    DENSEBLAS_DEFINE_LAPACK_EIGEN(s, float)
+    DENSEBLAS_DEFINE_LAPACK_EIGEN(d, double)
+#endif // HAVE_LAPACK
+
+  } // end namespace DenseBlas
+} // end namespace Dune
+
+#endif // HAVE_BLAS
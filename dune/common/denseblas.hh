@@ -0,0 +1,303 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_DENSEBLAS_HH
+#define DUNE_COMMON_DENSEBLAS_HH
+
+/** \file
+ * \brief BLAS and LAPACK backend for large dynamic dense matrices
+ *
+ * DynamicMatrix and ContiguousDynamicMatrix with entries of type float,
+ * double, std::complex<float> or std::complex<double> forward matrix-vector
+ * products, matrix-matrix products, solve(), invert() and determinant() to
+ * BLAS and LAPACK once both dimensions reach DenseBlas::threshold().  Smaller
+ * matrices, other field types, or builds without BLAS/LAPACK use the
+ * generic implementations of DenseMatrix.
+ *
+ * The routines work on row-major buffers.  Such a buffer holds the transposed
+ * matrix in the column-major layout expected by Fortran, which is taken into
+ * account by the choice of the \c trans arguments.
+ */
+
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include <dune-common-config.hh>  // HAVE_BLAS, HAVE_LAPACK
+#include <dune/common/densematrix.hh>
+#include <dune/common/exceptions.hh>
+
+/** \brief Default for DenseBlas::threshold()
+ *
+ * Define this macro before including any DUNE header to change the default
+ * minimal matrix dimension for which BLAS/LAPACK are used.
+ */
+#ifndef DUNE_DENSE_BLAS_THRESHOLD
+#define DUNE_DENSE_BLAS_THRESHOLD 64
+#endif
+
+namespace Dune {
+
+  /**
+     @addtogroup DenseMatVec
+     @{
+   */
+
+  namespace DenseBlas {
+
+    /** \brief Minimal number of rows and columns for which BLAS/LAPACK are used
+     *
+     * The value is initialized with DUNE_DENSE_BLAS_THRESHOLD and can be
+     * changed at run time, e.g. <tt>DenseBlas::threshold() = 128;</tt>
+     */
+    inline std::size_t& threshold ()
+    {
+      static std::size_t value = DUNE_DENSE_BLAS_THRESHOLD;
+      return value;
+    }
+
+    //! Whether BLAS/LAPACK provide routines for the field type \c K
+    template<class K>
+    inline constexpr bool isBlasField =
+      std::is_same_v<K, float> || std::is_same_v<K, double> ||
+      std::is_same_v<K, std::complex<float>> || std::is_same_v<K, std::complex<double>>;
+
+    //! Whether a rows x cols matrix with entries of type \c K is handled by BLAS
+    template<class K>
+    bool useBlas (std::size_t rows, std::size_t cols)
+    {
+#if HAVE_BLAS
+      return isBlasField<K> && std::min(rows, cols) >= std::max<std::size_t>(threshold(), 1);
+#else
+      return false;
+#endif
+    }
+
+    //! Whether a rows x cols matrix with entries of type \c K is factorized by LAPACK
+    template<class K>
+    bool useLapack (std::size_t rows, std::size_t cols)
+    {
+#if HAVE_LAPACK
+      return rows == cols && useBlas<K>(rows, cols);
+#else
+      return false;
+#endif
+    }
+
+#if HAVE_BLAS
+    // defined in denseblas.cc
+#define DUNE_DENSEBLAS_DECLARE_BLAS(K)                                  \
+    void gemv (char trans, int m, int n, K alpha, const K* a, int lda,  \
+               const K* x, K beta, K* y);                               \
+    void gemm (char transa, char transb, int m, int n, int k, K alpha,  \
+               const K* a, int lda, const K* b, int ldb, K beta,        \
+               K* c, int ldc);
+
+    DUNE_DENSEBLAS_DECLARE_BLAS(float)
+    DUNE_DENSEBLAS_DECLARE_BLAS(double)
+    DUNE_DENSEBLAS_DECLARE_BLAS(std::complex<float>)
+    DUNE_DENSEBLAS_DECLARE_BLAS(std::complex<double>)
+#undef DUNE_DENSEBLAS_DECLARE_BLAS
+#endif
+
+#if HAVE_LAPACK
+    // defined in denseblas.cc
+#define DUNE_DENSEBLAS_DECLARE_LAPACK(K)                                \
+    void getrf (int n, K* a, int lda, int* ipiv, int* info);            \
+    void getrs (char trans, int n, int nrhs, const K* a, int lda,       \
+                const int* ipiv, K* b, int ldb, int* info);             \
+    void getri (int n, K* a, int lda, const int* ipiv, K* work,         \
+                int lwork, int* info);
+
+    DUNE_DENSEBLAS_DECLARE_LAPACK(float)
+    DUNE_DENSEBLAS_DECLARE_LAPACK(double)
+    DUNE_DENSEBLAS_DECLARE_LAPACK(std::complex<float>)
+    DUNE_DENSEBLAS_DECLARE_LAPACK(std::complex<double>)
+#undef DUNE_DENSEBLAS_DECLARE_LAPACK
+
+    // eigenvalue problems for real matrices, defined in denseblas.cc
+#define DUNE_DENSEBLAS_DECLARE_LAPACK_EIGEN(K)                          \
+    void syevr (char jobz, char range, char uplo, int n, K* a, int lda, \
+                K vl, K vu, int il, int iu, K abstol, int* m, K* w,     \
+                K* z, int ldz, int* isuppz, K* work, int lwork,         \
+                int* iwork, int liwork, int* info);                     \
+    void geev (char jobvl, char jobvr, int n, K* a, int lda, K* wr,     \
+               K* wi, K* vl, int ldvl, K* vr, int ldvr, K* work,        \
+               int lwork, int* info);
+
+    DUNE_DENSEBLAS_DECLARE_LAPACK_EIGEN(float)
+    DUNE_DENSEBLAS_DECLARE_LAPACK_EIGEN(double)
+#undef DUNE_DENSEBLAS_DECLARE_LAPACK_EIGEN
+#endif
+
+    namespace Impl {
+
+      template<class M, class K>
+      void copyToRowMajor (const DenseMatrix<M>& A, std::vector<K>& buffer)
+      {
+        const std::size_t cols = A.M();
+        buffer.resize(A.N()*cols);
+        for (std::size_t i = 0; i < A.N(); ++i)
+          std::copy(A[i].begin(), A[i].end(), buffer.begin() + i*cols);
+      }
+
+      template<class M, class K>
+      void copyFromRowMajor (const std::vector<K>& buffer, DenseMatrix<M>& A)
+      {
+        const std::size_t cols = A.M();
+        for (std::size_t i = 0; i < A.N(); ++i)
+          std::copy_n(buffer.begin() + i*cols, cols, A[i].begin());
+      }
+
+      [[noreturn]] inline void throwMissingBackend (const char* what)
+      {
+        DUNE_THROW(NotImplemented, "DenseBlas: " << what << " is not available");
+      }
+
+    } // end namespace Impl
+
+    /** \brief y = alpha A x + beta y, or with A^T if \p transposed, for a row-major A
+     *
+     * \param rows,cols  shape of A, the leading dimension is \p cols
+     */
+    template<class K>
+    void rowMajorGemv (bool transposed, std::size_t rows, std::size_t cols,
+                       K alpha, const K* a, const K* x, K beta, K* y)
+    {
+#if HAVE_BLAS
+      // the buffer holds A^T in column-major order
+      gemv(transposed ? 'N' : 'T', int(cols), int(rows), alpha, a, int(cols), x, beta, y);
+#else
+      Impl::throwMissingBackend("BLAS");
+#endif
+    }
+
+    /** \brief C = A B for row-major matrices A (n x k), B (k x m) and C (n x m)
+     *
+     * \p c must not alias \p a or \p b.
+     */
+    template<class K>
+    void rowMajorGemm (std::size_t n, std::size_t k, std::size_t m,
+                       const K* a, const K* b, K* c)
+    {
+#if HAVE_BLAS
+      // C^T = B^T A^T in column-major order
+      gemm('N', 'N', int(m), int(n), int(k), K(1), b, int(m), a, int(k), K(0), c, int(m));
+#else
+      Impl::throwMissingBackend("BLAS");
+#endif
+    }
+
+    //! C = A B for dense matrices, C may alias A or B
+    template<class MA, class MB, class MC>
+    void multiply (const DenseMatrix<MA>& A, const DenseMatrix<MB>& B, DenseMatrix<MC>& C)
+    {
+      using K = typename DenseMatrix<MC>::value_type;
+      DUNE_ASSERT_BOUNDS(A.M() == B.N());
+      DUNE_ASSERT_BOUNDS(C.N() == A.N() && C.M() == B.M());
+      std::vector<K> a, b, c(A.N()*B.M());
+      Impl::copyToRowMajor(A, a);
+      Impl::copyToRowMajor(B, b);
+      rowMajorGemm(A.N(), A.M(), B.M(), a.data(), b.data(), c.data());
+      Impl::copyFromRowMajor(c, C);
+    }
+
+    /** \brief Solve A x = b by LAPACK's LU decomposition with partial pivoting
+     *
+     * \exception FMatrixError if the matrix is singular
+     */
+    template<class M, class V1, class V2>
+    void solve (const DenseMatrix<M>& A, V1& x, const V2& b)
+    {
+#if HAVE_LAPACK
+      using K = typename DenseMatrix<M>::value_type;
+      const int n = A.N();
+      std::vector<K> a, rhs(n);
+      std::vector<int> ipiv(n);
+      Impl::copyToRowMajor(A, a);
+      for (int i = 0; i < n; ++i)
+        rhs[i] = b[i];
+
+      int info = 0;
+      getrf(n, a.data(), n, ipiv.data(), &info);
+      if (info > 0)
+        DUNE_THROW(FMatrixError, "matrix is singular");
+      // the factorization is the one of A^T, hence solve the transposed system
+      getrs('T', n, 1, a.data(), n, ipiv.data(), rhs.data(), n, &info);
+
+      for (int i = 0; i < n; ++i)
+        x[i] = rhs[i];
+#else
+      Impl::throwMissingBackend("LAPACK");
+#endif
+    }
+
+    /** \brief Invert A in place using LAPACK's getrf and getri
+     *
+     * \exception FMatrixError if the matrix is singular
+     */
+    template<class M>
+    void invert (DenseMatrix<M>& A)
+    {
+#if HAVE_LAPACK
+      using K = typename DenseMatrix<M>::value_type;
+      const int n = A.N();
+      std::vector<K> a;
+      std::vector<int> ipiv(n);
+      Impl::copyToRowMajor(A, a);
+
+      int info = 0;
+      getrf(n, a.data(), n, ipiv.data(), &info);
+      if (info > 0)
+        DUNE_THROW(FMatrixError, "matrix is singular");
+
+      // (A^T)^{-1} in column-major order is A^{-1} in row-major order
+      K lworkQuery;
+      getri(n, a.data(), n, ipiv.data(), &lworkQuery, -1, &info);
+      std::vector<K> work(std::max<std::size_t>(std::real(lworkQuery), 1));
+      getri(n, a.data(), n, ipiv.data(), work.data(), int(work.size()), &info);
+      Impl::copyFromRowMajor(a, A);
+#else
+      Impl::throwMissingBackend("LAPACK");
+#endif
+    }
+
+    //! Determinant of A computed from LAPACK's LU decomposition
+    template<class M>
+    typename DenseMatrix<M>::value_type determinant (const DenseMatrix<M>& A)
+    {
+      using K = typename DenseMatrix<M>::value_type;
+#if HAVE_LAPACK
+      const int n = A.N();
+      std::vector<K> a;
+      std::vector<int> ipiv(n);
+      Impl::copyToRowMajor(A, a);
+
+      int info = 0;
+      getrf(n, a.data(), n, ipiv.data(), &info);
+      if (info > 0)
+        return K(0);
+
+      K det(1);
+      for (int i = 0; i < n; ++i)
+      {
+        det *= a[i*n + i];
+        if (ipiv[i] != i+1)
+          det = -det;
+      }
+      return det;
+#else
+      Impl::throwMissingBackend("LAPACK");
+#endif
+    }
+
+  } // end namespace DenseBlas
+
+  /** @} end documentation */
+
+} // end namespace Dune
+
+#endif // DUNE_COMMON_DENSEBLAS_HH
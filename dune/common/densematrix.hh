@@ -1158,11 +1158,12 @@ namespace Dune
       nonsingularLanes(true);
 
     AutonomousValue<MAT>::luDecomposition(A, ElimDet(det), nonsingularLanes, false, doPivoting);
-    det = Simd::cond(nonsingularLanes, det, field_type(0));
 
     for (size_type i = 0; i < rows(); ++i)
       det *= A[i][i];
-    return det;
+    // the diagonal of singular lanes may contain NaNs, so mask them only after
+    // the product has been formed
+    return Simd::cond(nonsingularLanes, det, field_type(0));
   }
 
 #endif // DOXYGEN
@@ -16,12 +16,24 @@
 #include "promotiontraits.hh"
 #include "dotproduct.hh"
 #include "boundschecking.hh"
+#include "densevectorreduction.hh"
 
 namespace Dune {
 
   // forward declaration of template
   template<typename V> class DenseVector;
 
+  // defined in densevectorexpression.hh
+  template<typename E> class DenseVectorExpression;
+
+  namespace Impl {
+
+    //! Whether E is a lazily evaluated expression, see densevectorexpression.hh
+    template<class E>
+    concept IsDenseVectorExpression = std::is_base_of_v<DenseVectorExpression<E>, E>;
+
+  } // end namespace Impl
+
   template<typename V>
   struct FieldTraits< DenseVector<V> >
   {
@@ -304,6 +316,17 @@ namespace Dune {
       return asImp();
     }
 
+    //! Assignment from a lazily evaluated expression, see densevectorexpression.hh
+    template <class E>
+      requires Impl::IsDenseVectorExpression<E>
+    constexpr derived_type& operator= (const E& e)
+    {
+      DUNE_ASSERT_BOUNDS(e.size() == size());
+      for (size_type i=0; i<size(); i++)
+        asImp()[i] = e[i];
+      return asImp();
+    }
+
     //===== access to components
 
     //! random access
@@ -449,6 +472,28 @@ namespace Dune {
       return asImp();
     }
 
+    //! vector space addition of a lazily evaluated expression
+    template <class E>
+      requires Impl::IsDenseVectorExpression<E>
+    constexpr derived_type& operator+= (const E& e)
+    {
+      DUNE_ASSERT_BOUNDS(e.size() == size());
+      for (size_type i=0; i<size(); i++)
+        (*this)[i] += e[i];
+      return asImp();
+    }
+
+    //! vector space subtraction of a lazily evaluated expression
+    template <class E>
+      requires Impl::IsDenseVectorExpression<E>
+    constexpr derived_type& operator-= (const E& e)
+    {
+      DUNE_ASSERT_BOUNDS(e.size() == size());
+      for (size_type i=0; i<size(); i++)
+        (*this)[i] -= e[i];
+      return asImp();
+    }
+
     //! Binary vector addition
     template <class Other>
     constexpr derived_type operator+ (const DenseVector<Other>& b) const
@@ -595,6 +640,26 @@ namespace Dune {
       return asImp();
     }
 
+    //! vector space axpy operation with a lazily evaluated expression ( *this += a e )
+    template <class E>
+      requires Impl::IsDenseVectorExpression<E>
+    constexpr derived_type& axpy (const field_type& a, const E& e)
+    {
+      DUNE_ASSERT_BOUNDS(e.size() == size());
+      for (size_type i=0; i<size(); i++)
+        (*this)[i] += a*e[i];
+      return asImp();
+    }
+
+  private:
+    // whether V and W store the same floating-point type contiguously, see densevectorreduction.hh
+    template<class W>
+    static constexpr bool contiguousReduction =
+      std::is_same_v<value_type, typename DenseMatVecTraits<W>::value_type>
+      && Impl::DenseVectorContiguousReduction<V, value_type>
+      && Impl::DenseVectorContiguousReduction<W, value_type>;
+
+  public:
     /**
      * \brief indefinite vector dot product \f$\left (x^T \cdot y \right)\f$ which corresponds to Petsc's VecTDot
      *
@@ -605,8 +670,11 @@ namespace Dune {
     template<class Other>
     constexpr typename PromotionTraits<field_type,typename DenseVector<Other>::field_type>::PromotedType operator* (const DenseVector<Other>& x) const {
       typedef typename PromotionTraits<field_type, typename DenseVector<Other>::field_type>::PromotedType PromotedType;
-      PromotedType result(0);
       assert(x.size() == size());
+      if constexpr (contiguousReduction<Other>)
+        if (not std::is_constant_evaluated())
+          return Impl::denseVectorDot(asImp().data(), static_cast<const Other&>(x).data(), size());
+      PromotedType result(0);
       for (size_type i=0; i<size(); i++) {
         result += PromotedType((*this)[i]*x[i]);
       }
@@ -623,8 +691,11 @@ namespace Dune {
     template<class Other>
     constexpr typename PromotionTraits<field_type,typename DenseVector<Other>::field_type>::PromotedType dot(const DenseVector<Other>& x) const {
       typedef typename PromotionTraits<field_type, typename DenseVector<Other>::field_type>::PromotedType PromotedType;
-      PromotedType result(0);
       assert(x.size() == size());
+      if constexpr (contiguousReduction<Other>)
+        if (not std::is_constant_evaluated())
+          return Impl::denseVectorDot(asImp().data(), static_cast<const Other&>(x).data(), size());
+      PromotedType result(0);
       for (size_type i=0; i<size(); i++) {
         result += Dune::dot((*this)[i],x[i]);
       }
@@ -636,6 +707,9 @@ namespace Dune {
     //! one norm (sum over absolute values of entries)
     constexpr typename FieldTraits<value_type>::real_type one_norm() const {
       using std::abs;
+      if constexpr (contiguousReduction<V>)
+        if (not std::is_constant_evaluated())
+          return Impl::denseVectorOneNorm(asImp().data(), size());
       typename FieldTraits<value_type>::real_type result( 0 );
       for (size_type i=0; i<size(); i++)
         result += abs((*this)[i]);
@@ -646,6 +720,9 @@ namespace Dune {
     //! simplified one norm (uses Manhattan norm for complex values)
     constexpr typename FieldTraits<value_type>::real_type one_norm_real () const
     {
+      if constexpr (contiguousReduction<V>)
+        if (not std::is_constant_evaluated())
+          return Impl::denseVectorOneNorm(asImp().data(), size());
       typename FieldTraits<value_type>::real_type result( 0 );
       for (size_type i=0; i<size(); i++)
         result += fvmeta::absreal((*this)[i]);
@@ -655,15 +732,15 @@ namespace Dune {
     //! two norm sqrt(sum over squared values of entries)
     constexpr typename FieldTraits<value_type>::real_type two_norm () const
     {
-      typename FieldTraits<value_type>::real_type result( 0 );
-      for (size_type i=0; i<size(); i++)
-        result += fvmeta::abs2((*this)[i]);
-      return fvmeta::sqrt(result);
+      return fvmeta::sqrt(two_norm2());
     }
 
     //! square of two norm (sum over squared values of entries), need for block recursion
     constexpr typename FieldTraits<value_type>::real_type two_norm2 () const
     {
+      if constexpr (contiguousReduction<V>)
+        if (not std::is_constant_evaluated())
+          return Impl::denseVectorTwoNorm2(asImp().data(), size());
       typename FieldTraits<value_type>::real_type result( 0 );
       for (size_type i=0; i<size(); i++)
         result += fvmeta::abs2((*this)[i]);
@@ -706,6 +783,9 @@ namespace Dune {
               typename std::enable_if<HasNaN<vt>::value, int>::type = 0>
     constexpr typename FieldTraits<vt>::real_type infinity_norm() const {
       using real_type = typename FieldTraits<vt>::real_type;
+      if constexpr (contiguousReduction<V>)
+        if (not std::is_constant_evaluated())
+          return Impl::denseVectorInfinityNorm(asImp().data(), size());
       using std::abs;
       using std::max;
 
@@ -724,6 +804,9 @@ namespace Dune {
               typename std::enable_if<HasNaN<vt>::value, int>::type = 0>
     constexpr typename FieldTraits<vt>::real_type infinity_norm_real() const {
       using real_type = typename FieldTraits<vt>::real_type;
+      if constexpr (contiguousReduction<V>)
+        if (not std::is_constant_evaluated())
+          return Impl::denseVectorInfinityNorm(asImp().data(), size());
       using std::max;
 
       real_type norm = 0;
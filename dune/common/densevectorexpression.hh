@@ -0,0 +1,242 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_DENSEVECTOREXPRESSION_HH
+#define DUNE_COMMON_DENSEVECTOREXPRESSION_HH
+
+/** \file
+ * \brief Opt-in expression templates for DenseVector arithmetic
+ *
+ * The arithmetic operators of DenseVector evaluate eagerly and create a
+ * temporary vector for every sub-expression.  Wrapping the operands with
+ * Dune::lazy() instead builds a light-weight expression object that is
+ * evaluated element by element in a single loop once it is assigned to a
+ * vector:
+ * \code
+ * DynamicVector<double> a(n), b(n), c(n), d(n);
+ * a = lazy(b) + alpha*lazy(c) - d;      // one loop, no temporaries
+ * a.axpy(beta, lazy(c) - lazy(d));      // a += beta*(c-d)
+ * \endcode
+ *
+ * Expressions can be assigned to any DenseVector, added to or subtracted
+ * from it, passed to DenseVector::axpy(), and used to construct DynamicVector
+ * and FieldVector objects.  They are evaluated element-wise, hence the target
+ * may also appear as an operand.
+ *
+ * \note An expression stores references to the vectors wrapped by lazy().
+ *       It must not outlive them, so avoid storing it in an \c auto variable
+ *       beyond the statement that uses it.
+ */
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include <dune/common/boundschecking.hh>
+#include <dune/common/densevector.hh>
+#include <dune/common/ftraits.hh>
+#include <dune/common/typetraits.hh>
+
+namespace Dune {
+
+  /** @addtogroup DenseMatVec
+      @{
+   */
+
+  /** \brief CRTP base class of all lazily evaluated vector expressions
+   *
+   * \tparam E  the expression type, providing size() and an element access
+   *            operator[] that returns by value
+   */
+  template<class E>
+  class DenseVectorExpression
+  {
+  public:
+    constexpr const E& asImp () const { return static_cast<const E&>(*this); }
+
+    constexpr std::size_t size () const { return asImp().size(); }
+
+    constexpr decltype(auto) operator[] (std::size_t i) const { return asImp()[i]; }
+  };
+
+  namespace Impl {
+
+    // leaf of an expression tree, refers to an existing DenseVector
+    template<class V>
+    class DenseVectorTerminal
+      : public DenseVectorExpression<DenseVectorTerminal<V>>
+    {
+    public:
+      using value_type = typename DenseVector<V>::value_type;
+
+      constexpr explicit DenseVectorTerminal (const DenseVector<V>& v) : v_(&v) {}
+
+      constexpr std::size_t size () const { return v_->size(); }
+
+      constexpr const value_type& operator[] (std::size_t i) const { return (*v_)[i]; }
+
+    private:
+      const DenseVector<V>* v_;
+    };
+
+    // element-wise binary operation of two expressions of equal size
+    template<class Op, class L, class R>
+    class DenseVectorBinary
+      : public DenseVectorExpression<DenseVectorBinary<Op,L,R>>
+    {
+    public:
+      using value_type = std::decay_t<decltype(Op{}(std::declval<const L&>()[0], std::declval<const R&>()[0]))>;
+
+      constexpr DenseVectorBinary (const L& l, const R& r)
+        : l_(l), r_(r)
+      {
+        DUNE_ASSERT_BOUNDS(l_.size() == r_.size());
+      }
+
+      constexpr std::size_t size () const { return l_.size(); }
+
+      constexpr value_type operator[] (std::size_t i) const { return Op{}(l_[i], r_[i]); }
+
+    private:
+      L l_;
+      R r_;
+    };
+
+    // multiplication (from the left or the right) or division by a scalar
+    template<class Op, class S, class E, bool scalarLeft>
+    class DenseVectorScaled
+      : public DenseVectorExpression<DenseVectorScaled<Op,S,E,scalarLeft>>
+    {
+      static constexpr decltype(auto) apply (const S& s, const auto& x)
+      {
+        if constexpr (scalarLeft)
+          return Op{}(s, x);
+        else
+          return Op{}(x, s);
+      }
+
+    public:
+      using value_type = std::decay_t<decltype(apply(std::declval<const S&>(), std::declval<const E&>()[0]))>;
+
+      constexpr DenseVectorScaled (const S& s, const E& e) : s_(s), e_(e) {}
+
+      constexpr std::size_t size () const { return e_.size(); }
+
+      constexpr value_type operator[] (std::size_t i) const { return apply(s_, e_[i]); }
+
+    private:
+      S s_;
+      E e_;
+    };
+
+    template<class E>
+    class DenseVectorNegated
+      : public DenseVectorExpression<DenseVectorNegated<E>>
+    {
+    public:
+      using value_type = std::decay_t<decltype(-std::declval<const E&>()[0])>;
+
+      constexpr explicit DenseVectorNegated (const E& e) : e_(e) {}
+
+      constexpr std::size_t size () const { return e_.size(); }
+
+      constexpr value_type operator[] (std::size_t i) const { return -e_[i]; }
+
+    private:
+      E e_;
+    };
+
+    // turn an operand of a mixed expression into an expression
+    template<class E>
+    constexpr const E& asExpression (const DenseVectorExpression<E>& e)
+    {
+      return e.asImp();
+    }
+
+    template<class V>
+    constexpr DenseVectorTerminal<V> asExpression (const DenseVector<V>& v)
+    {
+      return DenseVectorTerminal<V>(v);
+    }
+
+    template<class T>
+    using AsExpression = std::decay_t<decltype(asExpression(std::declval<const T&>()))>;
+
+    template<class T>
+    concept DenseVectorOperand = requires(const T& t) { asExpression(t); };
+
+    // at least one operand must be an expression, the other may be a DenseVector
+    template<class A, class B>
+    concept DenseVectorExpressionOperands =
+      (IsDenseVectorExpression<A> || IsDenseVectorExpression<B>)
+      && DenseVectorOperand<A> && DenseVectorOperand<B>;
+
+    // scalar factors of an expression
+    template<class S>
+    concept DenseVectorExpressionScalar = IsNumber<S>::value;
+
+  } // end namespace Impl
+
+  /** \brief Wrap a DenseVector to take part in lazily evaluated expressions
+   *
+   * \relates DenseVectorExpression
+   */
+  template<class V>
+  constexpr Impl::DenseVectorTerminal<V> lazy (const DenseVector<V>& v)
+  {
+    return Impl::DenseVectorTerminal<V>(v);
+  }
+
+  //! Element-wise sum of two expressions, or of an expression and a DenseVector
+  template<class A, class B>
+    requires Impl::DenseVectorExpressionOperands<A,B>
+  constexpr auto operator+ (const A& a, const B& b)
+  {
+    return Impl::DenseVectorBinary<std::plus<>, Impl::AsExpression<A>, Impl::AsExpression<B>>(
+      Impl::asExpression(a), Impl::asExpression(b));
+  }
+
+  //! Element-wise difference of two expressions, or of an expression and a DenseVector
+  template<class A, class B>
+    requires Impl::DenseVectorExpressionOperands<A,B>
+  constexpr auto operator- (const A& a, const B& b)
+  {
+    return Impl::DenseVectorBinary<std::minus<>, Impl::AsExpression<A>, Impl::AsExpression<B>>(
+      Impl::asExpression(a), Impl::asExpression(b));
+  }
+
+  //! Negation of an expression
+  template<class E>
+  constexpr auto operator- (const DenseVectorExpression<E>& e)
+  {
+    return Impl::DenseVectorNegated<E>(e.asImp());
+  }
+
+  //! Multiplication of an expression with a scalar from the left
+  template<Impl::DenseVectorExpressionScalar S, class E>
+  constexpr auto operator* (const S& s, const DenseVectorExpression<E>& e)
+  {
+    return Impl::DenseVectorScaled<std::multiplies<>, S, E, true>(s, e.asImp());
+  }
+
+  //! Multiplication of an expression with a scalar from the right
+  template<class E, Impl::DenseVectorExpressionScalar S>
+  constexpr auto operator* (const DenseVectorExpression<E>& e, const S& s)
+  {
+    return Impl::DenseVectorScaled<std::multiplies<>, S, E, false>(s, e.asImp());
+  }
+
+  //! Division of an expression by a scalar
+  template<class E, Impl::DenseVectorExpressionScalar S>
+  constexpr auto operator/ (const DenseVectorExpression<E>& e, const S& s)
+  {
+    return Impl::DenseVectorScaled<std::divides<>, S, E, false>(s, e.asImp());
+  }
+
+  /** @} end documentation */
+
+} // end namespace Dune
+
+#endif // DUNE_COMMON_DENSEVECTOREXPRESSION_HH
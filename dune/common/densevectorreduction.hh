@@ -0,0 +1,243 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_DENSEVECTORREDUCTION_HH
+#define DUNE_COMMON_DENSEVECTORREDUCTION_HH
+
+/** \file
+ * \brief Vectorized reduction kernels for DenseVector objects with contiguous storage
+ *
+ * DenseVector::dot(), operator*, one_norm(), two_norm(), two_norm2() and
+ * infinity_norm() use these kernels for vectors of \c float, \c double or
+ * <tt>long double</tt> entries that expose their storage through
+ * <tt>data()</tt>, e.g. DynamicVector and FieldVector.  The entries are
+ * distributed onto a fixed number of independent partial results, which the
+ * compiler keeps in vector registers.  Since this distribution only depends
+ * on the size of the vector, the results are reproducible from run to run,
+ * but may differ in the last bits from a sequential loop.
+ *
+ * The infinity norm gives the same result as the generic implementation: it
+ * is NaN if an entry is NaN or infinite, or if the sum of the absolute values
+ * overflows.  That sum is only computed if the maximum is large enough for
+ * this to happen.
+ */
+
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+/** \brief Use compensated summation in the vectorized DenseVector reductions
+ *
+ * If this macro is defined to 1 before including any DUNE header, each partial
+ * sum of DenseVector::dot(), one_norm(), two_norm() and two_norm2() is
+ * accumulated with Kahan summation, and the partial sums are combined
+ * likewise.  This makes the rounding error of long sums independent of the
+ * vector size, at roughly twice the cost for vectors that fit into the cache.
+ */
+#ifndef DUNE_DENSEVECTOR_COMPENSATED_SUMMATION
+#define DUNE_DENSEVECTOR_COMPENSATED_SUMMATION 0
+#endif
+
+namespace Dune {
+
+  namespace Impl {
+
+    //! Whether the entries of V are stored contiguously and can be reduced by the kernels below
+    template<class V, class K>
+    concept DenseVectorContiguousReduction = std::is_floating_point_v<K> &&
+      requires(const V& v) { { v.data() } -> std::convertible_to<const K*>; };
+
+    // Number of independent partial results: four vector registers of
+    // 32 bytes, which hides the latency of the additions with AVX and
+    // leaves enough registers with plain SSE2.
+    template<class K>
+    inline constexpr std::size_t denseVectorReductionLanes = 4 * 32 / sizeof(K);
+
+    // Kahan summation: add value to sum, carry holds the negated rounding error
+    template<class K>
+    inline void denseVectorKahanAdd (K& sum, K& carry, const K& value)
+    {
+      const K y = value - carry;
+      const K t = sum + y;
+      carry = (t - sum) - y;
+      sum = t;
+    }
+
+    //! sum of term(i) for 0 <= i < n in the order of the indices
+    template<bool compensated, class K, class Term>
+    inline K denseVectorSequentialSum (std::size_t n, const Term& term)
+    {
+      K result = 0;
+      K carry = 0;
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        if constexpr (compensated)
+          denseVectorKahanAdd(result, carry, term(i));
+        else
+          result += term(i);
+      }
+      return result;
+    }
+
+    /* sum of term(i) for 0 <= i < n, computed in independent lanes
+     *
+     * The lanes take whole blocks, the remainder is added to their total.
+     * Kept out of line and with the term passed by value: once inlined into
+     * the DenseVector methods, or with the captured pointers behind a
+     * reference, GCC vectorizes across the blocks instead and keeps the
+     * lanes in memory, which is several times slower.
+     */
+    template<bool compensated, class K, class Term>
+    [[gnu::noinline]] K denseVectorLaneSum (std::size_t n, Term term)
+    {
+      constexpr std::size_t lanes = denseVectorReductionLanes<K>;
+      K sum[lanes] = {};
+      std::size_t i = 0;
+
+      if constexpr (compensated)
+      {
+        K carry[lanes] = {};
+        for (; i + lanes <= n; i += lanes)
+          for (std::size_t j = 0; j < lanes; ++j)
+            denseVectorKahanAdd(sum[j], carry[j], term(i+j));
+
+        K result = 0;
+        K resultCarry = 0;
+        for (std::size_t j = 0; j < lanes; ++j)
+        {
+          denseVectorKahanAdd(result, resultCarry, sum[j]);
+          denseVectorKahanAdd(result, resultCarry, -carry[j]);
+        }
+        for (; i < n; ++i)
+          denseVectorKahanAdd(result, resultCarry, term(i));
+        return result;
+      }
+      else
+      {
+        for (; i + lanes <= n; i += lanes)
+          for (std::size_t j = 0; j < lanes; ++j)
+            sum[j] += term(i+j);
+
+        K result = 0;
+        for (std::size_t j = 0; j < lanes; ++j)
+          result += sum[j];
+        for (; i < n; ++i)
+          result += term(i);
+        return result;
+      }
+    }
+
+    // Short vectors are summed inline.  This gives the same result as the
+    // lane kernel, whose lanes would all be zero.
+    template<class K, class Term>
+    inline K denseVectorSum (std::size_t n, const Term& term)
+    {
+      constexpr bool compensated = DUNE_DENSEVECTOR_COMPENSATED_SUMMATION;
+      if (n < denseVectorReductionLanes<K>)
+        return denseVectorSequentialSum<compensated, K>(n, term);
+      return denseVectorLaneSum<compensated, K>(n, term);
+    }
+
+    template<class K>
+    inline K denseVectorDot (const K* x, const K* y, std::size_t n)
+    {
+      return denseVectorSum<K>(n, [x,y](std::size_t i) { return x[i]*y[i]; });
+    }
+
+    template<class K>
+    inline K denseVectorOneNorm (const K* x, std::size_t n)
+    {
+      return denseVectorSum<K>(n, [x](std::size_t i) { return std::abs(x[i]); });
+    }
+
+    template<class K>
+    inline K denseVectorTwoNorm2 (const K* x, std::size_t n)
+    {
+      return denseVectorSum<K>(n, [x](std::size_t i) { return x[i]*x[i]; });
+    }
+
+    // Signed integer type with the size of K if K is an IEEE type.  Without
+    // the sign bit, the order of the bit patterns of such numbers is the
+    // order of their values, and NaN patterns are larger than infinity.
+    template<class K>
+    using DenseVectorAbsBits =
+      std::conditional_t<std::numeric_limits<K>::is_iec559 && sizeof(K) == sizeof(std::int32_t), std::int32_t,
+      std::conditional_t<std::numeric_limits<K>::is_iec559 && sizeof(K) == sizeof(std::int64_t), std::int64_t,
+      void>>;
+
+    template<class K>
+    [[gnu::noinline]] K denseVectorLaneMaxAbs (const K* x, std::size_t n)
+    {
+      using Bits = DenseVectorAbsBits<K>;
+      constexpr Bits noSign = std::numeric_limits<Bits>::max();
+      constexpr std::size_t lanes = denseVectorReductionLanes<K>;
+      Bits norm[lanes] = {};
+
+      std::size_t i = 0;
+      for (; i + lanes <= n; i += lanes)
+        for (std::size_t j = 0; j < lanes; ++j)
+        {
+          const Bits a = std::bit_cast<Bits>(x[i+j]) & noSign;
+          norm[j] = (a > norm[j]) ? a : norm[j];
+        }
+
+      Bits result = 0;
+      for (std::size_t j = 0; j < lanes; ++j)
+        result = (norm[j] > result) ? norm[j] : result;
+      for (; i < n; ++i)
+      {
+        const Bits a = std::bit_cast<Bits>(x[i]) & noSign;
+        result = (a > result) ? a : result;
+      }
+      return std::bit_cast<K>(result);
+    }
+
+    //! maximum of the absolute values, NaN if any entry is NaN
+    template<class K>
+    inline K denseVectorMaxAbs (const K* x, std::size_t n)
+    {
+      if constexpr (not std::is_void_v<DenseVectorAbsBits<K>>)
+        if (n >= denseVectorReductionLanes<K>)
+          return denseVectorLaneMaxAbs(x, n);
+
+      K result = 0;
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        const K a = std::abs(x[i]);
+        if (a > result || std::isnan(a))
+          result = a;
+      }
+      return result;
+    }
+
+    /* maximum of the absolute values, as DenseVector::infinity_norm()
+     *
+     * The generic implementation multiplies the maximum by s/s with
+     * s = 1 + |x_0| + ... + |x_{n-1}|, which is NaN if an entry is NaN or
+     * infinite or if s overflows.  s is bounded by 1 + n max, so it only
+     * needs to be computed if the maximum is large, with some headroom for
+     * the rounding errors of the sum.
+     */
+    template<class K>
+    inline K denseVectorInfinityNorm (const K* x, std::size_t n)
+    {
+      const K norm = denseVectorMaxAbs(x, n);
+      if (norm <= std::numeric_limits<K>::max() / (K(4) * K(n+1)))
+        return norm;
+
+      K isNaN = 1;
+      for (std::size_t i = 0; i < n; ++i)
+        isNaN += std::abs(x[i]);
+      return norm * (isNaN / isNaN);
+    }
+
+  } // end namespace Impl
+
+} // end namespace Dune
+
+#endif // DUNE_COMMON_DENSEVECTORREDUCTION_HH
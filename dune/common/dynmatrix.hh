@@ -9,9 +9,11 @@
 #include <cstddef>
 #include <iostream>
 #include <initializer_list>
+#include <type_traits>
 
 #include <dune/common/boundschecking.hh>
 #include <dune/common/exceptions.hh>
+#include <dune/common/denseblas.hh>
 #include <dune/common/dynvector.hh>
 #include <dune/common/densematrix.hh>
 #include <dune/common/typetraits.hh>
@@ -138,6 +140,76 @@ namespace Dune
       return AT;
     }
 
+    //===== BLAS/LAPACK dispatch
+    // For float, double and complex entries and matrices with at least
+    // DenseBlas::threshold() rows and columns, the following methods use
+    // BLAS/LAPACK if available (see dune/common/denseblas.hh).  LAPACK always
+    // pivots, hence it is only used when doPivoting is set.
+
+    /** \brief Solve system A x = b
+     *
+     * \exception FMatrixError if the matrix is singular
+     */
+    template <class V1, class V2>
+    void solve (V1& x, const V2& b, bool doPivoting = true) const
+    {
+      if constexpr (DenseBlas::isBlasField<K>)
+        if (doPivoting && DenseBlas::useLapack<K>(this->N(), this->M()))
+          return DenseBlas::solve(*this, x, b);
+      Base::solve(x, b, doPivoting);
+    }
+
+    /** \brief Compute inverse
+     *
+     * \exception FMatrixError if the matrix is singular
+     */
+    void invert (bool doPivoting = true)
+    {
+      if constexpr (DenseBlas::isBlasField<K>)
+        if (doPivoting && DenseBlas::useLapack<K>(this->N(), this->M()))
+          return DenseBlas::invert(*this);
+      Base::invert(doPivoting);
+    }
+
+    //! calculates the determinant of this matrix
+    value_type determinant (bool doPivoting = true) const
+    {
+      if constexpr (DenseBlas::isBlasField<K>)
+        if (doPivoting && DenseBlas::useLapack<K>(this->N(), this->M()))
+          return DenseBlas::determinant(*this);
+      return Base::determinant(doPivoting);
+    }
+
+    //! Multiplies M from the left to this matrix
+    template<typename M2>
+    DynamicMatrix& leftmultiply (const DenseMatrix<M2>& M)
+    {
+      if constexpr (std::is_same_v<typename DenseMatrix<M2>::value_type, K> && DenseBlas::isBlasField<K>)
+        if (DenseBlas::useBlas<K>(this->N(), this->M()))
+        {
+          DUNE_ASSERT_BOUNDS(M.rows() == M.cols());
+          DUNE_ASSERT_BOUNDS(M.rows() == this->rows());
+          DenseBlas::multiply(M, *this, *this);
+          return *this;
+        }
+      return Base::leftmultiply(M);
+    }
+
+    //! Multiplies M from the right to this matrix
+    template<typename M2>
+    DynamicMatrix& rightmultiply (const DenseMatrix<M2>& M)
+    {
+      if constexpr (std::is_same_v<typename DenseMatrix<M2>::value_type, K> && DenseBlas::isBlasField<K>)
+        if (DenseBlas::useBlas<K>(this->N(), this->M()))
+        {
+          DUNE_ASSERT_BOUNDS(M.rows() == M.cols());
+          DUNE_ASSERT_BOUNDS(M.cols() == this->cols());
+          DenseBlas::multiply(*this, M, *this);
+          return *this;
+        }
+      return Base::rightmultiply(M);
+    }
+
     // make this thing a matrix
     size_type mat_rows() const { return _data.size(); }
     size_type mat_cols() const {
@@ -6,10 +6,16 @@
 #define DUNE_DYNMATRIXEIGENVALUES_HH
 
 #include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <limits>
 #include <memory>
+#include <type_traits>
+#include <vector>
 
 #include <dune-common-config.hh>  // HAVE_LAPACK
 
+#include "denseblas.hh"
 #include "dynmatrix.hh"
 #include "fmatrixev.hh"
 
@@ -36,6 +42,7 @@ namespace Dune {
         \param[out] eigenVectors (optional) list of right eigenvectors
 
         \note LAPACK::dgeev is used to calculate the eigen values
+        \see NonSymmetricEigenSolver for repeated calls without reallocation
      */
     template <typename K, class C>
     static void eigenValuesNonSym(const DynamicMatrix<K>& matrix,
@@ -103,6 +110,272 @@ namespace Dune {
       DUNE_THROW(NotImplemented,"LAPACK not found!");
 #endif
     }
+
+    /** \brief Eigenvalue solver for symmetric matrices of a fixed size that reuses its workspace
+
+        The solver owns the buffers needed by LAPACK's xSYEVR.  The optimal
+        workspace size is queried once per matrix size, so repeated calls with
+        matrices of the same size do not allocate memory, provided the output
+        containers are reused as well.  Besides the full spectrum, a subset of
+        the eigenpairs can be requested by index or by value, which is cheaper
+        than computing all of them.
+
+        \tparam K  field type, either float or double
+
+        \note Only the lower triangle of the matrix is referenced, the entries
+              above the diagonal are ignored.
+     */
+    template<class K>
+    class SymmetricEigenSolver
+    {
+      static_assert(std::is_same_v<K, float> || std::is_same_v<K, double>,
+                    "SymmetricEigenSolver is only implemented for float and double");
+
+    public:
+      //! Create a solver for n x n matrices
+      explicit SymmetricEigenSolver (std::size_t n = 0)
+      {
+        resize(n);
+      }
+
+      //! Size of the matrices the workspace is prepared for
+      std::size_t size () const
+      {
+        return n_;
+      }
+
+      //! Prepare the workspace for n x n matrices, this is a no-op for the current size
+      void resize (std::size_t n)
+      {
+        if (n == queriedSize_)
+          return;
+        n_ = n;
+        a_.resize(n*n);
+        w_.resize(n);
+        z_.resize(n*n);
+        isuppz_.resize(2*n);
+#if HAVE_LAPACK
+        // workspace query for the most demanding case, i.e. all eigenvectors
+        K workQuery = 0;
+        int iworkQuery = 0, m = 0, info = 0;
+        DenseBlas::syevr('V', 'A', 'U', int(n), a_.data(), lda(), K(0), K(0), 0, 0, K(0),
+                         &m, w_.data(), z_.data(), lda(), isuppz_.data(),
+                         &workQuery, -1, &iworkQuery, -1, &info);
+        work_.resize(std::max<std::size_t>(workQuery, std::max<std::size_t>(26*n, 1)));
+        iwork_.resize(std::max<std::size_t>(iworkQuery, std::max<std::size_t>(10*n, 1)));
+#endif
+        queriedSize_ = n;
+      }
+
+      /** \brief Compute all eigenvalues in ascending order and, optionally, the eigenvectors
+
+          \param[in]  matrix        symmetric matrix, resizes the workspace if necessary
+          \param[out] eigenValues   eigenvalues in ascending order
+          \param[out] eigenVectors  (optional) orthonormal eigenvectors, one per eigenvalue
+       */
+      void compute (const DynamicMatrix<K>& matrix, DynamicVector<K>& eigenValues,
+                    std::vector<DynamicVector<K>>* eigenVectors = nullptr)
+      {
+        run(matrix, 'A', K(0), K(0), 0, 0, eigenValues, eigenVectors);
+      }
+
+      /** \brief Compute the eigenvalues with indices in [first, last) of the ascending spectrum
+
+          Only last-first eigenpairs are computed.
+       */
+      void computeIndexRange (const DynamicMatrix<K>& matrix, std::size_t first, std::size_t last,
+                              DynamicVector<K>& eigenValues,
+                              std::vector<DynamicVector<K>>* eigenVectors = nullptr)
+      {
+        if (first > last || last > matrix.N())
+          DUNE_THROW(RangeError, "SymmetricEigenSolver: invalid index range ["
+                     << first << ", " << last << ") for a matrix of size " << matrix.N());
+        if (first == last)
+        {
+          eigenValues.resize(0);
+          if (eigenVectors)
+            eigenVectors->resize(0);
+          return;
+        }
+        // LAPACK counts from 1 and includes the upper bound
+        run(matrix, 'I', K(0), K(0), int(first) + 1, int(last), eigenValues, eigenVectors);
+      }
+
+      /** \brief Compute the eigenvalues in the half-open interval (lower, upper]
+
+          The number of eigenpairs found is given by eigenValues.size() afterwards.
+       */
+      void computeValueRange (const DynamicMatrix<K>& matrix, K lower, K upper,
+                              DynamicVector<K>& eigenValues,
+                              std::vector<DynamicVector<K>>* eigenVectors = nullptr)
+      {
+        if (!(lower < upper))
+          DUNE_THROW(RangeError, "SymmetricEigenSolver: empty value range ("
+                     << lower << ", " << upper << "]");
+        run(matrix, 'V', lower, upper, 0, 0, eigenValues, eigenVectors);
+      }
+
+    private:
+      int lda () const
+      {
+        return std::max(int(n_), 1);
+      }
+
+      void run (const DynamicMatrix<K>& matrix, char range, K vl, K vu, int il, int iu,
+                DynamicVector<K>& eigenValues, std::vector<DynamicVector<K>>* eigenVectors)
+      {
+#if HAVE_LAPACK
+        if (matrix.N() != matrix.M())
+          DUNE_THROW(RangeError, "SymmetricEigenSolver: matrix is not square");
+        resize(matrix.N());
+        const int n = n_;
+
+        // LAPACK sees the row-major copy transposed, so the lower triangle of
+        // the matrix is the upper triangle of the column-major buffer
+        for (int i = 0; i < n; ++i)
+          std::copy_n(matrix[i].begin(), n, a_.begin() + i*n);
+
+        int m = 0, info = 0;
+        DenseBlas::syevr(eigenVectors ? 'V' : 'N', range, 'U', n, a_.data(), lda(),
+                         vl, vu, il, iu, K(0), &m, w_.data(), z_.data(), lda(),
+                         isuppz_.data(), work_.data(), int(work_.size()),
+                         iwork_.data(), int(iwork_.size()), &info);
+        if (info != 0)
+          DUNE_THROW(InvalidStateException, "SymmetricEigenSolver: xSYEVR failed with info = " << info);
+
+        eigenValues.resize(m);
+        std::copy_n(w_.begin(), m, eigenValues.begin());
+        if (eigenVectors)
+        {
+          eigenVectors->resize(m);
+          for (int j = 0; j < m; ++j)
+          {
+            auto& v = (*eigenVectors)[j];
+            v.resize(n);
+            std::copy_n(z_.begin() + j*n, n, v.begin());
+          }
+        }
+#else
+        DUNE_THROW(NotImplemented, "LAPACK not found!");
+#endif
+      }
+
+      std::size_t n_ = 0;
+      // size of the last workspace query, none has been done initially
+      std::size_t queriedSize_ = std::numeric_limits<std::size_t>::max();
+      std::vector<K> a_, w_, z_, work_;
+      std::vector<int> iwork_, isuppz_;
+    };
+
+    /** \brief Eigenvalue solver for nonsymmetric matrices of a fixed size that reuses its workspace
+
+        The solver owns the buffers needed by LAPACK's xGEEV and queries the
+        optimal workspace size once per matrix size.  Repeated calls with
+        matrices of the same size and reused output containers do not allocate.
+
+        Eigenvectors are stored as returned by LAPACK: for a complex conjugate
+        pair of eigenvalues with indices j and j+1, the vectors j and j+1 hold the
+        real and the imaginary part of the eigenvector belonging to eigenvalue j.
+
+        \tparam K  field type, either float or double
+     */
+    template<class K>
+    class NonSymmetricEigenSolver
+    {
+      static_assert(std::is_same_v<K, float> || std::is_same_v<K, double>,
+                    "NonSymmetricEigenSolver is only implemented for float and double");
+
+    public:
+      //! Create a solver for n x n matrices
+      explicit NonSymmetricEigenSolver (std::size_t n = 0)
+      {
+        resize(n);
+      }
+
+      //! Size of the matrices the workspace is prepared for
+      std::size_t size () const
+      {
+        return n_;
+      }
+
+      //! Prepare the workspace for n x n matrices, this is a no-op for the current size
+      void resize (std::size_t n)
+      {
+        if (n == queriedSize_)
+          return;
+        n_ = n;
+        a_.resize(n*n);
+        wr_.resize(n);
+        wi_.resize(n);
+        vr_.resize(n*n);
+#if HAVE_LAPACK
+        // workspace query for the most demanding case, i.e. with right eigenvectors
+        K workQuery = 0;
+        int info = 0;
+        DenseBlas::geev('N', 'V', int(n), a_.data(), lda(), wr_.data(), wi_.data(),
+                        nullptr, 1, vr_.data(), lda(), &workQuery, -1, &info);
+        work_.resize(std::max<std::size_t>(workQuery, std::max<std::size_t>(4*n, 1)));
+#endif
+        queriedSize_ = n;
+      }
+
+      /** \brief Compute the eigenvalues and, optionally, the right eigenvectors
+
+          \param[in]  matrix        square matrix, resizes the workspace if necessary
+          \param[out] eigenValues   complex eigenvalues, conjugate pairs are consecutive
+          \param[out] eigenVectors  (optional) right eigenvectors in LAPACK's real storage scheme
+       */
+      template<class C>
+      void compute (const DynamicMatrix<K>& matrix, DynamicVector<C>& eigenValues,
+                    std::vector<DynamicVector<K>>* eigenVectors = nullptr)
+      {
+#if HAVE_LAPACK
+        if (matrix.N() != matrix.M())
+          DUNE_THROW(RangeError, "NonSymmetricEigenSolver: matrix is not square");
+        resize(matrix.N());
+        const int n = n_;
+
+        // LAPACK expects column-major storage
+        for (int i = 0; i < n; ++i)
+          for (int j = 0; j < n; ++j)
+            a_[j*n + i] = matrix[i][j];
+
+        int info = 0;
+        DenseBlas::geev('N', eigenVectors ? 'V' : 'N', n, a_.data(), lda(),
+                        wr_.data(), wi_.data(), nullptr, 1, vr_.data(), lda(),
+                        work_.data(), int(work_.size()), &info);
+        if (info != 0)
+          DUNE_THROW(InvalidStateException, "NonSymmetricEigenSolver: xGEEV failed with info = " << info);
+
+        eigenValues.resize(n);
+        for (int i = 0; i < n; ++i)
+          eigenValues[i] = C(std::complex<K>(wr_[i], wi_[i]));
+        if (eigenVectors)
+        {
+          eigenVectors->resize(n);
+          for (int j = 0; j < n; ++j)
+          {
+            auto& v = (*eigenVectors)[j];
+            v.resize(n);
+            std::copy_n(vr_.begin() + j*n, n, v.begin());
+          }
+        }
+#else
+        DUNE_THROW(NotImplemented, "LAPACK not found!");
+#endif
+      }
+
+    private:
+      int lda () const
+      {
+        return std::max(int(n_), 1);
+      }
+
+      std::size_t n_ = 0;
+      // size of the last workspace query, none has been done initially
+      std::size_t queriedSize_ = std::numeric_limits<std::size_t>::max();
+      std::vector<K> a_, wr_, wi_, vr_, work_;
+    };
   }
 
 }
@@ -113,6 +113,16 @@ namespace Dune {
         _data.push_back( x[ i ] );
     }
 
+    //! Construct from a lazily evaluated expression, see densevectorexpression.hh
+    template< class E >
+      requires Impl::IsDenseVectorExpression< E >
+    DynamicVector(const E & e, const allocator_type &a = allocator_type() ) :
+      _data(e.size(), value_type(), a)
+    {
+      for( size_type i = 0; i < _data.size(); ++i )
+        _data[ i ] = e[ i ];
+    }
+
     using Base::operator=;
 
     //! Copy assignment operator
@@ -0,0 +1,651 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_FLATLRU_HH
+#define DUNE_COMMON_FLATLRU_HH
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/iteratorfacades.hh>
+
+/** @file
+    @brief LRU cache containers using an open-addressing hash table
+ */
+
+namespace Dune {
+
+  /**
+      @brief Counters of the lookups in an LRU cache
+   */
+  struct LRUStatistics
+  {
+    //! The number of lookups that found their key
+    std::size_t hits = 0;
+    //! The number of lookups that did not find their key
+    std::size_t misses = 0;
+    //! The number of entries dropped to stay within the capacity
+    std::size_t evictions = 0;
+
+    LRUStatistics& operator+=(const LRUStatistics& other)
+    {
+      hits += other.hits;
+      misses += other.misses;
+      evictions += other.evictions;
+      return *this;
+    }
+  };
+
+  /**
+      @brief LRU Cache Container using a flat hash table
+
+      Provides the interface of lru, but the entries are stored in a
+      contiguous array, linked from the most to the least recently used
+      entry by indices. The keys are found by an open-addressing hash
+      table with linear probing, such that a hit costs a hash and usually
+      a single probe instead of a tree lookup.
+
+      If a capacity is given, inserting into a full container drops the
+      least recently used entry and the storage for all entries is
+      reserved at construction. Without a capacity, inserting may move
+      the entries and invalidates references and iterators.
+
+      find() counts hits and misses, and insert() counts the entries
+      evicted to stay within the capacity, see statistics().
+
+      @tparam Key The type of the keys.
+      @tparam Tp The type of the data.
+      @tparam Hash The hash function of the keys.
+      @tparam KeyEqual The comparison of the keys.
+   */
+  template <typename Key, typename Tp,
+      typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key> >
+  class FlatLRU
+  {
+    typedef std::uint32_t Index;
+
+    //! Marks the end of a list and empty slots of the hash table
+    static constexpr Index npos = Index(-1);
+
+    //! An entry linked into the list of entries or of free nodes
+    struct Node
+    {
+      std::optional<std::pair<Key, Tp> > value;
+      std::uint64_t hash;
+      Index prev;
+      Index next;
+    };
+
+    template<class C, class V>
+    class Iterator
+      : public BidirectionalIteratorFacade<Iterator<C,V>, V>
+    {
+    public:
+      Iterator() = default;
+
+      Iterator(C* container, Index node) :
+        _container(container), _node(node)
+      {}
+
+      //! Conversion of a mutable to a constant iterator
+      template<class C1, class V1,
+               std::enable_if_t<std::is_convertible_v<C1*, C*>, int> = 0>
+      Iterator(const Iterator<C1,V1>& other) :
+        _container(other._container), _node(other._node)
+      {}
+
+      V& dereference() const
+      {
+        return *_container->_nodes[_node].value;
+      }
+
+      template<class C1, class V1>
+      bool equals(const Iterator<C1,V1>& other) const
+      {
+        return _node == other._node;
+      }
+
+      void increment()
+      {
+        _node = _container->_nodes[_node].next;
+      }
+
+      void decrement()
+      {
+        _node = (_node == npos) ? _container->_tail : _container->_nodes[_node].prev;
+      }
+
+    private:
+      template<class, class> friend class Iterator;
+
+      C* _container = nullptr;
+      Index _node = npos;
+    };
+
+  public:
+    typedef Key key_type;
+    typedef Tp value_type;
+    using pointer = Tp*;
+    using const_pointer = const Tp*;
+    using const_reference = const Tp&;
+    using reference = Tp&;
+    typedef std::size_t size_type;
+    //! Iterator over the pairs of key and data, from the most to the least recently used
+    typedef Iterator<FlatLRU, std::pair<Key, Tp> > iterator;
+    //! Constant iterator over the pairs of key and data
+    typedef Iterator<const FlatLRU, const std::pair<Key, Tp> > const_iterator;
+
+    /**
+     * @brief Create a container.
+     * @param capacity The maximum number of entries, 0 for no limit.
+     */
+    explicit FlatLRU(size_type capacity = 0, const Hash& hash = Hash(),
+                     const KeyEqual& equal = KeyEqual()) :
+      _capacity(capacity), _hash(hash), _equal(equal)
+    {
+      if (capacity > 0) {
+        _nodes.reserve(capacity);
+        rehash(capacity);
+      }
+    }
+
+    iterator begin() { return iterator(this, _head); }
+    const_iterator begin() const { return const_iterator(this, _head); }
+    iterator end() { return iterator(this, npos); }
+    const_iterator end() const { return const_iterator(this, npos); }
+
+    /**
+     *  Returns a read/write reference to the data of the most
+     *  recently used entry.
+     */
+    reference front()
+    {
+      return _nodes[_head].value->second;
+    }
+
+    /**
+     *  Returns a read-only (constant) reference to the data of the
+     *  most recently used entry.
+     */
+    const_reference front() const
+    {
+      return _nodes[_head].value->second;
+    }
+
+    /**
+     *  Returns a read/write reference to the data of the least
+     *  recently used entry.
+     */
+    reference back()
+    {
+      return _nodes[_tail].value->second;
+    }
+
+    /**
+     *  Returns a read-only (constant) reference to the data of the
+     *  least recently used entry.
+     */
+    const_reference back() const
+    {
+      return _nodes[_tail].value->second;
+    }
+
+    /**
+     * @brief Removes the first element.
+     */
+    void pop_front()
+    {
+      erase(_head);
+    }
+
+    /**
+     * @brief Removes the last element.
+     */
+    void pop_back()
+    {
+      erase(_tail);
+    }
+
+    /**
+     * @brief Finds the element whose key is k.
+     *
+     * Counts a hit or a miss, but does not mark the element as most recent.
+     *
+     * @return iterator
+     */
+    iterator find (const key_type & key)
+    {
+      return iterator(this, lookup(key));
+    }
+
+    /**
+     * @brief Finds the element whose key is k.
+     *
+     * @return const_iterator
+     */
+    const_iterator find (const key_type & key) const
+    {
+      return const_iterator(this, lookup(key));
+    }
+
+    /**
+     * @brief Insert a value into the container
+     *
+     * Stores value under key and marks it as most recent. If this key
+     * is already present, the associated data is replaced. If the
+     * container is full, the least recently used entry is dropped.
+     *
+     * @param key   associated with data
+     * @param data  to store
+     *
+     * @return reference of stored data
+     */
+    reference insert (const key_type & key, const_reference data)
+    {
+      std::uint64_t hash = mix(_hash(key));
+      size_type slot = findSlot(key, hash);
+      if (slot != noSlot) {
+        Index node = _slots[slot];
+        _nodes[node].value->second = data;
+        moveToFront(node);
+        return _nodes[node].value->second;
+      }
+
+      if (_capacity > 0 && _size == _capacity) {
+        erase(_tail);
+        ++_statistics.evictions;
+      }
+      if (2*(_size+1) > _slots.size())
+        rehash(_size+1);
+
+      Index node;
+      if (_free != npos) {
+        node = _free;
+        _free = _nodes[node].next;
+        _nodes[node].value.emplace(key, data);
+        _nodes[node].hash = hash;
+      }
+      else {
+        node = Index(_nodes.size());
+        _nodes.push_back(Node{std::pair<Key, Tp>(key, data), hash, npos, npos});
+      }
+
+      slot = hash >> _shift;
+      while (_slots[slot] != npos)
+        slot = (slot + 1) & (_slots.size() - 1);
+      _slots[slot] = node;
+
+      linkFront(node);
+      ++_size;
+      return _nodes[node].value->second;
+    }
+
+    /**
+     * @copydoc touch
+     */
+    reference insert (const key_type & key)
+    {
+      return touch (key);
+    }
+
+    /**
+     * @brief mark data associated with key as most recent
+     *
+     * @return reference of stored data
+     */
+    reference touch (const key_type & key)
+    {
+      size_type slot = findSlot(key, mix(_hash(key)));
+      if (slot == noSlot)
+        DUNE_THROW(Dune::RangeError,
+          "Failed to touch key " << key << ", it is not in the lru container");
+      Index node = _slots[slot];
+      moveToFront(node);
+      return _nodes[node].value->second;
+    }
+
+    /**
+     * @brief Retrieve number of entries in the container
+     */
+    size_type size() const
+    {
+      return _size;
+    }
+
+    /**
+     * @brief Returns true if the container has no entries
+     */
+    bool empty() const
+    {
+      return _size == 0;
+    }
+
+    /**
+     * @brief The maximum number of entries, 0 if there is no limit
+     */
+    size_type capacity() const
+    {
+      return _capacity;
+    }
+
+    /**
+     * @brief ensure a maximum size of the container
+     *
+     * If new_size is smaller than size the oldest elements are
+     * dropped. Otherwise nothing happens. The dropped elements are
+     * not counted as evictions.
+     */
+    void resize(size_type new_size)
+    {
+      while (new_size < size())
+        pop_back();
+    }
+
+    /**
+     * @brief Removes all entries, but keeps the statistics
+     */
+    void clear()
+    {
+      _nodes.clear();
+      std::fill(_slots.begin(), _slots.end(), npos);
+      _head = _tail = _free = npos;
+      _size = 0;
+    }
+
+    /**
+     * @brief The counters of hits, misses and evictions
+     */
+    const LRUStatistics& statistics() const
+    {
+      return _statistics;
+    }
+
+    /**
+     * @brief Reset the counters of hits, misses and evictions
+     */
+    void resetStatistics()
+    {
+      _statistics = LRUStatistics();
+    }
+
+  private:
+    static constexpr size_type noSlot = size_type(-1);
+
+    //! Spread the bits of the hash, the slot is given by the highest bits
+    static std::uint64_t mix(std::size_t hash)
+    {
+      return std::uint64_t(hash) * 0x9E3779B97F4A7C15ull;
+    }
+
+    //! Return the slot of key, or noSlot
+    size_type findSlot(const key_type& key, std::uint64_t hash) const
+    {
+      if (_slots.empty())
+        return noSlot;
+      const size_type mask = _slots.size() - 1;
+      for (size_type slot = hash >> _shift; ; slot = (slot + 1) & mask) {
+        Index node = _slots[slot];
+        if (node == npos)
+          return noSlot;
+        if (_nodes[node].hash == hash && _equal(_nodes[node].value->first, key))
+          return slot;
+      }
+    }
+
+    //! Return the node of key, or npos, and count the lookup
+    Index lookup(const key_type& key) const
+    {
+      size_type slot = findSlot(key, mix(_hash(key)));
+      if (slot == noSlot) {
+        ++_statistics.misses;
+        return npos;
+      }
+      ++_statistics.hits;
+      return _slots[slot];
+    }
+
+    //! Resize the hash table to hold at least n entries at a load of at most 1/2
+    void rehash(size_type n)
+    {
+      size_type slots = std::max<size_type>(std::bit_ceil(2*n), 16);
+      _shift = 64 - std::countr_zero(slots);
+      _slots.assign(slots, npos);
+      for (Index node = _head; node != npos; node = _nodes[node].next) {
+        size_type slot = _nodes[node].hash >> _shift;
+        while (_slots[slot] != npos)
+          slot = (slot + 1) & (slots - 1);
+        _slots[slot] = node;
+      }
+    }
+
+    //! Remove a node from the hash table and the list, and free it
+    void erase(Index node)
+    {
+      const size_type mask = _slots.size() - 1;
+      size_type hole = findSlot(_nodes[node].value->first, _nodes[node].hash);
+      // shift back the following entries that may not stay behind the hole
+      for (size_type slot = (hole + 1) & mask; _slots[slot] != npos; slot = (slot + 1) & mask) {
+        size_type home = _nodes[_slots[slot]].hash >> _shift;
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+          _slots[hole] = _slots[slot];
+          hole = slot;
+        }
+      }
+      _slots[hole] = npos;
+
+      unlink(node);
+      _nodes[node].value.reset();
+      _nodes[node].next = _free;
+      _free = node;
+      --_size;
+    }
+
+    void linkFront(Index node)
+    {
+      _nodes[node].prev = npos;
+      _nodes[node].next = _head;
+      if (_head != npos)
+        _nodes[_head].prev = node;
+      else
+        _tail = node;
+      _head = node;
+    }
+
+    void unlink(Index node)
+    {
+      Index prev = _nodes[node].prev;
+      Index next = _nodes[node].next;
+      if (prev != npos)
+        _nodes[prev].next = next;
+      else
+        _head = next;
+      if (next != npos)
+        _nodes[next].prev = prev;
+      else
+        _tail = prev;
+    }
+
+    void moveToFront(Index node)
+    {
+      if (node != _head) {
+        unlink(node);
+        linkFront(node);
+      }
+    }
+
+    std::vector<Node> _nodes;
+    std::vector<Index> _slots;
+    int _shift = 64;
+    Index _head = npos;
+    Index _tail = npos;
+    Index _free = npos;
+    size_type _size = 0;
+    size_type _capacity;
+    Hash _hash;
+    KeyEqual _equal;
+    mutable LRUStatistics _statistics;
+  };
+
+  /**
+      @brief Thread-safe LRU cache built from several FlatLRU shards
+
+      The keys are distributed over the shards by their hash, and each
+      shard is protected by its own mutex, such that threads using
+      different shards do not wait for each other. The least recently
+      used entries are dropped per shard, i.e. the capacity is split
+      evenly between the shards.
+
+      As entries may be dropped by other threads at any time, the data is
+      returned by value.
+
+      @tparam Key The type of the keys.
+      @tparam Tp The type of the data.
+      @tparam Hash The hash function of the keys.
+      @tparam KeyEqual The comparison of the keys.
+   */
+  template <typename Key, typename Tp,
+      typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key> >
+  class ConcurrentFlatLRU
+  {
+  public:
+    typedef Key key_type;
+    typedef Tp value_type;
+    typedef std::size_t size_type;
+
+    /**
+     * @brief Create a cache.
+     * @param capacity The maximum number of entries, 0 for no limit.
+     * @param shards The number of shards.
+     */
+    explicit ConcurrentFlatLRU(size_type capacity = 0, size_type shards = 16,
+                               const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual()) :
+      _shards(std::make_unique<Shard[]>(shards)), _numShards(shards), _hash(hash)
+    {
+      for (size_type s = 0; s < shards; ++s)
+        _shards[s].cache = FlatLRU<Key, Tp, Hash, KeyEqual>((capacity + shards - 1) / shards, hash, equal);
+    }
+
+    /**
+     * @brief Returns the data of key and marks it as most recent,
+     *        or nothing if key is not in the cache.
+     */
+    std::optional<Tp> find(const key_type& key)
+    {
+      Shard& shard = shardOf(key);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto it = shard.cache.find(key);
+      if (it == shard.cache.end())
+        return std::nullopt;
+      return shard.cache.touch(key);
+    }
+
+    /**
+     * @brief Stores data under key and marks it as most recent.
+     */
+    void insert(const key_type& key, const Tp& data)
+    {
+      Shard& shard = shardOf(key);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.cache.insert(key, data);
+    }
+
+    /**
+     * @brief Returns the data of key, computing and inserting it by f() if
+     *        key is not in the cache.
+     *
+     * f is called without holding a lock, such that other threads may
+     * use the shard meanwhile. If two threads compute the data of the same
+     * key at once, the data of the later one is kept.
+     */
+    template<class F>
+    Tp findOrInsert(const key_type& key, F&& f)
+    {
+      if (std::optional<Tp> data = find(key))
+        return std::move(*data);
+      Tp data = f();
+      insert(key, data);
+      return data;
+    }
+
+    /**
+     * @brief Retrieve number of entries in the cache
+     */
+    size_type size() const
+    {
+      size_type n = 0;
+      for (size_type s = 0; s < _numShards; ++s) {
+        std::lock_guard<std::mutex> lock(_shards[s].mutex);
+        n += _shards[s].cache.size();
+      }
+      return n;
+    }
+
+    /**
+     * @brief Removes all entries, but keeps the statistics
+     */
+    void clear()
+    {
+      for (size_type s = 0; s < _numShards; ++s) {
+        std::lock_guard<std::mutex> lock(_shards[s].mutex);
+        _shards[s].cache.clear();
+      }
+    }
+
+    /**
+     * @brief The counters of hits, misses and evictions of all shards
+     */
+    LRUStatistics statistics() const
+    {
+      LRUStatistics statistics;
+      for (size_type s = 0; s < _numShards; ++s) {
+        std::lock_guard<std::mutex> lock(_shards[s].mutex);
+        statistics += _shards[s].cache.statistics();
+      }
+      return statistics;
+    }
+
+    /**
+     * @brief Reset the counters of hits, misses and evictions
+     */
+    void resetStatistics()
+    {
+      for (size_type s = 0; s < _numShards; ++s) {
+        std::lock_guard<std::mutex> lock(_shards[s].mutex);
+        _shards[s].cache.resetStatistics();
+      }
+    }
+
+  private:
+    //! A part of the cache, aligned to avoid false sharing of the mutexes
+    struct alignas(64) Shard
+    {
+      mutable std::mutex mutex;
+      FlatLRU<Key, Tp, Hash, KeyEqual> cache;
+    };
+
+    //! Select the shard by other bits of the hash than the slot in the shard
+    Shard& shardOf(const key_type& key)
+    {
+      std::uint64_t hash = std::uint64_t(_hash(key)) * 0x9E3779B97F4A7C15ull;
+      return _shards[(hash >> 16) % _numShards];
+    }
+
+    std::unique_ptr<Shard[]> _shards;
+    size_type _numShards;
+    Hash _hash;
+  };
+
+} // namespace Dune
+
+#endif // DUNE_COMMON_FLATLRU_HH
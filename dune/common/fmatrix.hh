@@ -59,6 +59,83 @@ namespace Dune
       const size_type col_;
     };
 
+    /*
+     * Register-tiled kernel for the product of two FieldMatrix objects.
+     *
+     * The result is computed in tiles of TileRows x TileCols entries which
+     * are accumulated in a local array, so that they can be held in vector
+     * registers.  A tile of columns of B is reused for all row tiles of A
+     * before moving on, which keeps this panel of B in the L1 cache.
+     */
+    // A tile is four rows of 32 bytes, i.e. four AVX registers worth of
+    // accumulators, which also leaves enough registers with plain SSE2.
+    template<class K>
+    struct FieldMatrixProductTiles
+    {
+      static constexpr int rows = 4;
+      static constexpr int cols = (sizeof(K) >= 32) ? 1 : int(32 / sizeof(K));
+    };
+
+    // The tiled kernel is used for arithmetic types and matrices that are
+    // large enough that the compiler does not unroll the naive loops anyway.
+    template<class K, class OtherK, int rows, int cols>
+    inline constexpr bool useTiledFieldMatrixProduct =
+      std::is_same_v<K, OtherK> && std::is_arithmetic_v<K> && rows >= 8 && cols >= 8;
+
+    template<int tileRows, int tileCols, class MA, class MB, class MC>
+    inline void fieldMatrixProductTile (const MA& A, const MB& B, MC& C,
+                                        int i0, int j0)
+    {
+      using K = typename MC::value_type;
+      K acc[tileRows][tileCols] = {};
+      for (int k = 0; k < int(MA::cols); ++k)
+      {
+        K b[tileCols];
+        for (int j = 0; j < tileCols; ++j)
+          b[j] = B[k][j0+j];
+        for (int i = 0; i < tileRows; ++i)
+        {
+          const K a = A[i0+i][k];
+          // Keep the column loop rolled: otherwise it is unrolled completely
+          // and GCC vectorizes the k-loop instead, which transposes B and is
+          // several times slower.
+#if defined(__GNUC__)
+#pragma GCC unroll 1
+#endif
+          for (int j = 0; j < tileCols; ++j)
+            acc[i][j] += a * b[j];
+        }
+      }
+      for (int i = 0; i < tileRows; ++i)
+        for (int j = 0; j < tileCols; ++j)
+          C[i0+i][j0+j] = acc[i][j];
+    }
+
+    template<int tileCols, class MA, class MB, class MC>
+    inline void fieldMatrixProductColumnPanel (const MA& A, const MB& B, MC& C, int j0)
+    {
+      constexpr int tileRows = FieldMatrixProductTiles<typename MC::value_type>::rows;
+      constexpr int rowRemainder = int(MA::rows) % tileRows;
+      int i0 = 0;
+      for (; i0 + tileRows <= int(MA::rows); i0 += tileRows)
+        fieldMatrixProductTile<tileRows, tileCols>(A, B, C, i0, j0);
+      if constexpr (rowRemainder > 0)
+        fieldMatrixProductTile<rowRemainder, tileCols>(A, B, C, i0, j0);
+    }
+
+    //! compute C = A*B with the register-tiled kernel
+    template<class MA, class MB, class MC>
+    inline void tiledFieldMatrixProduct (const MA& A, const MB& B, MC& C)
+    {
+      constexpr int tileCols = FieldMatrixProductTiles<typename MC::value_type>::cols;
+      constexpr int colRemainder = int(MB::cols) % tileCols;
+      int j0 = 0;
+      for (; j0 + tileCols <= int(MB::cols); j0 += tileCols)
+        fieldMatrixProductColumnPanel<tileCols>(A, B, C, j0);
+      if constexpr (colRemainder > 0)
+        fieldMatrixProductColumnPanel<colRemainder>(A, B, C, j0);
+    }
+
   }
 
   template<typename M>
@@ -413,6 +490,13 @@ namespace Dune
     {
       FieldMatrix<typename PromotionTraits<K,OtherK>::PromotedType,ROWS,otherCols> result;
 
+      if constexpr (Impl::useTiledFieldMatrixProduct<K, OtherK, ROWS, otherCols>)
+        if (not std::is_constant_evaluated())
+        {
+          Impl::tiledFieldMatrixProduct(matrixA, matrixB, result);
+          return result;
+        }
+
       for (size_type i = 0; i < matrixA.mat_rows(); ++i)
         for (size_type j = 0; j < matrixB.mat_cols(); ++j)
         {
@@ -471,6 +555,17 @@ namespace Dune
       return M * (*this);
     }
 
+    using Base::leftmultiply;
+
+    //! Multiplies M from the left to this matrix
+    // Size mismatches are left to the run-time checks of DenseMatrix.
+    template <int r, int c>
+      requires (r == c && r == rows)
+    constexpr FieldMatrix& leftmultiply (const FieldMatrix<K,r,c>& M)
+    {
+      return *this = M * (*this);
+    }
+
     using Base::rightmultiply;
 
     //! Multiplies M from the right to this matrix
@@ -481,6 +576,13 @@ namespace Dune
       static_assert(r == cols, "Size mismatch");
       FieldMatrix<K,rows,cols> C(*this);
 
+      if constexpr (Impl::useTiledFieldMatrixProduct<K, K, rows, cols>)
+        if (not std::is_constant_evaluated())
+        {
+          Impl::tiledFieldMatrixProduct(C, M, *this);
+          return *this;
+        }
+
       for (size_type i=0; i<rows; i++)
         for (size_type j=0; j<cols; j++) {
           (*this)[i][j] = 0;
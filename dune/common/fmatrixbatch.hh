@@ -0,0 +1,309 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_FMATRIXBATCH_HH
+#define DUNE_COMMON_FMATRIXBATCH_HH
+
+/** \file
+ * \brief Batched solve, invert, determinant and symmetric eigenvalue
+ *        problems for many small FieldMatrix objects
+ *
+ * The batched kernels pack a number of matrices into the lanes of a
+ * FieldMatrix<LoopSIMD<K,lanes>,n,n> and run the SIMD-aware code paths of
+ * DenseMatrix on them.  The packing is not free: for n <= 3 the closed-form
+ * per-matrix code is already very cheap, the batched kernels pay off mostly
+ * for n > 3 where the LU decomposition is used.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fmatrixev.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/simd/loop.hh>
+#include <dune/common/simd/simd.hh>
+#include <dune/common/typetraits.hh>
+
+namespace Dune {
+
+  /**
+     @addtogroup DenseMatVec
+     @{
+   */
+
+  /** \brief Default number of matrices that are processed simultaneously
+   *
+   * The default fills 64 bytes (one cache line, or one AVX-512 register)
+   * with scalars of type \c K.
+   */
+  template<class K>
+  inline constexpr std::size_t defaultBatchLanes =
+    std::max<std::size_t>(1, 64 / sizeof(K));
+
+  namespace Impl {
+
+    template<class M>
+    struct BatchMatrixTraits
+    {
+      static_assert(AlwaysFalse<M>::value,
+                    "Batched kernels are only available for square FieldMatrix types");
+    };
+
+    template<class K, int n>
+    struct BatchMatrixTraits<FieldMatrix<K,n,n>>
+    {
+      using field_type = K;
+      static constexpr int size = n;
+    };
+
+    template<class Range>
+    using BatchRangeValue = std::decay_t<decltype(std::declval<Range&>()[0])>;
+
+    template<class K, std::size_t lanes>
+    using BatchSimd = LoopSIMD<K, (lanes == 0 ? defaultBatchLanes<K> : lanes)>;
+
+    template<class Range>
+    std::size_t batchRangeSize(const Range& range)
+    {
+      return std::size(range);
+    }
+
+    template<class Range>
+    void checkBatchRangeSize(const Range& range, std::size_t count)
+    {
+      if (batchRangeSize(range) < count)
+        DUNE_THROW(RangeError, "Output range of size " << batchRangeSize(range)
+                   << " is too small for a batch of " << count << " matrices");
+    }
+
+    // Load matrices [first, first+active) into the lanes of A. Unused lanes are
+    // filled with the identity so that they never report a singular matrix.
+    template<class S, int n, class Range>
+    void packMatrices(FieldMatrix<S,n,n>& A, const Range& range,
+                      std::size_t first, std::size_t active)
+    {
+      for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+        {
+          for (std::size_t l = 0; l < active; ++l)
+            Simd::lane(l, A[i][j]) = range[first+l][i][j];
+          for (std::size_t l = active; l < Simd::lanes<S>(); ++l)
+            Simd::lane(l, A[i][j]) = (i == j) ? 1 : 0;
+        }
+    }
+
+    template<class S, int n, class Range>
+    void unpackMatrices(const FieldMatrix<S,n,n>& A, Range& range,
+                        std::size_t first, std::size_t active)
+    {
+      for (std::size_t l = 0; l < active; ++l)
+        for (int i = 0; i < n; ++i)
+          for (int j = 0; j < n; ++j)
+            range[first+l][i][j] = Simd::lane(l, A[i][j]);
+    }
+
+    template<class S, int n, class Range>
+    void packVectors(FieldVector<S,n>& v, const Range& range,
+                     std::size_t first, std::size_t active)
+    {
+      for (int i = 0; i < n; ++i)
+      {
+        for (std::size_t l = 0; l < active; ++l)
+          Simd::lane(l, v[i]) = range[first+l][i];
+        for (std::size_t l = active; l < Simd::lanes<S>(); ++l)
+          Simd::lane(l, v[i]) = 0;
+      }
+    }
+
+    template<class S, int n, class Range>
+    void unpackVectors(const FieldVector<S,n>& v, Range& range,
+                       std::size_t first, std::size_t active)
+    {
+      for (std::size_t l = 0; l < active; ++l)
+        for (int i = 0; i < n; ++i)
+          range[first+l][i] = Simd::lane(l, v[i]);
+    }
+
+  } // end namespace Impl
+
+  /** \brief Compute the determinants of many square FieldMatrix objects at once
+   *
+   * The matrices are transposed into structure-of-arrays form, i.e. into a
+   * FieldMatrix of LoopSIMD lanes, and the determinants of \c lanes matrices are
+   * computed by a single call of DenseMatrix::determinant().
+   *
+   * \tparam lanes         Number of matrices processed simultaneously, 0 selects
+   *                       defaultBatchLanes.
+   * \param  matrices      Random-access range (e.g. std::vector, std::span or a
+   *                       rank-1 Std::mdspan) of FieldMatrix<K,n,n>.
+   * \param  determinants  Random-access range of K receiving the results.
+   * \param  doPivoting    Enable pivoting in the LU decomposition (n > 3).
+   *
+   * Singular matrices yield a determinant of zero.
+   */
+  template<std::size_t lanes = 0, class MatrixRange, class DetRange>
+  void batchDeterminant(const MatrixRange& matrices, DetRange&& determinants,
+                        bool doPivoting = true)
+  {
+    using Traits = Impl::BatchMatrixTraits<Impl::BatchRangeValue<const MatrixRange>>;
+    using S = Impl::BatchSimd<typename Traits::field_type, lanes>;
+    constexpr int n = Traits::size;
+
+    const std::size_t count = Impl::batchRangeSize(matrices);
+    Impl::checkBatchRangeSize(determinants, count);
+
+    FieldMatrix<S,n,n> A;
+    for (std::size_t first = 0; first < count; first += Simd::lanes<S>())
+    {
+      const std::size_t active = std::min(Simd::lanes<S>(), count - first);
+      Impl::packMatrices(A, matrices, first, active);
+      const S det = A.determinant(doPivoting);
+      for (std::size_t l = 0; l < active; ++l)
+        determinants[first+l] = Simd::lane(l, det);
+    }
+  }
+
+  /** \brief Solve many small linear systems \f$ A_i x_i = b_i \f$ at once
+   *
+   * \tparam lanes       Number of systems solved simultaneously, 0 selects
+   *                     defaultBatchLanes.
+   * \param  matrices    Random-access range of FieldMatrix<K,n,n>.
+   * \param  x           Random-access range of FieldVector<K,n> receiving the
+   *                     solutions.
+   * \param  b           Random-access range of FieldVector<K,n>, the right hand
+   *                     sides.
+   * \param  doPivoting  Enable pivoting in the LU decomposition (n > 3).
+   *
+   * \throws FMatrixError if one of the matrices is singular (see
+   *                      DenseMatrix::solve()).
+   */
+  template<std::size_t lanes = 0, class MatrixRange, class XRange, class BRange>
+  void batchSolve(const MatrixRange& matrices, XRange&& x, const BRange& b,
+                  bool doPivoting = true)
+  {
+    using Traits = Impl::BatchMatrixTraits<Impl::BatchRangeValue<const MatrixRange>>;
+    using S = Impl::BatchSimd<typename Traits::field_type, lanes>;
+    constexpr int n = Traits::size;
+
+    const std::size_t count = Impl::batchRangeSize(matrices);
+    Impl::checkBatchRangeSize(x, count);
+    Impl::checkBatchRangeSize(b, count);
+
+    FieldMatrix<S,n,n> A;
+    FieldVector<S,n> xs, bs;
+    for (std::size_t first = 0; first < count; first += Simd::lanes<S>())
+    {
+      const std::size_t active = std::min(Simd::lanes<S>(), count - first);
+      Impl::packMatrices(A, matrices, first, active);
+      Impl::packVectors(bs, b, first, active);
+      A.solve(xs, bs, doPivoting);
+      Impl::unpackVectors(xs, x, first, active);
+    }
+  }
+
+  /** \brief Invert many square FieldMatrix objects in place
+   *
+   * \tparam lanes       Number of matrices inverted simultaneously, 0 selects
+   *                     defaultBatchLanes.
+   * \param  matrices    Random-access range of FieldMatrix<K,n,n>.
+   * \param  doPivoting  Enable pivoting in the LU decomposition (n > 3).
+   *
+   * \throws FMatrixError if one of the matrices is singular (see
+   *                      DenseMatrix::invert()).
+   */
+  template<std::size_t lanes = 0, class MatrixRange>
+  void batchInvert(MatrixRange&& matrices, bool doPivoting = true)
+  {
+    using Traits = Impl::BatchMatrixTraits<Impl::BatchRangeValue<MatrixRange>>;
+    using S = Impl::BatchSimd<typename Traits::field_type, lanes>;
+    constexpr int n = Traits::size;
+
+    const std::size_t count = Impl::batchRangeSize(matrices);
+
+    FieldMatrix<S,n,n> A;
+    for (std::size_t first = 0; first < count; first += Simd::lanes<S>())
+    {
+      const std::size_t active = std::min(Simd::lanes<S>(), count - first);
+      Impl::packMatrices(A, matrices, first, active);
+      A.invert(doPivoting);
+      Impl::unpackMatrices(A, matrices, first, active);
+    }
+  }
+
+  /** \brief Compute the eigenvalues of many symmetric FieldMatrix objects at once
+   *
+   * The matrices are processed lane-wise by the Jacobi method of
+   * FMatrixHelp::eigenValuesJacobi(), which does not need LAPACK.
+   *
+   * \tparam lanes        Number of matrices processed simultaneously, 0 selects
+   *                      defaultBatchLanes.
+   * \param  matrices     Random-access range of symmetric FieldMatrix<K,n,n>.
+   * \param  eigenValues  Random-access range of FieldVector<K,n> receiving the
+   *                      eigenvalues in ascending order.
+   */
+  template<std::size_t lanes = 0, class MatrixRange, class EVRange>
+  void batchEigenValues(const MatrixRange& matrices, EVRange&& eigenValues)
+  {
+    using Traits = Impl::BatchMatrixTraits<Impl::BatchRangeValue<const MatrixRange>>;
+    using S = Impl::BatchSimd<typename Traits::field_type, lanes>;
+    constexpr int n = Traits::size;
+
+    const std::size_t count = Impl::batchRangeSize(matrices);
+    Impl::checkBatchRangeSize(eigenValues, count);
+
+    FieldMatrix<S,n,n> A;
+    FieldVector<S,n> ev;
+    for (std::size_t first = 0; first < count; first += Simd::lanes<S>())
+    {
+      const std::size_t active = std::min(Simd::lanes<S>(), count - first);
+      Impl::packMatrices(A, matrices, first, active);
+      FMatrixHelp::eigenValuesJacobi(A, ev);
+      Impl::unpackVectors(ev, eigenValues, first, active);
+    }
+  }
+
+  /** \brief Compute eigenvalues and -vectors of many symmetric FieldMatrix
+   *         objects at once
+   *
+   * \tparam lanes         Number of matrices processed simultaneously, 0 selects
+   *                       defaultBatchLanes.
+   * \param  matrices      Random-access range of symmetric FieldMatrix<K,n,n>.
+   * \param  eigenValues   Random-access range of FieldVector<K,n> receiving the
+   *                       eigenvalues in ascending order.
+   * \param  eigenVectors  Random-access range of FieldMatrix<K,n,n> whose rows
+   *                       receive the corresponding normalized eigenvectors.
+   */
+  template<std::size_t lanes = 0, class MatrixRange, class EVRange, class EVecRange>
+  void batchEigenValuesVectors(const MatrixRange& matrices, EVRange&& eigenValues,
+                               EVecRange&& eigenVectors)
+  {
+    using Traits = Impl::BatchMatrixTraits<Impl::BatchRangeValue<const MatrixRange>>;
+    using S = Impl::BatchSimd<typename Traits::field_type, lanes>;
+    constexpr int n = Traits::size;
+
+    const std::size_t count = Impl::batchRangeSize(matrices);
+    Impl::checkBatchRangeSize(eigenValues, count);
+    Impl::checkBatchRangeSize(eigenVectors, count);
+
+    FieldMatrix<S,n,n> A, V;
+    FieldVector<S,n> ev;
+    for (std::size_t first = 0; first < count; first += Simd::lanes<S>())
+    {
+      const std::size_t active = std::min(Simd::lanes<S>(), count - first);
+      Impl::packMatrices(A, matrices, first, active);
+      FMatrixHelp::eigenValuesVectorsJacobi(A, ev, V);
+      Impl::unpackVectors(ev, eigenValues, first, active);
+      Impl::unpackMatrices(V, eigenVectors, first, active);
+    }
+  }
+
+  /** @} end documentation */
+
+} // end namespace Dune
+
+#endif // DUNE_COMMON_FMATRIXBATCH_HH
@@ -13,12 +13,15 @@
 #include <iostream>
 #include <cmath>
 #include <cassert>
+#include <limits>
+#include <type_traits>
 
 #include <dune-common-config.hh>  // HAVE_LAPACK
 #include <dune/common/exceptions.hh>
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
 #include <dune/common/math.hh>
+#include <dune/common/simd/simd.hh>
 
 namespace Dune {
 
@@ -424,6 +427,120 @@ namespace Dune {
         eigenValues *= maxAbsElement;
       }
 
+      /*
+        Cyclic Jacobi method for symmetric matrices, see e.g.
+          Golub, van Loan: Matrix Computations, Section 8.5.
+
+        All lanes of a SIMD field type are processed simultaneously: rotations
+        are computed without branches, lanes with a vanishing off-diagonal
+        entry are rotated by the identity, and the sweeps continue until all
+        lanes have converged.
+      */
+      template <Jobs Tag, int dim, typename K>
+      static void eigenValuesVectorsJacobiImpl(const FieldMatrix<K, dim, dim>& matrix,
+                                               FieldVector<K, dim>& eigenValues,
+                                               FieldMatrix<K, dim, dim>& eigenVectors)
+      {
+        using std::abs;
+        using std::sqrt;
+        using real_type = Simd::Scalar<typename FieldTraits<K>::real_type>;
+        constexpr int maxSweeps = 50;
+        const real_type eps = std::numeric_limits<real_type>::epsilon();
+
+        FieldMatrix<K, dim, dim> A = matrix;
+        // transposed accumulated rotations, row i converges to the i-th eigenvector
+        if constexpr (Tag == Jobs::EigenvaluesEigenvectors)
+          for (int i = 0; i < dim; ++i)
+            for (int j = 0; j < dim; ++j)
+              eigenVectors[i][j] = K(i == j ? 1 : 0);
+
+        for (int sweep = 0; sweep < maxSweeps; ++sweep)
+        {
+          K offDiagonal(0), diagonal(0);
+          for (int p = 0; p < dim; ++p)
+          {
+            diagonal += A[p][p]*A[p][p];
+            for (int q = p+1; q < dim; ++q)
+              offDiagonal += A[p][q]*A[p][q];
+          }
+          if (Simd::allTrue(offDiagonal <= eps*eps*diagonal))
+            break;
+
+          for (int p = 0; p < dim-1; ++p)
+            for (int q = p+1; q < dim; ++q)
+            {
+              // rotation angle such that A[p][q] vanishes after the update
+              const K apq = A[p][q];
+              const auto isZero = (apq == K(0));
+              const K theta = (A[q][q] - A[p][p]) / Simd::cond(isZero, K(1), K(2)*apq);
+              const K absTheta = abs(theta);
+              K t = K(1) / (absTheta + sqrt(theta*theta + K(1)));
+              t = Simd::cond(theta < K(0), -t, t);
+              t = Simd::cond(isZero, K(0), t);
+              const K c = K(1) / sqrt(t*t + K(1));
+              const K s = t*c;
+
+              // A = P^T A P
+              for (int k = 0; k < dim; ++k)
+              {
+                const K akp = A[k][p];
+                const K akq = A[k][q];
+                A[k][p] = c*akp - s*akq;
+                A[k][q] = s*akp + c*akq;
+              }
+              for (int k = 0; k < dim; ++k)
+              {
+                const K apk = A[p][k];
+                const K aqk = A[q][k];
+                A[p][k] = c*apk - s*aqk;
+                A[q][k] = s*apk + c*aqk;
+              }
+              A[p][q] = A[q][p] = K(0);
+
+              if constexpr (Tag == Jobs::EigenvaluesEigenvectors)
+                for (int k = 0; k < dim; ++k)
+                {
+                  const K vpk = eigenVectors[p][k];
+                  const K vqk = eigenVectors[q][k];
+                  eigenVectors[p][k] = c*vpk - s*vqk;
+                  eigenVectors[q][k] = s*vpk + c*vqk;
+                }
+            }
+        }
+
+        for (int i = 0; i < dim; ++i)
+          eigenValues[i] = A[i][i];
+
+        // sort in ascending order, lane by lane
+        for (int i = 0; i < dim-1; ++i)
+          for (int j = i+1; j < dim; ++j)
+          {
+            const auto doSwap = (eigenValues[j] < eigenValues[i]);
+            const K ei = eigenValues[i];
+            eigenValues[i] = Simd::cond(doSwap, eigenValues[j], ei);
+            eigenValues[j] = Simd::cond(doSwap, ei, eigenValues[j]);
+            if constexpr (Tag == Jobs::EigenvaluesEigenvectors)
+              for (int k = 0; k < dim; ++k)
+              {
+                const K vik = eigenVectors[i][k];
+                eigenVectors[i][k] = Simd::cond(doSwap, eigenVectors[j][k], vik);
+                eigenVectors[j][k] = Simd::cond(doSwap, vik, eigenVectors[j][k]);
+              }
+          }
+      }
+
+      // Matrices up to this size, SIMD field types, and all matrices if LAPACK
+      // is not available are handled by the Jacobi method.
+      inline constexpr int jacobiMaxDim = 9;
+
+      template <int dim, typename K>
+      inline constexpr bool useJacobi =
+#if HAVE_LAPACK
+        (dim <= jacobiMaxDim) || !std::is_arithmetic_v<K>;
+#else
+        true;
+#endif
+
       // forwarding to LAPACK with corresponding tag
       template <Jobs Tag, int dim, typename K>
       static void eigenValuesVectorsLapackImpl(const FieldMatrix<K, dim, dim>& matrix,
@@ -509,7 +626,10 @@ namespace Dune {
                                          FieldVector<K, dim>& eigenValues,
                                          FieldMatrix<K, dim, dim>& eigenVectors)
       {
-        eigenValuesVectorsLapackImpl<Tag>(matrix,eigenValues,eigenVectors);
+        if constexpr (useJacobi<dim,K>)
+          eigenValuesVectorsJacobiImpl<Tag>(matrix,eigenValues,eigenVectors);
+        else
+          eigenValuesVectorsLapackImpl<Tag>(matrix,eigenValues,eigenVectors);
       }
     } //namespace Impl
 
@@ -518,7 +638,8 @@ namespace Dune {
         \param[out] eigenValues FieldVector that contains eigenvalues in
                     ascending order
 
-        \note specializations for dim=1,2,3 exist, for dim>3 LAPACK::dsyev is used
+        \note specializations for dim=1,2,3 exist, for 3<dim<=9 and for SIMD
+              field types the Jacobi method is used, otherwise LAPACK::dsyev
      */
     template <int dim, typename K>
     static void eigenValues(const FieldMatrix<K, dim, dim>& matrix,
@@ -534,7 +655,8 @@ namespace Dune {
                     ascending order
         \param[out] eigenVectors FieldMatrix that contains the eigenvectors
 
-        \note specializations for dim=1,2,3 exist, for dim>3 LAPACK::dsyev is used
+        \note specializations for dim=1,2,3 exist, for 3<dim<=9 and for SIMD
+              field types the Jacobi method is used, otherwise LAPACK::dsyev
      */
     template <int dim, typename K>
     static void eigenValuesVectors(const FieldMatrix<K, dim, dim>& matrix,
@@ -544,6 +666,42 @@ namespace Dune {
       Impl::eigenValuesVectorsImpl<Impl::Jobs::EigenvaluesEigenvectors>(matrix, eigenValues, eigenVectors);
     }
 
+    /** \brief calculates the eigenvalues of a symmetric field matrix by the
+               cyclic Jacobi method
+        \param[in]  matrix matrix eigenvalues are calculated for
+        \param[out] eigenValues FieldVector that contains eigenvalues in
+                    ascending order
+
+        \note This does not need LAPACK and also works lane-wise for SIMD
+              field types such as LoopSIMD.
+     */
+    template <int dim, typename K>
+    static void eigenValuesJacobi(const FieldMatrix<K, dim, dim>& matrix,
+                                  FieldVector<K, dim>& eigenValues)
+    {
+      Impl::EVDummy<K,dim> dummy;
+      Impl::eigenValuesVectorsJacobiImpl<Impl::Jobs::OnlyEigenvalues>(matrix, eigenValues, dummy);
+    }
+
+    /** \brief calculates the eigenvalues and -vectors of a symmetric field
+               matrix by the cyclic Jacobi method
+        \param[in]  matrix matrix eigenvalues are calculated for
+        \param[out] eigenValues FieldVector that contains eigenvalues in
+                    ascending order
+        \param[out] eigenVectors FieldMatrix whose rows contain the
+                    normalized eigenvectors
+
+        \note This does not need LAPACK and also works lane-wise for SIMD
+              field types such as LoopSIMD.
+     */
+    template <int dim, typename K>
+    static void eigenValuesVectorsJacobi(const FieldMatrix<K, dim, dim>& matrix,
+                                         FieldVector<K, dim>& eigenValues,
+                                         FieldMatrix<K, dim, dim>& eigenVectors)
+    {
+      Impl::eigenValuesVectorsJacobiImpl<Impl::Jobs::EigenvaluesEigenvectors>(matrix, eigenValues, eigenVectors);
+    }
+
     /** \brief calculates the eigenvalues of a symmetric field matrix
         \param[in]  matrix matrix eigenvalues are calculated for
         \param[out] eigenValues FieldVector that contains eigenvalues in
@@ -160,6 +160,16 @@ namespace Dune {
         _data[i] = x[i];
     }
 
+    //! Constructor from a lazily evaluated expression, see densevectorexpression.hh
+    template<class E>
+      requires Impl::IsDenseVectorExpression<E>
+    constexpr FieldVector (const E& e)
+    {
+      DUNE_ASSERT_BOUNDS(e.size() == size());
+      for (size_type i = 0; i < size(); ++i)
+        _data[i] = e[i];
+    }
+
     //! Converting constructor from FieldVector with different element type
     template<class OtherK>
       requires (std::is_assignable_v<K&, const OtherK&>)
@@ -186,6 +196,17 @@ namespace Dune {
       return *this;
     }
 
+    //! Assignment from a lazily evaluated expression, see densevectorexpression.hh
+    template<class E>
+      requires Impl::IsDenseVectorExpression<E>
+    constexpr FieldVector& operator= (const E& e)
+    {
+      DUNE_ASSERT_BOUNDS(e.size() == size());
+      for (size_type i = 0; i < size(); ++i)
+        _data[i] = e[i];
+      return *this;
+    }
+
     //! Assignment operator from scalar
     template<Concept::Number S>
       requires std::constructible_from<K,S>
@@ -0,0 +1,155 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark for the latency of a halo exchange with the
+ * BufferedCommunicator, with and without persistent requests and copies, and
+ * with neighborhood collectives.
+ *
+ * Each rank owns a contiguous block of a one-dimensional array and has
+ * overlap entries of its neighbours on both sides. The time per forward
+ * communication from the owners to the overlap is measured for
+ * BufferedCommunicator copying the messages and posting its requests in
+ * every communication, for BufferedCommunicator(true) reusing persistent
+ * requests set up in build(), for BufferedCommunicator sending and
+ * receiving the contiguous overlap without copies, and for
+ * BufferedCommunicator exchanging all messages with one
+ * MPI_Neighbor_alltoallv on a distributed graph communicator.
+ *
+ * Usage: mpirun -np 64 ./bufferedcommunicator_benchmark [options]
+ *
+ * options:
+ * -iterations: default: 10000. Number of exchanges to measure the time for
+ *              one exchange.
+ * -entries: default: 1000. Number of entries each rank owns.
+ * -overlap: default: 1. Number of overlap entries on each side.
+ * -startSize: default: 2. Runs the benchmark for different communicator
+ *             sizes, starting with startSize. After every run the size is
+ *             doubled. Finally one run is made for the whole communicator.
+ *
+ * options are passed at the command-line (-key value).
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <iostream>
+#include <vector>
+
+#include <dune/common/enumset.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/timer.hh>
+#include <dune/common/parallel/communicator.hh>
+#include <dune/common/parallel/indexset.hh>
+#include <dune/common/parallel/interface.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parallel/plocalindex.hh>
+#include <dune/common/parallel/remoteindices.hh>
+
+Dune::ParameterTree options;
+
+enum Flags { owner, overlap };
+
+typedef Dune::ParallelIndexSet<int,Dune::ParallelLocalIndex<Flags> > IndexSet;
+typedef std::vector<double> Vector;
+
+template<class CC>
+double measure(CC& cc, Dune::BufferedCommunicator& communicator, Vector& data)
+{
+  int iterations = options.get("iterations", 10000);
+  communicator.forward<Dune::CopyGatherScatter<Vector> >(data); // warm up
+  cc.barrier();
+  Dune::Timer watch;
+  for(int i = 0; i < iterations; i++)
+    communicator.forward<Dune::CopyGatherScatter<Vector> >(data);
+  return cc.sum(watch.elapsed())/iterations/cc.size();
+}
+
+void run(int s){
+  auto comm_world = Dune::MPIHelper::getCommunication();
+  MPI_Comm comm;
+  MPI_Comm_split(comm_world, comm_world.rank() < s, comm_world.rank(), &comm);
+  if(comm_world.rank() < s){
+    Dune::Communication<MPI_Comm> cc(comm);
+    const int rank = cc.rank();
+    const int procs = cc.size();
+    const int entries = options.get("entries", 1000);
+    const int width = options.get("overlap", 1);
+
+    // the owned block and the overlap on both sides
+    const int start = rank*entries;
+    const int end = start + entries;
+    const int ostart = std::max(start - width, 0);
+    const int oend = std::min(end + width, procs*entries);
+
+    IndexSet indexSet;
+    Vector data(oend - ostart);
+    indexSet.beginResize();
+    for(int i = ostart, local = 0; i < oend; i++, local++) {
+      bool isPublic = i < start + width || i >= end - width;
+      Flags flag = (i < start || i >= end) ? overlap : owner;
+      indexSet.add(i, Dune::ParallelLocalIndex<Flags>(local, flag, isPublic));
+      data[local] = i;
+    }
+    indexSet.endResize();
+
+    Dune::RemoteIndices<IndexSet> remoteIndices(indexSet, indexSet, comm);
+    remoteIndices.rebuild<false>();
+    Dune::Interface interface;
+    interface.build(remoteIndices, Dune::EnumItem<Flags,owner>(), Dune::EnumItem<Flags,overlap>());
+
+    Dune::BufferedCommunicator communicator, persistentCommunicator(true), zeroCopyCommunicator,
+      neighborCommunicator;
+    communicator.setZeroCopyRunLength(std::numeric_limits<double>::infinity());
+    zeroCopyCommunicator.setZeroCopyRunLength(0);
+    neighborCommunicator.setNeighborCollectives(true);
+    communicator.build<Vector>(interface);
+    persistentCommunicator.build<Vector>(interface);
+    zeroCopyCommunicator.build<Vector>(interface);
+    neighborCommunicator.build<Vector>(interface);
+
+    double plain_t = measure(cc, communicator, data);
+    double persistent_t = measure(cc, persistentCommunicator, data);
+    double zerocopy_t = measure(cc, zeroCopyCommunicator, data);
+    double neighbor_t = measure(cc, neighborCommunicator, data);
+    std::cout << std::setw(10) << procs
+              << std::setw(10) << entries
+              << std::setw(10) << width
+              << std::setw(16) << plain_t
+              << std::setw(16) << persistent_t
+              << std::setw(16) << zerocopy_t
+              << std::setw(16) << neighbor_t
+              << std::endl;
+  }
+  MPI_Comm_free(&comm);
+}
+
+int main(int argc, char** argv){
+  Dune::MPIHelper& mpihelper = Dune::MPIHelper::instance(argc, argv);
+
+  // disable output on almost all ranks
+  if(mpihelper.rank() != 0)
+    std::cout.setstate(std::ios_base::failbit);
+  Dune::ParameterTreeParser::readOptions(argc, argv, options);
+
+  std::cout << std::left << std::scientific;
+  std::cout << "time per exchange [s]" << std::endl;
+  std::cout << std::setw(10) << "commsize"
+            << std::setw(10) << "entries"
+            << std::setw(10) << "overlap"
+            << std::setw(16) << "Plain"
+            << std::setw(16) << "Persistent"
+            << std::setw(16) << "ZeroCopy"
+            << std::setw(16) << "Neighbor"
+            << std::endl;
+  int s = options.get("startSize", 2);
+  while(s < mpihelper.size()){
+    run(s);
+    s *= 2;
+  }
+  run(mpihelper.size());
+  return 0;
+}
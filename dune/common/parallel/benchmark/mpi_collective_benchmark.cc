@@ -38,8 +38,16 @@
  *
  * options:
  * -method: default: allreduce.
- *                   possible methods: allreduce, barrier,
- *                   broadcast, gather, allgather, scatter
+ *                   possible methods: allreduce, allreduce_fieldvector,
+ *                   allreduce_segmented, barrier, broadcast, gather,
+ *                   allgather, scatter
+ * -count: default: 1. Number of entries reduced by the allreduce methods.
+ *         allreduce_fieldvector reduces count/4 FieldVector<double,4>, which
+ *         is mapped onto MPI_SUM of doubles. allreduce_segmented splits the
+ *         entries into segments of -segment entries whose reductions overlap;
+ *         its nonblocking variants use one iallreduce of all entries.
+ * -segment: default: 65536. Number of entries per segment for
+ *           allreduce_segmented.
  * -iterations: default: 10000. Number of iterations for
  *              measure the time for one communication
  * -allMethods: default:0. If 1 iterates over all available methods
@@ -65,6 +73,7 @@
  * (https://software.intel.com/en-us/mpi-developer-reference-linux-asynchronous-progress-control)
  */
 
+#include <algorithm>
 #include <chrono>
 #include <functional>
 #include <iostream>
@@ -75,6 +84,7 @@
 #include <vector>
 
 #include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
 #include <dune/common/timer.hh>
 #include <dune/common/parametertree.hh>
 #include <dune/common/parametertreeparser.hh>
@@ -83,6 +93,8 @@
 
 Dune::ParameterTree options;
 std::vector<std::string> all_methods = {"allreduce",
+                         "allreduce_fieldvector",
+                         "allreduce_segmented",
                          "barrier",
                          "broadcast",
                          "gather",
@@ -94,7 +106,19 @@ void communicate(CC& cc){
   auto method = options.get("method", "allreduce");
   std::vector<int> data(1, 42);
   if(method == "allreduce"){
-    cc.template allreduce<std::plus<int>>(data);
+    cc.template allreduce<std::plus<int>>(std::vector<int>(options.get("count", 1), 42));
+    return;
+  }
+  if(method == "allreduce_fieldvector"){
+    using Vector = Dune::FieldVector<double,4>;
+    std::vector<Vector> in(std::max(options.get("count", 1)/4, 1), Vector(42.0)), out(in.size());
+    cc.template allreduce<std::plus<Vector>>(in.data(), out.data(), in.size());
+    return;
+  }
+  if(method == "allreduce_segmented"){
+    std::vector<double> in(options.get("count", 1), 42.0), out(in.size());
+    cc.template allreduce<std::plus<double>>(in.data(), out.data(), in.size(),
+                                             options.get("segment", 65536));
     return;
   }
   if(method == "barrier"){
@@ -129,6 +153,13 @@ Dune::Future<void> startCommunication(CC& cc){
   if(method == "allreduce"){
     return cc.template iallreduce<std::plus<char>>(42);
   }
+  if(method == "allreduce_fieldvector"){
+    using Vector = Dune::FieldVector<double,4>;
+    return cc.template iallreduce<std::plus<Vector>>(std::vector<Vector>(std::max(options.get("count", 1)/4, 1), Vector(42.0)));
+  }
+  if(method == "allreduce_segmented"){
+    return cc.template iallreduce<std::plus<double>>(std::vector<double>(options.get("count", 1), 42.0));
+  }
   if(method == "barrier"){
     return cc.ibarrier();
   }
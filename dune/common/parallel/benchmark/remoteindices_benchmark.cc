@@ -0,0 +1,150 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Weak scaling benchmark for RemoteIndices::rebuild.
+ *
+ * Each rank owns a contiguous block of a one-dimensional array with a fixed
+ * number of entries and has overlap entries of its neighbours on both sides.
+ * The time of rebuild() is measured without a list of neighbours, where the
+ * processes sharing indices are found by a rendezvous of the global indices,
+ * and with the neighbours given to the RemoteIndices, where only they
+ * exchange their indices. In addition, rebuild() with the neighbours given is
+ * measured with the remote index lists allocated from an Arena, which is
+ * released as a whole before each rebuild.
+ *
+ * Usage: mpirun -np 64 ./remoteindices_benchmark [options]
+ *
+ * options:
+ * -iterations: default: 10. Number of rebuilds to measure the time for
+ *              one rebuild.
+ * -entries: default: 10000. Number of entries each rank owns.
+ * -overlap: default: 1. Number of overlap entries on each side.
+ * -startSize: default: 2. Runs the benchmark for different communicator
+ *             sizes, starting with startSize. After every run the size is
+ *             doubled. Finally one run is made for the whole communicator.
+ *
+ * options are passed at the command-line (-key value).
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <dune/common/arenaallocator.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/timer.hh>
+#include <dune/common/parallel/indexset.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parallel/plocalindex.hh>
+#include <dune/common/parallel/remoteindices.hh>
+
+Dune::ParameterTree options;
+
+enum Flags { owner, overlap };
+
+typedef Dune::ParallelIndexSet<int,Dune::ParallelLocalIndex<Flags> > IndexSet;
+typedef Dune::RemoteIndices<IndexSet> RemoteIndices;
+typedef Dune::RemoteIndices<IndexSet,
+                            Dune::ArenaAllocator<Dune::RemoteIndex<int,Flags> > > ArenaRemoteIndices;
+
+template<class CC, class R, class F>
+double measure(CC& cc, R& remoteIndices, F&& release)
+{
+  int iterations = options.get("iterations", 10);
+  remoteIndices.template rebuild<false>(); // warm up
+  cc.barrier();
+  Dune::Timer watch;
+  for(int i = 0; i < iterations; i++) {
+    remoteIndices.free();
+    release();
+    remoteIndices.template rebuild<false>();
+  }
+  return cc.sum(watch.elapsed())/iterations/cc.size();
+}
+
+void run(int s){
+  auto comm_world = Dune::MPIHelper::getCommunication();
+  MPI_Comm comm;
+  MPI_Comm_split(comm_world, comm_world.rank() < s, comm_world.rank(), &comm);
+  if(comm_world.rank() < s){
+    Dune::Communication<MPI_Comm> cc(comm);
+    const int rank = cc.rank();
+    const int procs = cc.size();
+    const int entries = options.get("entries", 10000);
+    const int width = options.get("overlap", 1);
+
+    // the owned block and the overlap on both sides
+    const int start = rank*entries;
+    const int end = start + entries;
+    const int ostart = std::max(start - width, 0);
+    const int oend = std::min(end + width, procs*entries);
+
+    IndexSet indexSet;
+    indexSet.beginResize();
+    for(int i = ostart, local = 0; i < oend; i++, local++) {
+      bool isPublic = i < start + width || i >= end - width;
+      Flags flag = (i < start || i >= end) ? overlap : owner;
+      indexSet.add(i, Dune::ParallelLocalIndex<Flags>(local, flag, isPublic));
+    }
+    indexSet.endResize();
+
+    std::vector<int> neighbours;
+    if(rank > 0)
+      neighbours.push_back(rank - 1);
+    if(rank < procs - 1)
+      neighbours.push_back(rank + 1);
+
+    RemoteIndices discovered(indexSet, indexSet, comm);
+    RemoteIndices given(indexSet, indexSet, comm, neighbours);
+    // the arena has to outlive the remote indices allocated from it
+    Dune::Arena arena;
+    ArenaRemoteIndices arenaGiven(indexSet, indexSet, comm, neighbours);
+
+    double discovered_t = measure(cc, discovered, []{});
+    double given_t = measure(cc, given, []{});
+    double arena_t;
+    {
+      Dune::ArenaScope scope(arena);
+      arena_t = measure(cc, arenaGiven, [&]{ arena.release(); });
+    }
+    std::cout << std::setw(10) << procs
+              << std::setw(10) << entries
+              << std::setw(10) << width
+              << std::setw(16) << discovered_t
+              << std::setw(16) << given_t
+              << std::setw(16) << arena_t
+              << std::endl;
+  }
+  MPI_Comm_free(&comm);
+}
+
+int main(int argc, char** argv){
+  Dune::MPIHelper& mpihelper = Dune::MPIHelper::instance(argc, argv);
+
+  // disable output on almost all ranks
+  if(mpihelper.rank() != 0)
+    std::cout.setstate(std::ios_base::failbit);
+  Dune::ParameterTreeParser::readOptions(argc, argv, options);
+
+  std::cout << std::left << std::scientific;
+  std::cout << "time per rebuild [s]" << std::endl;
+  std::cout << std::setw(10) << "commsize"
+            << std::setw(10) << "entries"
+            << std::setw(10) << "overlap"
+            << std::setw(16) << "Rendezvous"
+            << std::setw(16) << "Neighbours"
+            << std::setw(16) << "Arena"
+            << std::endl;
+  int s = options.get("startSize", 2);
+  while(s < mpihelper.size()){
+    run(s);
+    s *= 2;
+  }
+  run(mpihelper.size());
+  return 0;
+}
@@ -528,6 +528,29 @@ namespace Dune
       return 0;
     }
 
+    /**
+     * @brief Compute something over all processes
+     * for each component of a long array in segments and return the
+     * result in every process.
+     *
+     * The array is split into segments of segmentLength components that
+     * are reduced by nonblocking reductions started at once, such that the
+     * reductions of the segments overlap.
+     *
+     * @param in The array to compute on.
+     * @param out The array to store the results in.
+     * @param len The number of components in the array
+     * @param segmentLength The number of components per segment. If it is
+     * not positive or at least len, the array is reduced at once.
+     * @returns MPI_SUCCESS (==0) if successful, an MPI error code otherwise
+     */
+    template<typename BinaryFunction, typename Type>
+    int allreduce(const Type* in, Type* out, int len, [[maybe_unused]] int segmentLength) const
+    {
+      std::copy(in, in+len, out);
+      return 0;
+    }
+
   };
 }
 
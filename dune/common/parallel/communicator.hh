@@ -7,19 +7,24 @@
 
 #if HAVE_MPI
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <mpi.h>
 
 #include <dune/common/exceptions.hh>
+#include <dune/common/parallel/future.hh>
 #include <dune/common/parallel/interface.hh>
 #include <dune/common/parallel/remoteindices.hh>
 #include <dune/common/stdstreams.hh>
+#include <dune/common/std/type_traits.hh>
 
 namespace Dune
 {
@@ -453,6 +458,12 @@ namespace Dune
    * then that buffer is sent.
    * The data is received in another buffer and then copied to the actual
    * position.
+   *
+   * In persistent mode the MPI requests for both directions are set up
+   * once in build() with MPI_Ssend_init and MPI_Recv_init, and each
+   * communication only starts and completes them. As the buffers are fixed
+   * after build(), this saves posting the messages anew in every halo
+   * exchange.
    */
   class BufferedCommunicator
   {
@@ -463,6 +474,13 @@ namespace Dune
      */
     BufferedCommunicator();
 
+    /**
+     * @brief Constructor.
+     * @param persistent Whether to set up persistent requests in build()
+     * and reuse them in every communication.
+     */
+    explicit BufferedCommunicator(bool persistent);
+
     /**
      * @brief Build the buffers and information for the communication process.
      *
@@ -601,6 +619,120 @@ namespace Dune
     template<class GatherScatter, class Data>
     void backward(Data& data);
 
+    template<class GatherScatter, bool FORWARD, class Data>
+    class ExchangeFuture;
+
+    /**
+     * @brief Start sending from source to target without waiting for the
+     * communication to complete.
+     *
+     * The values are gathered from source into the send buffers and the
+     * messages are posted. The received values are scattered to dest by
+     * wait() or get() of the returned future, or message by message while
+     * polling ready(). Meanwhile one can compute on the entries that are
+     * not received, e.g. the interior ones.
+     *
+     * The communicator, source and dest have to stay alive and source must
+     * not be changed until the communication completed, as it might be
+     * sent without copying (see setZeroCopyRunLength()). Only one
+     * communication of a communicator may be pending at a time.
+     *
+     * @see forward(const Data&, Data&) for the requirements on GatherScatter.
+     * @param source The values will be copied from here to the send buffers.
+     * @param dest The received values will be copied to here.
+     * @return A future completing the communication.
+     */
+    template<class GatherScatter, class Data>
+    ExchangeFuture<GatherScatter,true,Data> iforward(const Data& source, Data& dest);
+
+    /**
+     * @brief Start sending from target to source without waiting for the
+     * communication to complete.
+     *
+     * @see iforward(const Data&, Data&) for the semantics and
+     * backward(Data&, const Data&) for the requirements on GatherScatter.
+     * @param source The received values will be copied to here.
+     * @param dest The values will be copied from here to the send buffers.
+     * @return A future completing the communication.
+     */
+    template<class GatherScatter, class Data>
+    ExchangeFuture<GatherScatter,false,Data> ibackward(Data& source, const Data& dest);
+
+    /**
+     * @brief Start a forward send where target and source are the same.
+     *
+     * @see iforward(const Data&, Data&)
+     * @param data Source and target of the communication.
+     * @return A future completing the communication.
+     */
+    template<class GatherScatter, class Data>
+    ExchangeFuture<GatherScatter,true,Data> iforward(Data& data);
+
+    /**
+     * @brief Start a backward send where target and source are the same.
+     *
+     * @see iforward(const Data&, Data&)
+     * @param data Source and target of the communication.
+     * @return A future completing the communication.
+     */
+    template<class GatherScatter, class Data>
+    ExchangeFuture<GatherScatter,false,Data> ibackward(Data& data);
+
+    /**
+     * @brief Whether the communicator uses persistent requests.
+     */
+    bool persistent() const
+    {
+      return persistent_;
+    }
+
+    /**
+     * @brief Set the average length of the contiguous runs of a message
+     * from which on it is sent or received without copying.
+     *
+     * If the data is stored contiguously, i.e. data() points to the entries,
+     * and it is communicated with CopyGatherScatter, the messages of a
+     * neighbour can be sent from and received into the data directly using
+     * an MPI datatype instead of copying the entries to and from the
+     * communication buffers. build() sets up such a datatype for each
+     * message whose index list consists of contiguous runs of at least this
+     * average length. By default the length is measured once per type by
+     * comparing MPI_Pack for an indexed datatype with copying the entries.
+     *
+     * Use 0 to always and std::numeric_limits<double>::infinity() to never
+     * avoid the copies. Takes effect in the next call of build(). Messages
+     * are always copied if persistent requests are used.
+     */
+    void setZeroCopyRunLength(double length)
+    {
+      zeroCopyRunLength_ = length;
+    }
+
+    /**
+     * @brief Set whether to communicate with neighborhood collectives.
+     *
+     * If enabled, build() creates a distributed graph communicator with
+     * MPI_Dist_graph_create_adjacent whose neighbours are the processes of
+     * the interface, and forward() and backward() exchange all messages
+     * with one MPI_Neighbor_alltoallv (MPI_Ineighbor_alltoallv for
+     * iforward() and ibackward()). This allows the MPI implementation to
+     * optimize for the topology. build() is collective on the communicator
+     * of the interface then. Takes effect in the next call of build().
+     * Persistent requests and datatypes are not used in this mode.
+     */
+    void setNeighborCollectives(bool enable)
+    {
+      neighborCollectives_ = enable;
+    }
+
+    /**
+     * @brief Whether the communicator uses neighborhood collectives.
+     */
+    bool neighborCollectives() const
+    {
+      return neighborCollectives_;
+    }
+
     /**
      * @brief Free the allocated memory (i.e. buffers and message information.
      */
@@ -822,7 +954,7 @@ namespace Dune
     {
       /** @brief Constructor. */
       MessageInformation()
-        : start_(0), size_(0)
+        : start_(0), size_(0), datatype_(MPI_DATATYPE_NULL)
       {}
 
       /**
@@ -833,7 +965,7 @@ namespace Dune
        * @param size The size of the message in bytes.
        */
       MessageInformation(size_t start, size_t size)
-        : start_(start), size_(size)
+        : start_(start), size_(size), datatype_(MPI_DATATYPE_NULL)
       {}
       /**
        * @brief Start of the message in the buffer counted in number of value.
@@ -843,6 +975,11 @@ namespace Dune
        * @brief Number of bytes in the message.
        */
       size_t size_;
+      /**
+       * @brief The datatype addressing the entries of the message in the
+       * data, or MPI_DATATYPE_NULL if the message is copied.
+       */
+      MPI_Datatype datatype_;
     };
 
     /**
@@ -878,6 +1015,153 @@ namespace Dune
 
     MPI_Comm communicator_;
 
+    /**
+     * @brief Whether persistent requests are set up in build().
+     */
+    bool persistent_;
+
+    /**
+     * @brief The requests of one communication direction.
+     */
+    struct Requests
+    {
+      /** @brief The receive requests of the messages that are not empty. */
+      std::vector<MPI_Request> recv;
+      /** @brief The rank each receive request is from. */
+      std::vector<int> recvProcs;
+      /** @brief The send requests of the messages that are not empty. */
+      std::vector<MPI_Request> send;
+    };
+
+    /**
+     * @brief The persistent requests for forward (0) and backward (1) communication.
+     */
+    Requests persistentRequests_[2];
+
+    /**
+     * @brief The run length from which on messages are not copied, negative if measured.
+     */
+    double zeroCopyRunLength_;
+
+    /**
+     * @brief Whether a datatype was set up for any message.
+     */
+    bool zeroCopy_;
+
+    /**
+     * @brief Whether an index is both sent and received, so that in-place
+     * communication has to copy the messages.
+     */
+    bool zeroCopyAliasing_;
+
+    /**
+     * @brief The type of data() of Data.
+     */
+    template<class Data>
+    using DataPointer = decltype(std::declval<const Data&>().data());
+
+    /**
+     * @brief Whether Data may be communicated without copying using GatherScatter.
+     */
+    template<class Data, class GatherScatter>
+    static constexpr bool zeroCopyable()
+    {
+      typedef typename CommPolicy<Data>::IndexedType Type;
+      return std::is_same<GatherScatter, CopyGatherScatter<Data> >::value
+        && std::is_same<typename CommPolicy<Data>::IndexedTypeFlag, SizeOne>::value
+        && std::is_same<Std::detected_t<DataPointer, Data>, const Type*>::value;
+    }
+
+    /**
+     * @brief Measure the average run length from which on sending with an
+     * indexed datatype is cheaper than copying the entries.
+     */
+    template<class Type>
+    static double measureZeroCopyRunLength();
+
+    /**
+     * @brief Set up the datatypes for the messages with long contiguous runs.
+     */
+    template<class Data>
+    void createDatatypes();
+
+    /**
+     * @brief Set up the datatype of a message if its runs are long enough.
+     */
+    template<class Type>
+    static void createDatatype(const InterfaceInformation& indices, MessageInformation& info,
+                               double runLength);
+
+    /**
+     * @brief Free the datatypes of the messages.
+     */
+    void freeDatatypes();
+
+    /**
+     * @brief Whether to use neighborhood collectives in the next build.
+     */
+    bool neighborCollectives_;
+
+    /**
+     * @brief The distributed graph communicator of the neighbours, or
+     * MPI_COMM_NULL if point-to-point messages are used.
+     */
+    MPI_Comm graphComm_;
+
+    /**
+     * @brief The message sizes in bytes for each neighbour of the graph, in
+     * buffers_[0] (0) and buffers_[1] (1).
+     */
+    std::vector<int> neighborCounts_[2];
+
+    /**
+     * @brief The offsets of the messages in bytes for each neighbour of the
+     * graph, in buffers_[0] (0) and buffers_[1] (1).
+     */
+    std::vector<int> neighborDispls_[2];
+
+    /**
+     * @brief Create the distributed graph communicator of the neighbours.
+     */
+    template<class Data>
+    void createNeighborGraph();
+
+    /**
+     * @brief Free the distributed graph communicator.
+     */
+    void freeNeighborGraph();
+
+    /**
+     * @brief Copy the values to send to the buffer.
+     * @return Whether the messages with a datatype are sent from and received
+     * into the data directly.
+     */
+    template<class GatherScatter, bool FORWARD, class Data>
+    bool gatherMessages(const Data& source, const Data& dest);
+
+    /**
+     * @brief Scatter all received messages of a neighborhood collective.
+     */
+    template<class GatherScatter, bool FORWARD, class Data>
+    void scatterNeighborMessages(Data& dest) const;
+
+    /**
+     * @brief Set up the persistent requests for both directions.
+     */
+    template<class Data>
+    void createPersistentRequests();
+
+    /**
+     * @brief Free the persistent requests.
+     */
+    void freePersistentRequests();
+
+    /**
+     * @brief Gather Data and start sending and receiving it.
+     */
+    template<class GatherScatter, bool FORWARD, class Data>
+    ExchangeFuture<GatherScatter,FORWARD,Data> startSendRecv(const Data& source, Data& target);
+
     /**
      * @brief Send and receive Data.
      */
@@ -886,6 +1170,215 @@ namespace Dune
 
   };
 
+  /**
+   * @brief A future for a communication started by
+   * BufferedCommunicator::iforward() or BufferedCommunicator::ibackward().
+   *
+   * It provides the interface of Future<void>: wait() completes the
+   * communication and scatters the received values, ready() scatters the
+   * messages that arrived so far and tests whether the communication
+   * completed, and get() additionally invalidates the future. A future that
+   * is destroyed while still pending completes the communication.
+   */
+  template<class GatherScatter, bool FORWARD, class Data>
+  class BufferedCommunicator::ExchangeFuture
+  {
+    friend class BufferedCommunicator;
+
+    typedef typename CommPolicy<Data>::IndexedType Type;
+    typedef typename CommPolicy<Data>::IndexedTypeFlag Flag;
+
+    ExchangeFuture(BufferedCommunicator& communicator, Data& dest, bool zeroCopy)
+      : communicator_(&communicator), dest_(&dest), zeroCopy_(zeroCopy), received_(0), complete_(false)
+    {}
+
+  public:
+    /**
+     * @brief Constructs an invalid future.
+     */
+    ExchangeFuture()
+      : communicator_(nullptr), dest_(nullptr), zeroCopy_(false), received_(0), complete_(true)
+    {}
+
+    ExchangeFuture(ExchangeFuture&& other)
+      : communicator_(std::exchange(other.communicator_, nullptr)), dest_(other.dest_),
+        zeroCopy_(other.zeroCopy_), own_(std::move(other.own_)), indices_(std::move(other.indices_)),
+        statuses_(std::move(other.statuses_)), received_(other.received_), complete_(other.complete_)
+    {}
+
+    ExchangeFuture& operator=(ExchangeFuture&& other)
+    {
+      if(this != &other) {
+        if(valid())
+          wait();
+        communicator_ = std::exchange(other.communicator_, nullptr);
+        dest_ = other.dest_;
+        zeroCopy_ = other.zeroCopy_;
+        own_ = std::move(other.own_);
+        indices_ = std::move(other.indices_);
+        statuses_ = std::move(other.statuses_);
+        received_ = other.received_;
+        complete_ = other.complete_;
+      }
+      return *this;
+    }
+
+    ~ExchangeFuture()
+    {
+      if(valid())
+        wait();
+    }
+
+    /**
+     * @brief Whether the future refers to a communication.
+     */
+    bool valid() const
+    {
+      return communicator_ != nullptr;
+    }
+
+    /**
+     * @brief Wait for the communication to complete and scatter the
+     * received values.
+     */
+    void wait()
+    {
+      if(!valid())
+        DUNE_THROW(InvalidFutureException, "The ExchangeFuture is not valid!");
+      if(complete_)
+        return;
+      Requests& requests = this->requests();
+
+      // Wait for completion of receive and immediately start scatter
+      MPI_Status status;
+      while(received_ < requests.recv.size()) {
+        int finished = MPI_UNDEFINED;
+        status.MPI_ERROR=MPI_SUCCESS;
+        MPI_Waitany(requests.recv.size(), requests.recv.data(), &finished, &status);
+        assert(finished != MPI_UNDEFINED);
+        scatter(finished, status);
+      }
+
+      // Wait for completion of sends
+      if(!requests.send.empty()
+         && MPI_SUCCESS!=MPI_Waitall(requests.send.size(), requests.send.data(), MPI_STATUSES_IGNORE))
+        std::cerr<<rank()<<": MPI_Error occurred while sending messages"<<std::endl;
+      complete_ = true;
+    }
+
+    /**
+     * @brief Scatter the messages received so far and test whether the
+     * communication completed.
+     */
+    bool ready() const
+    {
+      if(!valid())
+        DUNE_THROW(InvalidFutureException, "The ExchangeFuture is not valid!");
+      if(complete_)
+        return true;
+      Requests& requests = this->requests();
+
+      const std::size_t size = requests.recv.size();
+      if(received_ < size) {
+        int count = 0;
+        for(MPI_Status& status : statuses_)
+          status.MPI_ERROR=MPI_SUCCESS;
+        MPI_Testsome(size, requests.recv.data(), &count, indices_.data(), statuses_.data());
+        assert(count != MPI_UNDEFINED);
+        for(int i=0; i < count; ++i)
+          scatter(indices_[i], statuses_[i]);
+        if(received_ < size)
+          return false;
+      }
+
+      int flag = 1;
+      if(!requests.send.empty())
+        MPI_Testall(requests.send.size(), requests.send.data(), &flag, MPI_STATUSES_IGNORE);
+      complete_ = flag;
+      return complete_;
+    }
+
+    /**
+     * @brief Wait for the communication to complete and invalidate the
+     * future.
+     */
+    void get()
+    {
+      wait();
+      communicator_ = nullptr;
+    }
+
+  private:
+    /**
+     * @brief The requests of the communication.
+     *
+     * These are the persistent requests of the communicator or the
+     * requests posted for this communication.
+     */
+    Requests& requests() const
+    {
+      return communicator_->persistent_ && communicator_->graphComm_ == MPI_COMM_NULL ?
+        communicator_->persistentRequests_[FORWARD ? 0 : 1] : own_;
+    }
+
+    /**
+     * @brief Allocate the arrays for testing the receive requests once
+     * they are posted, so that polling ready() does not allocate.
+     */
+    void started()
+    {
+      indices_.resize(requests().recv.size());
+      statuses_.resize(requests().recv.size());
+    }
+
+    /**
+     * @brief Scatter the values of the i-th receive request.
+     */
+    void scatter(int i, const MPI_Status& status) const
+    {
+      ++received_;
+      if(communicator_->graphComm_ != MPI_COMM_NULL) {
+        // the only request is the neighborhood collective
+        communicator_->template scatterNeighborMessages<GatherScatter,FORWARD>(*dest_);
+        return;
+      }
+      const int proc = requests().recvProcs[i];
+      if(status.MPI_ERROR==MPI_SUCCESS) {
+        typename InformationMap::const_iterator infoIter = communicator_->messageInformation_.find(proc);
+        assert(infoIter != communicator_->messageInformation_.end());
+
+        const MessageInformation& info = FORWARD ? infoIter->second.second : infoIter->second.first;
+        if(zeroCopy_ && info.datatype_ != MPI_DATATYPE_NULL)
+          // received directly into the data
+          return;
+        Type* recvBuffer = reinterpret_cast<Type*>(communicator_->buffers_[FORWARD ? 1 : 0]);
+        MessageScatterer<Data,GatherScatter,FORWARD,Flag>() (communicator_->interfaces_, *dest_, recvBuffer+info.start_, proc);
+      }else{
+        std::cerr<<rank()<<": MPI_Error occurred while receiving message from "<<proc<<std::endl;
+      }
+    }
+
+    int rank() const
+    {
+      int rank;
+      MPI_Comm_rank(communicator_->communicator_, &rank);
+      return rank;
+    }
+
+    BufferedCommunicator* communicator_;
+    Data* dest_;
+    /** @brief Whether the messages with a datatype are received without copying. */
+    bool zeroCopy_;
+    /** @brief The requests if the communicator does not use persistent ones. */
+    mutable Requests own_;
+    /** @brief The indices and statuses of the receive requests completed in ready(). */
+    mutable std::vector<int> indices_;
+    mutable std::vector<MPI_Status> statuses_;
+    /** @brief The number of messages received and scattered. */
+    mutable std::size_t received_;
+    mutable bool complete_;
+  };
+
 #ifndef DOXYGEN
 
   template<class V>
@@ -1123,6 +1616,12 @@ namespace Dune
   }
 
   inline BufferedCommunicator::BufferedCommunicator()
+    : BufferedCommunicator(false)
+  {}
+
+  inline BufferedCommunicator::BufferedCommunicator(bool persistent)
+    : persistent_(persistent), zeroCopyRunLength_(-1), zeroCopy_(false), zeroCopyAliasing_(false),
+      neighborCollectives_(false), graphComm_(MPI_COMM_NULL)
   {
     buffers_[0]=0;
     buffers_[1]=0;
@@ -1166,6 +1665,13 @@ namespace Dune
 
     buffers_[0] = new char[bufferSize_[0]];
     buffers_[1] = new char[bufferSize_[1]];
+
+    if(neighborCollectives_)
+      createNeighborGraph<Data>();
+    else if(persistent_)
+      createPersistentRequests<Data>();
+    else
+      createDatatypes<Data>();
   }
 
   template<class Data, class Interface>
@@ -1201,10 +1707,216 @@ namespace Dune
     // allocate the buffers
     buffers_[0] = new char[bufferSize_[0]];
     buffers_[1] = new char[bufferSize_[1]];
+
+    if(neighborCollectives_)
+      createNeighborGraph<Data>();
+    else if(persistent_)
+      createPersistentRequests<Data>();
+    else
+      createDatatypes<Data>();
+  }
+
+  template<class Data>
+  void BufferedCommunicator::createPersistentRequests()
+  {
+    typedef typename CommPolicy<Data>::IndexedType Type;
+    freePersistentRequests();
+
+    for(int direction=0; direction < 2; ++direction) {
+      // forward sends from buffers_[0] and receives into buffers_[1], backward vice versa
+      const bool forward = direction==0;
+      char* sendBuffer = buffers_[forward ? 0 : 1];
+      char* recvBuffer = buffers_[forward ? 1 : 0];
+      Requests& requests = persistentRequests_[direction];
+
+      typedef typename InformationMap::const_iterator const_iterator;
+      const const_iterator end = messageInformation_.end();
+      for(const_iterator info = messageInformation_.begin(); info != end; ++info) {
+        const MessageInformation& recvInfo = forward ? info->second.second : info->second.first;
+        const MessageInformation& sendInfo = forward ? info->second.first : info->second.second;
+        if(recvInfo.size_) {
+          requests.recv.push_back(MPI_REQUEST_NULL);
+          requests.recvProcs.push_back(info->first);
+          MPI_Recv_init(recvBuffer+recvInfo.start_*sizeof(Type), recvInfo.size_,
+                        MPI_BYTE, info->first, commTag_, communicator_,
+                        &requests.recv.back());
+        }
+        if(sendInfo.size_) {
+          requests.send.push_back(MPI_REQUEST_NULL);
+          MPI_Ssend_init(sendBuffer+sendInfo.start_*sizeof(Type), sendInfo.size_,
+                         MPI_BYTE, info->first, commTag_, communicator_,
+                         &requests.send.back());
+        }
+      }
+    }
+  }
+
+  inline void BufferedCommunicator::freePersistentRequests()
+  {
+    int finalized=0;
+    MPI_Finalized(&finalized);
+    for(Requests& requests : persistentRequests_) {
+      if(!finalized) {
+        for(MPI_Request& request : requests.recv)
+          MPI_Request_free(&request);
+        for(MPI_Request& request : requests.send)
+          MPI_Request_free(&request);
+      }
+      requests.recv.clear();
+      requests.recvProcs.clear();
+      requests.send.clear();
+    }
+  }
+
+  template<class Type>
+  double BufferedCommunicator::measureZeroCopyRunLength()
+  {
+    // Gather every second entry, once by copying and once by packing an
+    // indexed datatype with runs of length one, and take the fastest of some
+    // repetitions. Longer runs spread the overhead per run of the datatype.
+    const int runs = 1024;
+    std::vector<Type> data(2*runs), buffer(runs);
+    std::vector<int> blocklengths(runs, sizeof(Type));
+    std::vector<MPI_Aint> displacements(runs);
+    for(int i=0; i < runs; i++)
+      displacements[i] = 2*i*sizeof(Type);
+    MPI_Datatype datatype;
+    MPI_Type_create_hindexed(runs, blocklengths.data(), displacements.data(), MPI_BYTE, &datatype);
+    MPI_Type_commit(&datatype);
+
+    double copyTime = std::numeric_limits<double>::max();
+    double packTime = std::numeric_limits<double>::max();
+    for(int repetition=0; repetition < 20; repetition++) {
+      double start = MPI_Wtime();
+      for(int i=0; i < runs; i++)
+        buffer[i] = data[2*i];
+      copyTime = std::min(copyTime, MPI_Wtime() - start);
+
+      int position = 0;
+      start = MPI_Wtime();
+      MPI_Pack(data.data(), 1, datatype, buffer.data(), runs*sizeof(Type), &position, MPI_COMM_SELF);
+      packTime = std::min(packTime, MPI_Wtime() - start);
+    }
+    MPI_Type_free(&datatype);
+    return copyTime > 0 ? std::max(1.0, packTime/copyTime) : 1.0;
+  }
+
+  template<class Type>
+  void BufferedCommunicator::createDatatype(const InterfaceInformation& indices, MessageInformation& info,
+                                            double runLength)
+  {
+    if(indices.size() == 0)
+      return;
+    std::vector<int> blocklengths;
+    std::vector<MPI_Aint> displacements;
+    for(size_t i=0; i < indices.size(); i++)
+      if(i > 0 && indices[i] == indices[i-1]+1)
+        blocklengths.back() += sizeof(Type);
+      else{
+        blocklengths.push_back(sizeof(Type));
+        displacements.push_back(indices[i]*sizeof(Type));
+      }
+    // copying is cheaper for short runs
+    if(indices.size() < runLength*blocklengths.size())
+      return;
+    MPI_Type_create_hindexed(blocklengths.size(), blocklengths.data(), displacements.data(),
+                             MPI_BYTE, &info.datatype_);
+    MPI_Type_commit(&info.datatype_);
+  }
+
+  template<class Data>
+  void BufferedCommunicator::createDatatypes()
+  {
+    typedef typename CommPolicy<Data>::IndexedType Type;
+    freeDatatypes();
+    if constexpr (zeroCopyable<Data,CopyGatherScatter<Data> >()) {
+      static const double measuredRunLength = measureZeroCopyRunLength<Type>();
+      const double runLength = zeroCopyRunLength_ < 0 ? measuredRunLength : zeroCopyRunLength_;
+
+      std::vector<std::size_t> sent;
+      typedef typename InformationMap::iterator iterator;
+      for(iterator info = messageInformation_.begin(); info != messageInformation_.end(); ++info) {
+        const std::pair<InterfaceInformation,InterfaceInformation>& indices = interfaces_[info->first];
+        createDatatype<Type>(indices.first, info->second.first, runLength);
+        createDatatype<Type>(indices.second, info->second.second, runLength);
+        zeroCopy_ = zeroCopy_ || info->second.first.datatype_ != MPI_DATATYPE_NULL
+          || info->second.second.datatype_ != MPI_DATATYPE_NULL;
+        for(size_t i=0; i < indices.first.size(); i++)
+          sent.push_back(indices.first[i]);
+      }
+
+      // In-place communication may only skip the copies if no index is both
+      // sent and received.
+      std::sort(sent.begin(), sent.end());
+      for(iterator info = messageInformation_.begin(); info != messageInformation_.end(); ++info) {
+        const InterfaceInformation& received = interfaces_[info->first].second;
+        for(size_t i=0; i < received.size(); i++)
+          zeroCopyAliasing_ = zeroCopyAliasing_
+            || std::binary_search(sent.begin(), sent.end(), std::size_t(received[i]));
+      }
+    }
+  }
+
+  inline void BufferedCommunicator::freeDatatypes()
+  {
+    int finalized=0;
+    MPI_Finalized(&finalized);
+    typedef typename InformationMap::iterator iterator;
+    for(iterator info = messageInformation_.begin(); info != messageInformation_.end(); ++info)
+      for(MPI_Datatype* datatype : {&info->second.first.datatype_, &info->second.second.datatype_})
+        if(*datatype != MPI_DATATYPE_NULL) {
+          if(!finalized)
+            MPI_Type_free(datatype);
+          *datatype = MPI_DATATYPE_NULL;
+        }
+    zeroCopy_ = false;
+    zeroCopyAliasing_ = false;
+  }
+
+  template<class Data>
+  void BufferedCommunicator::createNeighborGraph()
+  {
+    typedef typename CommPolicy<Data>::IndexedType Type;
+    freeNeighborGraph();
+
+    // Every neighbour both sends and receives, possibly empty messages, as
+    // the interface is symmetric.
+    std::vector<int> neighbors;
+    typedef typename InformationMap::const_iterator const_iterator;
+    const const_iterator end = messageInformation_.end();
+    for(const_iterator info = messageInformation_.begin(); info != end; ++info) {
+      neighbors.push_back(info->first);
+      neighborCounts_[0].push_back(info->second.first.size_);
+      neighborDispls_[0].push_back(info->second.first.start_*sizeof(Type));
+      neighborCounts_[1].push_back(info->second.second.size_);
+      neighborDispls_[1].push_back(info->second.second.start_*sizeof(Type));
+    }
+    MPI_Dist_graph_create_adjacent(communicator_,
+                                   neighbors.size(), neighbors.data(), MPI_UNWEIGHTED,
+                                   neighbors.size(), neighbors.data(), MPI_UNWEIGHTED,
+                                   MPI_INFO_NULL, 0, &graphComm_);
+  }
+
+  inline void BufferedCommunicator::freeNeighborGraph()
+  {
+    if(graphComm_ != MPI_COMM_NULL) {
+      int finalized=0;
+      MPI_Finalized(&finalized);
+      if(!finalized)
+        MPI_Comm_free(&graphComm_);
+      graphComm_ = MPI_COMM_NULL;
+    }
+    for(int i=0; i < 2; ++i) {
+      neighborCounts_[i].clear();
+      neighborDispls_[i].clear();
+    }
   }
 
   inline void BufferedCommunicator::free()
   {
+    freePersistentRequests();
+    freeDatatypes();
+    freeNeighborGraph();
     messageInformation_.clear();
     if(buffers_[0])
       delete[] buffers_[0];
@@ -1375,153 +2087,177 @@ namespace Dune
   }
 
 
-  template<class GatherScatter, bool FORWARD, class Data>
-  void BufferedCommunicator::sendRecv(const Data& source, Data& dest)
+  template<class GatherScatter, class Data>
+  BufferedCommunicator::ExchangeFuture<GatherScatter,true,Data>
+  BufferedCommunicator::iforward(Data& data)
+  {
+    return this->template startSendRecv<GatherScatter,true>(data, data);
+  }
+
+
+  template<class GatherScatter, class Data>
+  BufferedCommunicator::ExchangeFuture<GatherScatter,false,Data>
+  BufferedCommunicator::ibackward(Data& data)
   {
-    int rank, lrank;
+    return this->template startSendRecv<GatherScatter,false>(data, data);
+  }
+
+
+  template<class GatherScatter, class Data>
+  BufferedCommunicator::ExchangeFuture<GatherScatter,true,Data>
+  BufferedCommunicator::iforward(const Data& source, Data& dest)
+  {
+    return this->template startSendRecv<GatherScatter,true>(source, dest);
+  }
+
+
+  template<class GatherScatter, class Data>
+  BufferedCommunicator::ExchangeFuture<GatherScatter,false,Data>
+  BufferedCommunicator::ibackward(Data& source, const Data& dest)
+  {
+    return this->template startSendRecv<GatherScatter,false>(dest, source);
+  }
 
-    MPI_Comm_rank(MPI_COMM_WORLD,&rank);
-    MPI_Comm_rank(MPI_COMM_WORLD,&lrank);
 
+  template<class GatherScatter, bool FORWARD, class Data>
+  bool BufferedCommunicator::gatherMessages(const Data& source, const Data& dest)
+  {
     typedef typename CommPolicy<Data>::IndexedType Type;
-    Type *sendBuffer, *recvBuffer;
-    size_t sendBufferSize;
-#ifndef NDEBUG
-    size_t recvBufferSize;
-#endif
+    typedef typename CommPolicy<Data>::IndexedTypeFlag Flag;
+    Type* sendBuffer = reinterpret_cast<Type*>(buffers_[FORWARD ? 0 : 1]);
+
+    // Whether the messages with a datatype are sent from and received into the data directly
+    const bool zeroCopy = zeroCopyable<Data,GatherScatter>() && zeroCopy_
+      && (static_cast<const void*>(&source) != static_cast<const void*>(&dest) || !zeroCopyAliasing_);
+
+    if(zeroCopy) {
+      // Only copy the messages without a datatype to the buffer
+      typedef typename InformationMap::const_iterator const_iterator;
+      const const_iterator end = messageInformation_.end();
+      for(const_iterator info = messageInformation_.begin(); info != end; ++info) {
+        const MessageInformation& sendInfo = FORWARD ? info->second.first : info->second.second;
+        if(sendInfo.datatype_ != MPI_DATATYPE_NULL)
+          continue;
+        const std::pair<InterfaceInformation,InterfaceInformation>& indices = interfaces_.find(info->first)->second;
+        const InterfaceInformation& sendIndices = FORWARD ? indices.first : indices.second;
+        for(size_t i=0; i < sendIndices.size(); i++)
+          sendBuffer[sendInfo.start_+i] = GatherScatter::gather(source, sendIndices[i]);
+      }
+    }else
+      MessageGatherer<Data,GatherScatter,FORWARD,Flag>() (interfaces_, source, sendBuffer, bufferSize_[FORWARD ? 0 : 1]);
+    return zeroCopy;
+  }
 
-    if(FORWARD) {
-      sendBuffer = reinterpret_cast<Type*>(buffers_[0]);
-      sendBufferSize = bufferSize_[0];
-      recvBuffer = reinterpret_cast<Type*>(buffers_[1]);
-#ifndef NDEBUG
-      recvBufferSize = bufferSize_[1];
-#endif
-    }else{
-      sendBuffer = reinterpret_cast<Type*>(buffers_[1]);
-      sendBufferSize = bufferSize_[1];
-      recvBuffer = reinterpret_cast<Type*>(buffers_[0]);
-#ifndef NDEBUG
-      recvBufferSize = bufferSize_[0];
-#endif
-    }
+  template<class GatherScatter, bool FORWARD, class Data>
+  void BufferedCommunicator::scatterNeighborMessages(Data& dest) const
+  {
+    typedef typename CommPolicy<Data>::IndexedType Type;
     typedef typename CommPolicy<Data>::IndexedTypeFlag Flag;
+    Type* recvBuffer = reinterpret_cast<Type*>(buffers_[FORWARD ? 1 : 0]);
 
-    MessageGatherer<Data,GatherScatter,FORWARD,Flag>() (interfaces_, source, sendBuffer, sendBufferSize);
+    typedef typename InformationMap::const_iterator const_iterator;
+    const const_iterator end = messageInformation_.end();
+    for(const_iterator info = messageInformation_.begin(); info != end; ++info) {
+      const MessageInformation& recvInfo = FORWARD ? info->second.second : info->second.first;
+      if(recvInfo.size_)
+        MessageScatterer<Data,GatherScatter,FORWARD,Flag>() (interfaces_, dest, recvBuffer+recvInfo.start_, info->first);
+    }
+  }
 
-    MPI_Request* sendRequests = new MPI_Request[messageInformation_.size()];
-    MPI_Request* recvRequests = new MPI_Request[messageInformation_.size()];
-    /* Number of recvRequests that are not MPI_REQUEST_NULL */
-    size_t numberOfRealRecvRequests = 0;
+  template<class GatherScatter, bool FORWARD, class Data>
+  BufferedCommunicator::ExchangeFuture<GatherScatter,FORWARD,Data>
+  BufferedCommunicator::startSendRecv(const Data& source, Data& dest)
+  {
+    typedef typename CommPolicy<Data>::IndexedType Type;
+    Type* sendBuffer = reinterpret_cast<Type*>(buffers_[FORWARD ? 0 : 1]);
+    Type* recvBuffer = reinterpret_cast<Type*>(buffers_[FORWARD ? 1 : 0]);
+
+    const bool zeroCopy = this->template gatherMessages<GatherScatter,FORWARD>(source, dest);
+
+    ExchangeFuture<GatherScatter,FORWARD,Data> future(*this, dest, zeroCopy);
+    Requests& requests = future.requests();
+
+    if(graphComm_ != MPI_COMM_NULL) {
+      const int send = FORWARD ? 0 : 1;
+      const int recv = FORWARD ? 1 : 0;
+      requests.recv.push_back(MPI_REQUEST_NULL);
+      MPI_Ineighbor_alltoallv(buffers_[send], neighborCounts_[send].data(), neighborDispls_[send].data(), MPI_BYTE,
+                              buffers_[recv], neighborCounts_[recv].data(), neighborDispls_[recv].data(), MPI_BYTE,
+                              graphComm_, &requests.recv.back());
+      future.started();
+      return future;
+    }
 
-    // Setup receive first
-    typedef typename InformationMap::const_iterator const_iterator;
+    if(persistent_) {
+      // Start the receives first
+      if(!requests.recv.empty())
+        MPI_Startall(requests.recv.size(), requests.recv.data());
+      if(!requests.send.empty())
+        MPI_Startall(requests.send.size(), requests.send.data());
+      future.started();
+      return future;
+    }
 
+    typedef typename InformationMap::const_iterator const_iterator;
     const const_iterator end = messageInformation_.end();
-    size_t i=0;
-    int* processMap = new int[messageInformation_.size()];
-
-    for(const_iterator info = messageInformation_.begin(); info != end; ++info, ++i) {
-      processMap[i]=info->first;
-      if(FORWARD) {
-        assert(info->second.second.start_*sizeof(typename CommPolicy<Data>::IndexedType)+info->second.second.size_ <= recvBufferSize );
-        Dune::dvverb<<rank<<": receiving "<<info->second.second.size_<<" from "<<info->first<<std::endl;
-        if(info->second.second.size_) {
-          MPI_Irecv(recvBuffer+info->second.second.start_, info->second.second.size_,
-                    MPI_BYTE, info->first, commTag_, communicator_,
-                    recvRequests+i);
-          numberOfRealRecvRequests += 1;
-        } else {
-          // Nothing to receive -> set request to inactive
-          recvRequests[i]=MPI_REQUEST_NULL;
-        }
-      }else{
-        assert(info->second.first.start_*sizeof(typename CommPolicy<Data>::IndexedType)+info->second.first.size_ <= recvBufferSize );
-        Dune::dvverb<<rank<<": receiving "<<info->second.first.size_<<" to "<<info->first<<std::endl;
-        if(info->second.first.size_) {
-          MPI_Irecv(recvBuffer+info->second.first.start_, info->second.first.size_,
+    requests.recv.reserve(messageInformation_.size());
+    requests.recvProcs.reserve(messageInformation_.size());
+    requests.send.reserve(messageInformation_.size());
+
+    // Setup receive first
+    for(const_iterator info = messageInformation_.begin(); info != end; ++info) {
+      const MessageInformation& recvInfo = FORWARD ? info->second.second : info->second.first;
+      assert(recvInfo.start_*sizeof(Type)+recvInfo.size_ <= bufferSize_[FORWARD ? 1 : 0]);
+      Dune::dvverb<<"receiving "<<recvInfo.size_<<" from "<<info->first<<std::endl;
+      if(recvInfo.size_) {
+        requests.recv.push_back(MPI_REQUEST_NULL);
+        requests.recvProcs.push_back(info->first);
+        if(zeroCopy && recvInfo.datatype_ != MPI_DATATYPE_NULL)
+          MPI_Irecv(const_cast<void*>(CommPolicy<Data>::getAddress(dest, 0)), 1,
+                    recvInfo.datatype_, info->first, commTag_, communicator_,
+                    &requests.recv.back());
+        else
+          MPI_Irecv(recvBuffer+recvInfo.start_, recvInfo.size_,
                     MPI_BYTE, info->first, commTag_, communicator_,
-                    recvRequests+i);
-          numberOfRealRecvRequests += 1;
-        } else {
-          // Nothing to receive -> set request to inactive
-          recvRequests[i]=MPI_REQUEST_NULL;
-        }
+                    &requests.recv.back());
       }
     }
 
     // now the send requests
-    i=0;
-    for(const_iterator info = messageInformation_.begin(); info != end; ++info, ++i)
-      if(FORWARD) {
-        assert(info->second.second.start_*sizeof(typename CommPolicy<Data>::IndexedType)+info->second.second.size_ <= recvBufferSize );
-        Dune::dvverb<<rank<<": sending "<<info->second.first.size_<<" to "<<info->first<<std::endl;
-        assert(info->second.first.start_*sizeof(typename CommPolicy<Data>::IndexedType)+info->second.first.size_ <= sendBufferSize );
-        if(info->second.first.size_)
-          MPI_Issend(sendBuffer+info->second.first.start_, info->second.first.size_,
-                     MPI_BYTE, info->first, commTag_, communicator_,
-                     sendRequests+i);
+    for(const_iterator info = messageInformation_.begin(); info != end; ++info) {
+      const MessageInformation& sendInfo = FORWARD ? info->second.first : info->second.second;
+      assert(sendInfo.start_*sizeof(Type)+sendInfo.size_ <= bufferSize_[FORWARD ? 0 : 1]);
+      Dune::dvverb<<"sending "<<sendInfo.size_<<" to "<<info->first<<std::endl;
+      if(sendInfo.size_) {
+        requests.send.push_back(MPI_REQUEST_NULL);
+        if(zeroCopy && sendInfo.datatype_ != MPI_DATATYPE_NULL)
+          MPI_Issend(CommPolicy<Data>::getAddress(source, 0), 1,
+                     sendInfo.datatype_, info->first, commTag_, communicator_,
+                     &requests.send.back());
         else
-          // Nothing to send -> set request to inactive
-          sendRequests[i]=MPI_REQUEST_NULL;
-      }else{
-        assert(info->second.second.start_*sizeof(typename CommPolicy<Data>::IndexedType)+info->second.second.size_ <= sendBufferSize );
-        Dune::dvverb<<rank<<": sending "<<info->second.second.size_<<" to "<<info->first<<std::endl;
-        if(info->second.second.size_)
-          MPI_Issend(sendBuffer+info->second.second.start_, info->second.second.size_,
+          MPI_Issend(sendBuffer+sendInfo.start_, sendInfo.size_,
                      MPI_BYTE, info->first, commTag_, communicator_,
-                     sendRequests+i);
-        else
-          // Nothing to send -> set request to inactive
-          sendRequests[i]=MPI_REQUEST_NULL;
-      }
-
-    // Wait for completion of receive and immediately start scatter
-    i=0;
-    //int success = 1;
-    int finished = MPI_UNDEFINED;
-    MPI_Status status; //[messageInformation_.size()];
-    //MPI_Waitall(messageInformation_.size(), recvRequests, status);
-
-    for(i=0; i< numberOfRealRecvRequests; i++) {
-      status.MPI_ERROR=MPI_SUCCESS;
-      MPI_Waitany(messageInformation_.size(), recvRequests, &finished, &status);
-      assert(finished != MPI_UNDEFINED);
-
-      if(status.MPI_ERROR==MPI_SUCCESS) {
-        int& proc = processMap[finished];
-        typename InformationMap::const_iterator infoIter = messageInformation_.find(proc);
-        assert(infoIter != messageInformation_.end());
-
-        MessageInformation info = (FORWARD) ? infoIter->second.second : infoIter->second.first;
-        assert(info.start_+info.size_ <= recvBufferSize);
-
-        MessageScatterer<Data,GatherScatter,FORWARD,Flag>() (interfaces_, dest, recvBuffer+info.start_, proc);
-      }else{
-        std::cerr<<rank<<": MPI_Error occurred while receiving message from "<<processMap[finished]<<std::endl;
-        //success=0;
+                     &requests.send.back());
       }
     }
+    future.started();
+    return future;
+  }
 
-    MPI_Status recvStatus;
-
-    // Wait for completion of sends
-    for(i=0; i< messageInformation_.size(); i++)
-      if(MPI_SUCCESS!=MPI_Wait(sendRequests+i, &recvStatus)) {
-        std::cerr<<rank<<": MPI_Error occurred while sending message to "<<processMap[finished]<<std::endl;
-        //success=0;
-      }
-    /*
-       int globalSuccess;
-       MPI_Allreduce(&success, &globalSuccess, 1, MPI_INT, MPI_MIN, interface_->communicator());
-
-       if(!globalSuccess)
-       DUNE_THROW(CommunicationError, "A communication error occurred!");
-     */
-    delete[] processMap;
-    delete[] sendRequests;
-    delete[] recvRequests;
-
+  template<class GatherScatter, bool FORWARD, class Data>
+  void BufferedCommunicator::sendRecv(const Data& source, Data& dest)
+  {
+    if(graphComm_ != MPI_COMM_NULL) {
+      const int send = FORWARD ? 0 : 1;
+      const int recv = FORWARD ? 1 : 0;
+      this->template gatherMessages<GatherScatter,FORWARD>(source, dest);
+      MPI_Neighbor_alltoallv(buffers_[send], neighborCounts_[send].data(), neighborDispls_[send].data(), MPI_BYTE,
+                             buffers_[recv], neighborCounts_[recv].data(), neighborDispls_[recv].data(), MPI_BYTE,
+                             graphComm_);
+      this->template scatterNeighborMessages<GatherScatter,FORWARD>(dest);
+      return;
+    }
+    this->template startSendRecv<GatherScatter,FORWARD>(source, dest).wait();
   }
 
 #endif  // DOXYGEN
@@ -6,11 +6,17 @@
 #define DUNE_COMMON_PARALLEL_INDEXSET_HH
 
 #include <algorithm>
+#include <cassert>
 #include <cstdint> // for uint32_t
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <type_traits>
+#include <vector>
 
 #include <dune/common/arraylist.hh>
 #include <dune/common/exceptions.hh>
+#include <dune/common/genericiterator.hh>
 #include <dune/common/parallel/localindex.hh>
 #include <dune/common/parallel/mpitraits.hh>
 
@@ -207,11 +213,51 @@ namespace Dune
   // Forward declaration
   template<class I> class GlobalLookupIndexSet;
 
+  namespace Impl
+  {
+    /**
+     * @brief The container storing the index pairs of a ParallelIndexSet.
+     *
+     * For N>0 an ArrayList with chunks of size N, otherwise a std::vector.
+     */
+    template<class P, int N, bool = (N>0)>
+    struct IndexPairStorage
+    {
+      typedef ArrayList<P,N> Container;
+      typedef typename Container::iterator iterator;
+      typedef typename Container::const_iterator const_iterator;
+
+      static iterator begin(Container& c) { return c.begin(); }
+      static iterator end(Container& c) { return c.end(); }
+      static const_iterator begin(const Container& c) { return c.begin(); }
+      static const_iterator end(const Container& c) { return c.end(); }
+    };
+
+    template<class P, int N>
+    struct IndexPairStorage<P,N,false>
+    {
+      typedef std::vector<P> Container;
+      typedef GenericIterator<Container,P> iterator;
+      typedef GenericIterator<const Container,const P> const_iterator;
+
+      static iterator begin(Container& c) { return iterator(c, 0); }
+      static iterator end(Container& c) { return iterator(c, c.size()); }
+      static const_iterator begin(const Container& c) { return const_iterator(c, 0); }
+      static const_iterator end(const Container& c) { return const_iterator(c, c.size()); }
+    };
+  }
+
   /**
    * @brief Manager class for the mapping between local indices and globally unique indices.
    *
    * The mapping is between a globally unique id and local index. The local index is consecutive
    * and non persistent while the global id might not be consecutive but definitely is persistent.
+   *
+   * @tparam N Selects the storage of the index pairs. If positive they are
+   * stored in an ArrayList with arrays of size N. If zero they are stored
+   * contiguously in a std::vector and found by binary search. If negative they
+   * are stored contiguously and additionally a hash table (requiring
+   * std::hash of the global index) finds them in expected constant time.
    */
   template<typename TG, typename TL, int N=100>
   class ParallelIndexSet
@@ -251,11 +297,16 @@ namespace Dune
      */
     constexpr static int arraySize = (N>0) ? N : 1;
 
+  private:
+    /** @brief The container of the pairs and its iterators. */
+    typedef Impl::IndexPairStorage<IndexPair,N> Storage;
+
+  public:
     /** @brief The iterator over the pairs. */
     class iterator :
-      public ArrayList<IndexPair,N>::iterator
+      public Storage::iterator
     {
-      typedef typename ArrayList<IndexPair,N>::iterator
+      typedef typename Storage::iterator
       Father;
       friend class ParallelIndexSet<GlobalIndex,LocalIndex,N>;
     public:
@@ -292,7 +343,7 @@ namespace Dune
 
     /** @brief The constant iterator over the pairs. */
     typedef typename
-    ArrayList<IndexPair,N>::const_iterator
+    Storage::const_iterator
     const_iterator;
 
     /**
@@ -362,8 +413,9 @@ namespace Dune
     /**
      * @brief Find the index pair with a specific global id.
      *
-     * This starts a binary search for the entry and therefore has complexity
-     * log(N).
+     * For N>=0 this starts a binary search for the entry and therefore has
+     * complexity log(n), n being the number of indices. For N<0 the entry is
+     * found by the hash table in expected constant time.
      * @param global The globally unique id of the pair.
      * @return The pair of indices for the id.
      * @warning If the global index is not in the set a wrong or even a
@@ -375,8 +427,9 @@ namespace Dune
     /**
      * @brief Find the index pair with a specific global id.
      *
-     * This starts a binary search for the entry and therefore has complexity
-     * log(N).
+     * For N>=0 this starts a binary search for the entry and therefore has
+     * complexity log(n), n being the number of indices. For N<0 the entry is
+     * found by the hash table in expected constant time.
      * @param global The globally unique id of the pair.
      * @return The pair of indices for the id.
      * @exception RangeError Thrown if the global id is not known.
@@ -387,8 +440,9 @@ namespace Dune
     /**
      * @brief Find the index pair with a specific global id.
      *
-     * This starts a binary search for the entry and therefore has complexity
-     * log(N).
+     * For N>=0 this starts a binary search for the entry and therefore has
+     * complexity log(n), n being the number of indices. For N<0 the entry is
+     * found by the hash table in expected constant time.
      * @param global The globally unique id of the pair.
      * @return The pair of indices for the id.
      * @exception RangeError Thrown if the global id is not known.
@@ -399,8 +453,9 @@ namespace Dune
     /**
      * @brief Find the index pair with a specific global id.
      *
-     * This starts a binary search for the entry and therefore has complexity
-     * log(N).
+     * For N>=0 this starts a binary search for the entry and therefore has
+     * complexity log(n), n being the number of indices. For N<0 the entry is
+     * found by the hash table in expected constant time.
      * @param global The globally unique id of the pair.
      * @return The pair of indices for the id.
      * @warning If the global index is not in the set a wrong or even a
@@ -412,8 +467,9 @@ namespace Dune
     /**
      * @brief Find the index pair with a specific global id.
      *
-     * This starts a binary search for the entry and therefore has complexity
-     * log(N).
+     * For N>=0 this starts a binary search for the entry and therefore has
+     * complexity log(n), n being the number of indices. For N<0 the entry is
+     * found by the hash table in expected constant time.
      * @param global The globally unique id of the pair.
      * @return The pair of indices for the id.
      * @exception RangeError Thrown if the global id is not known.
@@ -472,9 +528,16 @@ namespace Dune
 
   private:
     /** @brief The index pairs. */
-    ArrayList<IndexPair,N> localIndices_;
+    typename Storage::Container localIndices_;
     /** @brief The new indices for the RESIZE state. */
-    ArrayList<IndexPair,N> newIndices_;
+    typename Storage::Container newIndices_;
+    /**
+     * @brief For N<0 the hash table of the positions of the pairs plus one,
+     * zero marking empty buckets.
+     */
+    std::vector<std::uint32_t> hashIndex_;
+    /** @brief The logarithm of the number of buckets in hashIndex_. */
+    int hashBits_;
     /** @brief The state of the index set. */
     ParallelIndexSetState state_;
     /** @brief Number to keep track of the number of resizes. */
@@ -486,6 +549,18 @@ namespace Dune
      * localIndices array.
      */
     inline void merge();
+
+    /**
+     * @brief Rebuild the hash table of the positions for N<0.
+     */
+    inline void buildHashIndex();
+
+    /**
+     * @brief The position of the first pair with a global index in a
+     * contiguous storage.
+     * @return The position or size() if there is no such pair.
+     */
+    inline std::size_t position(const GlobalIndex& global) const;
   };
 
 
@@ -551,8 +626,10 @@ namespace Dune
     /**
      * @brief Find the index pair with a specific global id.
      *
-     * This starts a binary search for the entry and therefore has complexity
-     * log(N). This method is forwarded to the underlying index set.
+     * This method is forwarded to the underlying index set. If it stores the
+     * pairs in chunks (N>0) or in a vector (N==0), a binary search finds the
+     * entry with complexity log(n), n being the number of indices. If it
+     * stores them hashed (N<0), the lookup takes expected constant time.
      * @param global The globally unique id of the pair.
      * @return The pair of indices for the id.
      * @exception RangeError Thrown if the global id is not known.
@@ -760,7 +837,7 @@ namespace Dune
 
   template<class TG, class TL, int N>
   ParallelIndexSet<TG,TL,N>::ParallelIndexSet()
-    : state_(GROUND), seqNo_(0), deletedEntries_()
+    : hashBits_(0), state_(GROUND), seqNo_(0), deletedEntries_()
   {}
 
   template<class TG, class TL, int N>
@@ -835,7 +912,39 @@ namespace Dune
 
   template<class TG, class TL, int N>
   inline void ParallelIndexSet<TG,TL,N>::merge(){
-    if(localIndices_.size()==0)
+    if constexpr (N<=0) {
+      if(localIndices_.size()==0)
+        localIndices_.swap(newIndices_);
+      else if(newIndices_.size()>0 || deletedEntries_)
+      {
+        // merge both sorted ranges into one allocation
+        std::vector<IndexPair> tempPairs;
+        tempPairs.reserve(localIndices_.size()+newIndices_.size());
+
+        auto old = localIndices_.cbegin();
+        auto added = newIndices_.cbegin();
+        while(old != localIndices_.cend() && added != newIndices_.cend())
+        {
+          if(old->local().state()==DELETED)
+            ++old;
+          else if(old->global() < added->global() ||
+                  (old->global() == added->global()
+                   && LocalIndexComparator<TL>::compare(old->local(),added->local())))
+            tempPairs.push_back(*old++);
+          else
+            tempPairs.push_back(*added++);
+        }
+        for(; old != localIndices_.cend(); ++old)
+          if(old->local().state()!=DELETED)
+            tempPairs.push_back(*old);
+        tempPairs.insert(tempPairs.end(), added, newIndices_.cend());
+        localIndices_.swap(tempPairs);
+      }
+      std::vector<IndexPair>().swap(newIndices_);
+      if constexpr (N<0)
+        buildHashIndex();
+    }
+    else if(localIndices_.size()==0)
     {
       localIndices_=newIndices_;
       newIndices_.clear();
@@ -888,11 +997,61 @@ namespace Dune
     }
   }
 
+  template<class TG, class TL, int N>
+  inline void ParallelIndexSet<TG,TL,N>::buildHashIndex()
+  {
+    assert(localIndices_.size() < std::numeric_limits<std::uint32_t>::max());
+    // keep the load factor below 2/3
+    hashBits_ = 1;
+    while((std::size_t(1)<<hashBits_) < localIndices_.size() + localIndices_.size()/2)
+      ++hashBits_;
+    hashIndex_.assign(std::size_t(1)<<hashBits_, 0);
+
+    const std::size_t mask = hashIndex_.size()-1;
+    const std::hash<TG> hash;
+    for(std::size_t i=0; i < localIndices_.size(); ++i) {
+      // Fibonacci hashing spreads regular patterns of global indices
+      std::size_t bucket = (std::uint64_t(hash(localIndices_[i].global())) * 0x9E3779B97F4A7C15ull) >> (64-hashBits_);
+      while(hashIndex_[bucket] != 0 && localIndices_[hashIndex_[bucket]-1].global() != localIndices_[i].global())
+        bucket = (bucket+1) & mask;
+      // only the first pair of a global index is found
+      if(hashIndex_[bucket] == 0)
+        hashIndex_[bucket] = i+1;
+    }
+  }
+
+  template<class TG, class TL, int N>
+  inline std::size_t ParallelIndexSet<TG,TL,N>::position(const TG& global) const
+  {
+    if constexpr (N<0) {
+      if(hashIndex_.empty())
+        return localIndices_.size();
+      const std::size_t mask = hashIndex_.size()-1;
+      std::size_t bucket = (std::uint64_t(std::hash<TG>()(global)) * 0x9E3779B97F4A7C15ull) >> (64-hashBits_);
+      for(; hashIndex_[bucket] != 0; bucket = (bucket+1) & mask)
+        if(localIndices_[hashIndex_[bucket]-1].global() == global)
+          return hashIndex_[bucket]-1;
+      return localIndices_.size();
+    } else {
+      auto pair = std::lower_bound(localIndices_.begin(), localIndices_.end(), global,
+                                   [](const IndexPair& p, const TG& g){ return p.global() < g; });
+      if(pair != localIndices_.end() && pair->global() == global)
+        return pair - localIndices_.begin();
+      return localIndices_.size();
+    }
+  }
+
 
   template<class TG, class TL, int N>
   inline const IndexPair<TG,TL>&
   ParallelIndexSet<TG,TL,N>::at(const TG& global) const
   {
+    if constexpr (N<=0) {
+      const std::size_t i = position(global);
+      if(i == localIndices_.size())
+        DUNE_THROW(RangeError, "Could not find entry of "<<global);
+      return localIndices_[i];
+    }
     // perform a binary search
     int low=0, high=localIndices_.size()-1, probe=-1;
 
@@ -918,6 +1077,10 @@ namespace Dune
   inline const IndexPair<TG,TL>&
   ParallelIndexSet<TG,TL,N>::operator[](const TG& global) const
   {
+    if constexpr (N<=0) {
+      assert(position(global) < localIndices_.size());
+      return localIndices_[position(global)];
+    }
     // perform a binary search
     int low=0, high=localIndices_.size()-1, probe=-1;
 
@@ -935,6 +1098,12 @@ namespace Dune
   template<class TG, class TL, int N>
   inline IndexPair<TG,TL>& ParallelIndexSet<TG,TL,N>::at(const TG& global)
   {
+    if constexpr (N<=0) {
+      const std::size_t i = position(global);
+      if(i == localIndices_.size())
+        DUNE_THROW(RangeError, "Could not find entry of "<<global);
+      return localIndices_[i];
+    }
     // perform a binary search
     int low=0, high=localIndices_.size()-1, probe=-1;
 
@@ -959,6 +1128,8 @@ namespace Dune
   template<class TG, class TL, int N>
   inline bool ParallelIndexSet<TG,TL,N>::exists (const TG& global) const
   {
+    if constexpr (N<=0)
+      return position(global) < localIndices_.size();
     // perform a binary search
     int low=0, high=localIndices_.size()-1, probe=-1;
 
@@ -982,6 +1153,10 @@ namespace Dune
   template<class TG, class TL, int N>
   inline IndexPair<TG,TL>& ParallelIndexSet<TG,TL,N>::operator[](const TG& global)
   {
+    if constexpr (N<=0) {
+      assert(position(global) < localIndices_.size());
+      return localIndices_[position(global)];
+    }
     // perform a binary search
     int low=0, high=localIndices_.size()-1, probe=-1;
 
@@ -1000,7 +1175,7 @@ namespace Dune
   inline typename ParallelIndexSet<TG,TL,N>::iterator
   ParallelIndexSet<TG,TL,N>::begin()
   {
-    return iterator(*this, localIndices_.begin());
+    return iterator(*this, Storage::begin(localIndices_));
   }
 
 
@@ -1008,14 +1183,14 @@ namespace Dune
   inline typename ParallelIndexSet<TG,TL,N>::iterator
   ParallelIndexSet<TG,TL,N>::end()
   {
-    return iterator(*this,localIndices_.end());
+    return iterator(*this, Storage::end(localIndices_));
   }
 
   template<class TG, class TL, int N>
   inline typename ParallelIndexSet<TG,TL,N>::const_iterator
   ParallelIndexSet<TG,TL,N>::begin() const
   {
-    return localIndices_.begin();
+    return Storage::begin(localIndices_);
   }
 
 
@@ -1023,7 +1198,7 @@ namespace Dune
   inline typename ParallelIndexSet<TG,TL,N>::const_iterator
   ParallelIndexSet<TG,TL,N>::end() const
   {
-    return localIndices_.end();
+    return Storage::end(localIndices_);
   }
 
   template<class TG, class TL, int N>
@@ -13,13 +13,17 @@
 #include <functional>
 #include <limits>
 #include <map>
+#include <string>
 #include <tuple>
+#include <vector>
 
 #include <mpi.h>
 
 #include <dune/common/stdstreams.hh>
-#include <dune/common/sllist.hh>
+#include <dune/common/timer.hh>
+#include <dune/common/vectorlist.hh>
 #include <dune/common/parallel/indexset.hh>
+#include <dune/common/parallel/mpipack.hh>
 #include <dune/common/parallel/remoteindices.hh>
 
 namespace Dune
@@ -39,6 +43,11 @@ namespace Dune
    * @brief Class for recomputing missing indices of a distributed index set.
    *
    * Missing local and remote indices will be added.
+   *
+   * The information for each neighbour is collected in one pass over the
+   * index set and packed into one message per neighbour. All messages are
+   * exchanged non-blocking and unpacked as they arrive. The remote indices
+   * added by a message are merged into the remote index lists in one pass.
    */
   template<typename T>
   class IndicesSyncer
@@ -62,6 +71,14 @@ namespace Dune
      */
     typedef Dune::RemoteIndices<ParallelIndexSet> RemoteIndices;
 
+    /**
+     * @brief The type of the function reporting the time of the phases of sync().
+     *
+     * It is called with the name of the phase and the time spent in it
+     * in seconds.
+     */
+    typedef std::function<void(const std::string&, double)> TimingHook;
+
     /**
      * @brief Constructor.
      *
@@ -100,6 +117,17 @@ namespace Dune
     template<typename T1>
     void sync(T1& numberer, bool useFixedOrder = false);
 
+    /**
+     * @brief Set the function reporting the time of the phases of sync().
+     *
+     * The phases are "store" (storing the global indices of the remote
+     * indices), "pack" (collecting and packing the messages), "exchange"
+     * (communication), "unpack" (adding the received indices) and "repair"
+     * (resorting the index set and repairing the remote indices).
+     * @param hook The function to call after each phase.
+     */
+    void setTimingHook(const TimingHook& hook);
+
   private:
 
     /** @brief The set of locally present indices.*/
@@ -108,33 +136,28 @@ namespace Dune
     /** @brief The remote indices. */
     RemoteIndices& remoteIndices_;
 
-    /** @brief The send buffers for the neighbour processes. */
-    char** sendBuffers_;
-
-    /** @brief The receive buffer. */
-    char* receiveBuffer_;
-
-    /** @brief The size of the send buffers. */
-    std::size_t* sendBufferSizes_;
-
-    /** @brief The size of the receive buffer in bytes. */
-    int receiveBufferSize_; // int because of MPI
+    /** @brief The function reporting the time of the phases. */
+    TimingHook timingHook_;
 
     /**
-     * @brief Information about the messages to send to a neighbouring process.
+     * @brief The message exchanged with a neighbouring process.
+     *
+     * For each published index the global index, the attribute and the number
+     * of remote indices are stored, and for each of these remote indices the
+     * process and the attribute. Each vector is packed at once.
      */
-    struct MessageInformation
+    struct Message
     {
-      MessageInformation()
-        : publish(), pairs()
-      {}
-      /** @brief The number of indices we publish for the other process. */
-      int publish;
-      /**
-       * @brief The number of pairs (attribute and process number)
-       * we publish to the neighbour process.
-       */
-      int pairs;
+      /** @brief The global indices we publish. */
+      std::vector<GlobalIndex> globals;
+      /** @brief The attributes of the published indices. */
+      std::vector<char> attributes;
+      /** @brief The number of remote indices of each published index. */
+      std::vector<int> counts;
+      /** @brief The processes of the remote indices. */
+      std::vector<int> processes;
+      /** @brief The attributes of the remote indices. */
+      std::vector<char> remoteAttributes;
     };
 
     /**
@@ -154,9 +177,6 @@ namespace Dune
       }
     };
 
-    /** @brief The mpi datatype for the MessageInformation */
-    MPI_Datatype datatype_;
-
     /** @brief Our rank. */
     int rank_;
 
@@ -164,16 +184,7 @@ namespace Dune
      * @brief List type for temporarily storing the global indices of the
      * remote indices.
      */
-    typedef SLList<std::pair<GlobalIndex,Attribute>, typename RemoteIndices::Allocator> GlobalIndexList;
-
-    /** @brief The modifying iterator for the global index list. */
-    typedef typename GlobalIndexList::ModifyIterator GlobalIndexModifier;
-
-    /**
-     * @brief The type of the iterator of GlobalIndexList
-     */
-    typedef typename SLList<GlobalIndex, typename RemoteIndices::Allocator>::iterator
-    GlobalIndexIterator;
+    typedef VectorList<std::pair<GlobalIndex,Attribute>, typename RemoteIndices::Allocator> GlobalIndexList;
 
     /** @brief Type of the map of ranks onto GlobalIndexLists. */
     typedef std::map<int, GlobalIndexList> GlobalIndicesMap;
@@ -188,221 +199,60 @@ namespace Dune
      */
     GlobalIndicesMap globalMap_;
 
-    /**
-     * @brief The type of the singly linked list of bools.
-     */
-    typedef SLList<bool, typename RemoteIndices::Allocator> BoolList;
-
-    /**
-     * @brief The mutable iterator of the singly linked bool list.
-     */
-    typedef typename BoolList::iterator BoolIterator;
-
-    /** @brief The type of the modifying iterator for the list of bools. */
-    typedef typename BoolList::ModifyIterator BoolListModifier;
-
-    /** @brief The type of the map of bool lists. */
-    typedef std::map<int,BoolList> BoolMap;
-
-    /**
-     * @brief Map of lists of bool indicating whether the remote index was present before
-     * call of sync.
-     */
-    BoolMap oldMap_;
-
-    /** @brief Information about the messages we send. */
-    std::map<int,MessageInformation> infoSend_;
-
     /** @brief The type of the remote index list. */
     typedef typename RemoteIndices::RemoteIndexList RemoteIndexList;
 
-    /** @brief The type of the modifying iterator of the remote index list. */
-    typedef typename RemoteIndexList::ModifyIterator RemoteIndexModifier;
-
     /** @brief The type of the remote inde. */
     typedef Dune::RemoteIndex<GlobalIndex,Attribute> RemoteIndex;
 
-    /** @brief The iterator of the remote index list. */
-    typedef typename RemoteIndexList::iterator RemoteIndexIterator;
-
-    /** @brief The const iterator of the remote index list. */
-    typedef typename RemoteIndexList::const_iterator ConstRemoteIndexIterator;
-
-    /** @brief Type of the tuple of iterators needed for the adding of indices. */
-    typedef std::tuple<RemoteIndexModifier,GlobalIndexModifier,BoolListModifier,
-        const ConstRemoteIndexIterator> IteratorTuple;
-
     /**
-     * @brief A tuple of iterators.
-     *
-     * Insertion into a singly linked list is only possible at the position after the one of the iterator.
-     * Therefore for each linked list two iterators are needed: One position before the actual entry
-     * (for insertion) and one positioned at the actual position (for searching).
+     * @brief A remote index to add: the global index and attribute of the
+     * local index and the attribute on the remote process.
      */
-    class Iterators
-    {
-      friend class IndicesSyncer<T>;
-    public:
-      /**
-       * @brief Constructor.
-       *
-       * Initializes all iterator to first entry and the one before the first entry, respectively.
-       * @param remoteIndices The list of the remote indices.
-       * @param globalIndices The list of the corresponding global indices. This is needed because the
-       * the pointers to the local index will become invalid due to the merging of the index sets.
-       * @param booleans Whether the remote index was there before the sync process started.
-       */
-      Iterators(RemoteIndexList& remoteIndices, GlobalIndexList& globalIndices,
-                BoolList& booleans);
-
-      /**
-       * @brief Default constructor.
-       */
-      Iterators();
-
-      /**
-       * @brief Increment all iterators.
-       */
-      Iterators& operator++();
-
-      /**
-       * @brief Insert a new remote index to the underlying remote index list.
-       * @param index The remote index.
-       * @param global The global index corresponding to the remote index.
-       */
-      void insert(const RemoteIndex& index,
-                  const std::pair<GlobalIndex,Attribute>& global);
-
-      /**
-       * @brief Get the remote index at current position.
-       * @return The current remote index.
-       */
-      RemoteIndex& remoteIndex() const;
-
-      /**
-       * @brief Get the global index of the remote index at current position.
-       * @return The current global index.
-       */
-      std::pair<GlobalIndex,Attribute>& globalIndexPair() const;
-
-      Attribute& attribute() const;
-
-      /**
-       * @brief Was this entry already in the remote index list before the sync process?
-       * @return True if the current index wasalready in the remote index list
-       * before the sync process.
-       */
-      bool isOld() const;
-
-      /**
-       * @brief Reset all the underlying iterators.
-       *
-       * Position them to first list entry and the entry before the first entry respectively.
-       * @param remoteIndices The list of the remote indices.
-       * @param globalIndices The list of the corresponding global indices. This is needed because the
-       * the pointers to the local index will become invalid due to the merging of the index sets.
-       * @param booleans Whether the remote index was there before the sync process started.
-       */
-      void reset(RemoteIndexList& remoteIndices, GlobalIndexList& globalIndices,
-                 BoolList& booleans);
-
-      /**
-       * @brief Are we not at the end of the list?
-       * @return True if the iterators are not positioned at the end of the list
-       * and the tail of the list respectively.
-       */
-      bool isNotAtEnd() const;
-
-      /**
-       * @brief Are we at the end of the list?
-       * @return True if the iterators are positioned at the end of the list
-       * and the tail of the list respectively.
-       */
-      bool isAtEnd() const;
-
-    private:
-      /**
-       * @brief The iterator tuple.
-       *
-       * The tuple consists of one iterator over a singly linked list of remote indices
-       * initially positioned before the first entry, one over a singly linked list of global indices
-       * , one over a singly linked list of bool values both positioned at the same entry. The another three
-       * iterators of the same type positioned at the first entry. Last an iterator over the
-       * singly linked list of remote indices positioned at the end.
-       */
-      IteratorTuple iterators_;
-    };
-
-    /** @brief Type of the map from ranks to iterator tuples. */
-    typedef std::map<int,Iterators> IteratorsMap;
+    typedef std::pair<std::pair<GlobalIndex,Attribute>,char> Insertion;
 
     /**
-     * @brief The iterator tuples mapped on the neighbours.
-     *
-     * The key of the map is the rank of the neighbour.
-     * The first entry in the tuple is an iterator over the remote indices
-     * initially positioned before the first entry. The second entry is an
-     * iterator over the corresponding global indices also initially positioned
-     * before the first entry. The third entry an iterator over remote indices
-     * initially positioned at the beginning. The last entry is the iterator over
-     * the remote indices positioned at the end.
+     * @brief The remote indices to add for each process, collected while
+     * unpacking a message.
      */
-    IteratorsMap iteratorsMap_;
-
-    /** @brief Calculates the message sizes to send. */
-    void calculateMessageSizes();
+    std::map<int,std::vector<Insertion> > insertions_;
 
     /**
-     * @brief Pack and send the message for another process.
-     * @param destination The rank of the process we send to.
-     * @param buffer The allocated buffer to use.
-     * @param bufferSize The size of the buffer.
-     * @param req The MPI_Request to setup the nonblocking send.
+     * @brief Collect the messages for all neighbours in one pass over the index set.
+     * @param messages The messages in the order of the neighbours.
      */
-    void packAndSend(int destination, char* buffer, std::size_t bufferSize, MPI_Request& req);
+    void collectMessages(std::vector<Message>& messages);
 
     /**
-     * @brief Recv and unpack the message from another process and add the indices.
+     * @brief Unpack the message from another process and add the indices.
      * @param numberer Functor providing local indices for added global indices.
-     * @param hardSource process of message to be received.
-     * @param useHardSource Flag indicating if hardSource should be used or not. If set to true, this makes the runs reproducible but might slow down performance.
+     * @param source The process the message was received from.
+     * @param buffer The received message.
      */
     template<typename T1>
-    void recvAndUnpack(T1& numberer, int hardSource, bool useHardSource);
+    void unpack(T1& numberer, int source, MPIPack& buffer);
 
     /**
-     * @brief Register the MPI datatype for the MessageInformation.
+     * @brief Report the time of a phase to the timing hook and reset the timer.
      */
-    void registerMessageDatatype();
+    void reportTime(const std::string& phase, Timer& watch) const;
 
     /**
-     * @brief Insert an entry into the  remote index list if not yet present.
+     * @brief Add an entry to the remote index list if not yet present.
+     *
+     * The entry is only recorded, see mergeInsertions().
      */
     void insertIntoRemoteIndexList(int process,
                                    const std::pair<GlobalIndex,Attribute>& global,
                                    char attribute);
 
     /**
-     * @brief Reset the iterator tuples of all neighbouring processes.
-     */
-    void resetIteratorsMap();
-
-    /**
-     * @brief Check whether the iterator tuples of all neighbouring processes
-     * are reset.
-     */
-    bool checkReset();
-
-    /**
-     * @brief Check whether the iterator tuple is reset.
+     * @brief Merge the recorded entries into the remote index lists.
      *
-     * @param iterators The iterator tuple to check.
-     * @param rlist The SLList of the remote indices.
-     * @param gList The SLList of the global indices.
-     * @param bList The SLList of the bool values.
+     * The entries of each process are sorted and merged into its remote
+     * index list and global index list in one pass.
      */
-    bool checkReset(const Iterators& iterators, RemoteIndexList& rlist, GlobalIndexList& gList,
-                    BoolList& bList);
+    void mergeInsertions();
   };
 
   template<typename TG, typename TA>
@@ -459,20 +309,21 @@ namespace Dune
    *
    * @warning The RemoteIndices class has to be build with the same index set for both the
    * sending and receiving side
-   * @param globalMap Map to store the corresponding global indices in.
+   * @param globalMap Map to store the corresponding global indices in. The lists
+   * of pairs of global index and attribute have to provide push_back(), e.g. SLList
+   * or VectorList.
    * @param remoteIndices The remote index information we need to store the corresponding global
    * indices of.
    * @param indexSet The index set that is for both the sending and receiving side of the remote
    * index information.
    */
-  template<typename T, typename A, typename A1>
-  void storeGlobalIndicesOfRemoteIndices(std::map<int,SLList<std::pair<typename T::GlobalIndex, typename T::LocalIndex::Attribute>,A> >& globalMap,
+  template<typename T, typename L, typename A1>
+  void storeGlobalIndicesOfRemoteIndices(std::map<int,L>& globalMap,
                                          const RemoteIndices<T,A1>& remoteIndices)
   {
     for(auto remote = remoteIndices.begin(), end =remoteIndices.end(); remote != end; ++remote) {
       typedef typename RemoteIndices<T,A1>::RemoteIndexList RemoteIndexList;
-      typedef SLList<std::pair<typename T::GlobalIndex, typename T::LocalIndex::Attribute>,A> GlobalIndexList;
-      GlobalIndexList& global = globalMap[remote->first];
+      L& global = globalMap[remote->first];
       RemoteIndexList& rList = *(remote->second.first);
 
       for(auto index = rList.begin(), riEnd = rList.end();
@@ -491,10 +342,8 @@ namespace Dune
    * @param remoteIndices The known remote indices.
    * @param indexSet The set of local indices of the current process.
    */
-  template<typename T, typename A, typename A1>
-  inline void repairLocalIndexPointers(std::map<int,
-                                           SLList<std::pair<typename T::GlobalIndex,
-                                                   typename T::LocalIndex::Attribute>,A> >& globalMap,
+  template<typename T, typename L, typename A1>
+  inline void repairLocalIndexPointers(std::map<int,L>& globalMap,
                                        RemoteIndices<T,A1>& remoteIndices,
                                        const T& indexSet)
   {
@@ -552,184 +401,69 @@ namespace Dune
   }
 
   template<typename T>
-  IndicesSyncer<T>::Iterators::Iterators(RemoteIndexList& remoteIndices,
-                                         GlobalIndexList& globalIndices,
-                                         BoolList& booleans)
-    : iterators_(remoteIndices.beginModify(), globalIndices.beginModify(),
-                 booleans.beginModify(), remoteIndices.end())
-  { }
-
-  template<typename T>
-  IndicesSyncer<T>::Iterators::Iterators()
-    : iterators_()
-  {}
-
-  template<typename T>
-  inline typename IndicesSyncer<T>::Iterators& IndicesSyncer<T>::Iterators::operator++()
-  {
-    ++(std::get<0>(iterators_));
-    ++(std::get<1>(iterators_));
-    ++(std::get<2>(iterators_));
-    return *this;
-  }
-
-  template<typename T>
-  inline void IndicesSyncer<T>::Iterators::insert(const RemoteIndex & index,
-                                                  const std::pair<GlobalIndex,Attribute>& global)
+  void IndicesSyncer<T>::setTimingHook(const TimingHook& hook)
   {
-    std::get<0>(iterators_).insert(index);
-    std::get<1>(iterators_).insert(global);
-    std::get<2>(iterators_).insert(false);
+    timingHook_ = hook;
   }
 
   template<typename T>
-  inline typename IndicesSyncer<T>::RemoteIndex&
-  IndicesSyncer<T>::Iterators::remoteIndex() const
+  void IndicesSyncer<T>::reportTime(const std::string& phase, Timer& watch) const
   {
-    return *(std::get<0>(iterators_));
+    if(timingHook_)
+      timingHook_(phase, watch.elapsed());
+    watch.reset();
   }
 
   template<typename T>
-  inline std::pair<typename IndicesSyncer<T>::GlobalIndex,typename IndicesSyncer<T>::Attribute>&
-  IndicesSyncer<T>::Iterators::globalIndexPair() const
+  void IndicesSyncer<T>::collectMessages(std::vector<Message>& messages)
   {
-    return *(std::get<1>(iterators_));
-  }
-
-  template<typename T>
-  inline bool IndicesSyncer<T>::Iterators::isOld() const
-  {
-    return *(std::get<2>(iterators_));
-  }
-
-  template<typename T>
-  inline void IndicesSyncer<T>::Iterators::reset(RemoteIndexList& remoteIndices,
-                                                 GlobalIndexList& globalIndices,
-                                                 BoolList& booleans)
-  {
-    std::get<0>(iterators_) = remoteIndices.beginModify();
-    std::get<1>(iterators_) = globalIndices.beginModify();
-    std::get<2>(iterators_) = booleans.beginModify();
-  }
-
-  template<typename T>
-  inline bool IndicesSyncer<T>::Iterators::isNotAtEnd() const
-  {
-    return std::get<0>(iterators_) != std::get<3>(iterators_);
-  }
-
-  template<typename T>
-  inline bool IndicesSyncer<T>::Iterators::isAtEnd() const
-  {
-    return std::get<0>(iterators_) == std::get<3>(iterators_);
-  }
-
-  template<typename T>
-  void IndicesSyncer<T>::registerMessageDatatype()
-  {
-    MPI_Datatype type[2] = {MPI_INT, MPI_INT};
-    int blocklength[2] = {1,1};
-    MPI_Aint displacement[2];
-    MPI_Aint base;
-
-    // Compute displacement
-    MessageInformation message;
-
-    MPI_Get_address( &(message.publish), displacement);
-    MPI_Get_address( &(message.pairs), displacement+1);
-
-    // Make the displacement relative
-    MPI_Get_address(&message, &base);
-    displacement[0] -= base;
-    displacement[1] -= base;
-
-    MPI_Type_create_struct( 2, blocklength, displacement, type, &datatype_);
-    MPI_Type_commit(&datatype_);
-  }
+    typedef typename RemoteIndexList::const_iterator RemoteIterator;
+    typedef typename GlobalIndexList::const_iterator GlobalIterator;
+
+    // The rank of each neighbour and the current positions in its
+    // remote and global index list
+    std::vector<std::tuple<int,RemoteIterator,GlobalIterator,GlobalIterator> > positions;
+    auto global = globalMap_.cbegin();
+
+    for(auto remote = remoteIndices_.begin(); remote != remoteIndices_.end(); ++remote, ++global) {
+      assert(remote->first == global->first);
+      const RemoteIndexList& rList = *(remote->second.first);
+      positions.emplace_back(remote->first, rList.begin(), global->second.begin(), global->second.end());
+    }
 
-  template<typename T>
-  void IndicesSyncer<T>::calculateMessageSizes()
-  {
-    auto iEnd = indexSet_.end();
-    auto collIter = remoteIndices_.template iterator<true>();
+    // The neighbour, its rank and the attribute of the remote indices at
+    // the current global index
+    std::vector<std::tuple<std::size_t,int,char> > known;
+    const auto iEnd = indexSet_.end();
 
     for(auto index = indexSet_.begin(); index != iEnd; ++index) {
-      collIter.advance(index->global(), index->local().attribute());
-      if(collIter.empty())
-        break;
-      int knownRemote=0;
-      auto end = collIter.end();
-
-      // Count the remote indices we know.
-      for(auto valid = collIter.begin(); valid != end; ++valid) {
-        ++knownRemote;
-      }
-
-      if(knownRemote>0) {
-        Dune::dverb<<rank_<<": publishing "<<knownRemote<<" for index "<<index->global()<< " for processes ";
-
-        // Update MessageInformation
-        for(auto valid = collIter.begin(); valid != end; ++valid) {
-          ++(infoSend_[valid.process()].publish);
-          (infoSend_[valid.process()].pairs) += knownRemote;
-          Dune::dverb<<valid.process()<<" ";
-          Dune::dverb<<"(publish="<<infoSend_[valid.process()].publish<<", pairs="<<infoSend_[valid.process()].pairs
-                     <<") ";
+      known.clear();
+
+      // advance all positions to a global index >= index->global()
+      // and remember the remote indices present before calling sync.
+      for(std::size_t neighbour = 0; neighbour < positions.size(); ++neighbour) {
+        auto& [process, remote, globalIndex, globalEnd] = positions[neighbour];
+        while(globalIndex != globalEnd && globalIndex->first < index->global()) {
+          ++remote;
+          ++globalIndex;
         }
-        Dune::dverb<<std::endl;
-      }
-    }
 
-    const auto end = infoSend_.end();
-
-    // Now determine the buffersizes needed for each neighbour using MPI_Pack_size
-    MessageInformation dummy;
-
-    auto messageIter= infoSend_.begin();
-    const auto rend = remoteIndices_.end();
-    int neighbour=0;
-
-    for(auto remote = remoteIndices_.begin(); remote != rend; ++remote, ++neighbour) {
-      MessageInformation* message;
-      MessageInformation recv;
-
-      if(messageIter != end && messageIter->first==remote->first) {
-        // We want to send message information to that process
-        message = const_cast<MessageInformation*>(&(messageIter->second));
-        ++messageIter;
-      }else
-        // We do not want to send information but the other process might.
-        message = &dummy;
-
-      sendBufferSizes_[neighbour]=0;
-      int tsize;
-      // The number of indices published
-      MPI_Pack_size(1, MPI_INT,remoteIndices_.communicator(), &tsize);
-      sendBufferSizes_[neighbour] += tsize;
-
-      for(int i=0; i < message->publish; ++i) {
-        // The global index
-        MPI_Pack_size(1, MPITraits<GlobalIndex>::getType(), remoteIndices_.communicator(), &tsize);
-        sendBufferSizes_[neighbour] += tsize;
-        // The attribute in the local index
-        MPI_Pack_size(1, MPI_CHAR, remoteIndices_.communicator(), &tsize);
-        sendBufferSizes_[neighbour] += tsize;
-        // The number of corresponding remote indices
-        MPI_Pack_size(1, MPI_INT, remoteIndices_.communicator(), &tsize);
-        sendBufferSizes_[neighbour] += tsize;
-      }
-      for(int i=0; i < message->pairs; ++i) {
-        // The process of the remote index
-        MPI_Pack_size(1, MPI_INT, remoteIndices_.communicator(), &tsize);
-        sendBufferSizes_[neighbour] += tsize;
-        // The attribute of the remote index
-        MPI_Pack_size(1, MPI_CHAR, remoteIndices_.communicator(), &tsize);
-        sendBufferSizes_[neighbour] += tsize;
+        if(globalIndex != globalEnd && globalIndex->first == index->global())
+          known.emplace_back(neighbour, process, remote->attribute());
       }
 
-      Dune::dverb<<rank_<<": Buffer (neighbour="<<remote->first<<") size is "<< sendBufferSizes_[neighbour]<<" for publish="<<message->publish<<" pairs="<<message->pairs<<std::endl;
+      // Every process supposed to know the index gets all remote indices
+      for(const auto& destination : known) {
+        Message& message = messages[std::get<0>(destination)];
+        message.globals.push_back(index->global());
+        message.attributes.push_back(index->local().attribute());
+        message.counts.push_back(known.size());
+        for(const auto& remote : known) {
+          message.processes.push_back(std::get<1>(remote));
+          message.remoteAttributes.push_back(std::get<2>(remote));
+        }
+      }
     }
-
   }
 
   template<typename T>
@@ -743,6 +477,9 @@ namespace Dune
   template<typename T1>
   void IndicesSyncer<T>::sync(T1& numberer, bool useFixedOrder)
   {
+    Timer watch;
+    const MPI_Comm comm = remoteIndices_.communicator();
+
     // The pointers to the local indices in the remote indices
     // will become invalid due to the resorting of the index set.
     // Therefore store the corresponding global indices.
@@ -751,13 +488,12 @@ namespace Dune
 
     // Number of neighbours might change during the syncing.
     // save the old neighbours
-    std::size_t noOldNeighbours = remoteIndices_.neighbours();
-    int* oldNeighbours = new int[noOldNeighbours];
-    sendBufferSizes_ = new std::size_t[noOldNeighbours];
-    std::size_t neighbourI = 0;
+    const std::size_t noOldNeighbours = remoteIndices_.neighbours();
+    std::vector<int> oldNeighbours;
+    oldNeighbours.reserve(noOldNeighbours);
 
-    for(auto remote = remoteIndices_.begin(); remote != end; ++remote, ++neighbourI) {
-      oldNeighbours[neighbourI] = remote->first;
+    for(auto remote = remoteIndices_.begin(); remote != end; ++remote) {
+      oldNeighbours.push_back(remote->first);
 
       // Make sure we only have one remote index list.
       assert(remote->second.first==remote->second.second);
@@ -766,36 +502,31 @@ namespace Dune
 
       // Store the corresponding global indices.
       GlobalIndexList& global = globalMap_[remote->first];
-      BoolList& added = oldMap_[remote->first];
+      global.reserve(rList.size());
       auto riEnd = rList.end();
 
       for(auto index = rList.begin();
-          index != riEnd; ++index) {
+          index != riEnd; ++index)
         global.push_back(std::make_pair(index->localIndexPair().global(),
                                         index->localIndexPair().local().attribute()));
-        added.push_back(true);
-      }
-
-      Iterators iterators(rList, global, added);
-      iteratorsMap_.insert(std::make_pair(remote->first, iterators));
-      assert(checkReset(iteratorsMap_[remote->first], rList,global,added));
     }
+    reportTime("store", watch);
 
-    // Exchange indices with each neighbour
-    calculateMessageSizes();
-
-    // Allocate the buffers
-    receiveBufferSize_=1;
-    sendBuffers_ = new char*[noOldNeighbours];
-
-    for(std::size_t i=0; i<noOldNeighbours; ++i) {
-      sendBuffers_[i] = new char[sendBufferSizes_[i]];
-      receiveBufferSize_ = std::max<int>(receiveBufferSize_, sendBufferSizes_[i]);
+    // Collect and pack the messages for all neighbours
+    std::vector<MPIPack> sendBuffers;
+    sendBuffers.reserve(noOldNeighbours);
+    {
+      std::vector<Message> messages(noOldNeighbours);
+      collectMessages(messages);
+
+      for(Message& message : messages) {
+        MPIPack buffer(comm);
+        buffer << message.globals << message.attributes << message.counts
+               << message.processes << message.remoteAttributes;
+        sendBuffers.push_back(std::move(buffer));
+      }
     }
-
-    receiveBuffer_=new char[receiveBufferSize_];
-
-    indexSet_.beginResize();
+    reportTime("pack", watch);
 
     Dune::dverb<<rank_<<": Neighbours: ";
 
@@ -804,286 +535,191 @@ namespace Dune
 
     Dune::dverb<<std::endl;
 
-    MPI_Request* requests = new MPI_Request[noOldNeighbours];
-    MPI_Status* statuses = new MPI_Status[noOldNeighbours];
+    // Exchange the message sizes
+    std::vector<int> sendSizes(noOldNeighbours), recvSizes(noOldNeighbours);
+    std::vector<MPI_Request> requests(2*noOldNeighbours);
+    std::vector<MPI_Status> statuses(noOldNeighbours);
 
-    // Pack Message data and start the sends
-    for(std::size_t i = 0; i<noOldNeighbours; ++i)
-      packAndSend(oldNeighbours[i], sendBuffers_[i], sendBufferSizes_[i], requests[i]);
+    for(std::size_t i = 0; i<noOldNeighbours; ++i) {
+      sendSizes[i] = sendBuffers[i].size();
+      MPI_Irecv(&recvSizes[i], 1, MPI_INT, oldNeighbours[i], 344, comm, &requests[i]);
+      MPI_Isend(&sendSizes[i], 1, MPI_INT, oldNeighbours[i], 344, comm, &requests[noOldNeighbours+i]);
+    }
+    MPI_Waitall(2*noOldNeighbours, requests.data(), MPI_STATUSES_IGNORE);
+
+    // Post all receives and sends of the messages
+    std::vector<MPIPack> recvBuffers;
+    recvBuffers.reserve(noOldNeighbours);
+
+    for(std::size_t i = 0; i<noOldNeighbours; ++i) {
+      recvBuffers.emplace_back(comm, recvSizes[i]);
+      Dune::dvverb<<rank_<<": Receiving message from "<<oldNeighbours[i]<<" with "<<recvSizes[i]<<" bytes"<<std::endl;
+      MPI_Irecv(getMPIData(recvBuffers[i]).ptr(), recvSizes[i], MPI_PACKED, oldNeighbours[i], 345,
+                comm, &requests[i]);
+      Dune::dverb << rank_<<": Sending message of "<<sendSizes[i]<<" bytes to "<<oldNeighbours[i]<<std::endl;
+      MPI_Isend(getMPIData(sendBuffers[i]).ptr(), sendSizes[i], MPI_PACKED, oldNeighbours[i], 345,
+                comm, &requests[noOldNeighbours+i]);
+    }
 
-    // Probe for incoming messages, receive and unpack them
-    for(std::size_t i = 0; i<noOldNeighbours; ++i)
-      recvAndUnpack(numberer, oldNeighbours[i], useFixedOrder);
-    //       }else{
-    //  recvAndUnpack(oldNeighbours[i], numberer);
-    //  packAndSend(oldNeighbours[i]);
-    //       }
-    //     }
+    indexSet_.beginResize();
+
+    // Unpack the messages as they arrive. With a fixed order the messages are
+    // unpacked in the order of the neighbours to make the runs reproducible.
+    double unpackTime = 0;
 
-    delete[] receiveBuffer_;
+    for(std::size_t i = 0; i<noOldNeighbours; ++i) {
+      int neighbour = i;
+      if(useFixedOrder)
+        MPI_Wait(&requests[i], MPI_STATUS_IGNORE);
+      else
+        MPI_Waitany(noOldNeighbours, requests.data(), &neighbour, MPI_STATUS_IGNORE);
+
+      Timer unpackWatch;
+      unpack(numberer, oldNeighbours[neighbour], recvBuffers[neighbour]);
+      unpackTime += unpackWatch.elapsed();
+    }
 
-    // Wait for the completion of the sends
     // Wait for completion of sends
-    if(MPI_SUCCESS!=MPI_Waitall(noOldNeighbours, requests, statuses)) {
+    if(MPI_SUCCESS!=MPI_Waitall(noOldNeighbours, requests.data()+noOldNeighbours, statuses.data())) {
       std::cerr<<": MPI_Error occurred while sending message"<<std::endl;
       for(std::size_t i=0; i< noOldNeighbours; i++)
         if(MPI_SUCCESS!=statuses[i].MPI_ERROR)
           std::cerr<<"Destination "<<statuses[i].MPI_SOURCE<<" error code: "<<statuses[i].MPI_ERROR<<std::endl;
     }
 
-    delete[] statuses;
-    delete[] requests;
-
-    for(std::size_t i=0; i<noOldNeighbours; ++i)
-      delete[] sendBuffers_[i];
-
-    delete[] sendBuffers_;
-    delete[] sendBufferSizes_;
+    if(timingHook_) {
+      timingHook_("exchange", watch.elapsed() - unpackTime);
+      timingHook_("unpack", unpackTime);
+    }
+    watch.reset();
 
-    // No need for the iterator tuples any more
-    iteratorsMap_.clear();
+    insertions_.clear();
 
     indexSet_.endResize();
 
-    delete[] oldNeighbours;
-
     repairLocalIndexPointers(globalMap_, remoteIndices_, indexSet_);
 
-    oldMap_.clear();
     globalMap_.clear();
 
     // update the sequence number
     remoteIndices_.sourceSeqNo_ = remoteIndices_.destSeqNo_ = indexSet_.seqNo();
+    reportTime("repair", watch);
   }
 
   template<typename T>
-  void IndicesSyncer<T>::packAndSend(int destination, char* buffer, std::size_t bufferSize, MPI_Request& request)
+  inline void IndicesSyncer<T>::insertIntoRemoteIndexList(int process,
+                                                          const std::pair<GlobalIndex,Attribute>& globalPair,
+                                                          char attribute)
   {
-    auto iEnd       = indexSet_.end();
-    int bpos       = 0;
-    int published  = 0;
-    int pairs      = 0;
-
-    assert(checkReset());
-
-    // Pack the number of indices we publish
-    MPI_Pack(&(infoSend_[destination].publish), 1, MPI_INT, buffer, bufferSize, &bpos,
-             remoteIndices_.communicator());
-
-    for(auto index = indexSet_.begin(); index != iEnd; ++index) {
-      // Search for corresponding remote indices in all iterator tuples
-      auto iteratorsEnd = iteratorsMap_.end();
-
-      // advance all iterators to a position with global index >= index->global()
-      for(auto iterators = iteratorsMap_.begin(); iteratorsEnd != iterators; ++iterators) {
-        while(iterators->second.isNotAtEnd() &&
-              iterators->second.globalIndexPair().first < index->global())
-          ++(iterators->second);
-        assert(!iterators->second.isNotAtEnd() || iterators->second.globalIndexPair().first >= index->global());
-      }
-
-      // Add all remote indices positioned at global which were already present before calling sync
-      // to the message.
-      // Count how many remote indices we will send
-      int indices = 0;
-      bool knownRemote = false; // Is the remote process supposed to know this index?
+    Dune::dverb<<"Inserting from "<<process<<" "<<globalPair.first<<", "<<
+    globalPair.second<<" "<<attribute<<std::endl;
 
-      for(auto iterators = iteratorsMap_.begin(); iteratorsEnd != iterators; ++iterators)
-      {
-        std::pair<GlobalIndex,Attribute> p;
-        if (iterators->second.isNotAtEnd())
-        {
-          p = iterators->second.globalIndexPair();
-        }
+    insertions_[process].emplace_back(globalPair, attribute);
+  }
 
-        if(iterators->second.isNotAtEnd() && iterators->second.isOld()
-           && iterators->second.globalIndexPair().first == index->global()) {
-          indices++;
-          if(destination == iterators->first)
-            knownRemote = true;
-        }
-      }
+  template<typename T>
+  void IndicesSyncer<T>::mergeInsertions()
+  {
+    std::vector<std::pair<std::size_t,RemoteIndex> > remotes;
+    std::vector<std::pair<std::size_t,std::pair<GlobalIndex,Attribute> > > globals;
 
-      if(!knownRemote)
-        // We do not need to send any indices
+    for(auto& [process, insertions] : insertions_) {
+      if(insertions.empty())
         continue;
 
-      Dune::dverb<<rank_<<": sending "<<indices<<" for index "<<index->global()<<" to "<<destination<<std::endl;
-
+      // There might be cases where there no remote indices for that process yet
+      auto found = remoteIndices_.remoteIndices_.find(process);
 
-      // Pack the global index, the attribute and the number
-      MPI_Pack(const_cast<GlobalIndex*>(&(index->global())), 1, MPITraits<GlobalIndex>::getType(), buffer, bufferSize, &bpos,
-               remoteIndices_.communicator());
+      if(found == remoteIndices_.remoteIndices_.end()) {
+        Dune::dverb<<"Discovered new neighbour "<<process<<std::endl;
+        RemoteIndexList* rlist = new RemoteIndexList();
+        found = remoteIndices_.remoteIndices_.insert(std::make_pair(process,std::make_pair(rlist,rlist))).first;
+      }
 
-      char attr = index->local().attribute();
-      MPI_Pack(&attr, 1, MPI_CHAR, buffer, bufferSize, &bpos,
-               remoteIndices_.communicator());
+      RemoteIndexList& rList = *(found->second.first);
+      GlobalIndexList& gList = globalMap_[process];
 
-      // Pack the number of remote indices we send.
-      MPI_Pack(&indices, 1, MPI_INT, buffer, bufferSize, &bpos,
-               remoteIndices_.communicator());
+      // Sort by the global index pairs, equal ones stay in the order of arrival
+      std::stable_sort(insertions.begin(), insertions.end(),
+                       [](const Insertion& a, const Insertion& b){ return a.first < b.first; });
 
-      // Pack the information about the remote indices
-      for(auto iterators = iteratorsMap_.begin(); iteratorsEnd != iterators; ++iterators)
-        if(iterators->second.isNotAtEnd() && iterators->second.isOld()
-           && iterators->second.globalIndexPair().first == index->global()) {
-          int process = iterators->first;
+      // Find the positions in the lists in one pass
+      remotes.clear();
+      globals.clear();
+      auto global = gList.begin();
+      const auto gEnd = gList.end();
+      std::size_t position = 0;
 
-          ++pairs;
-          assert(pairs <= infoSend_[destination].pairs);
-          MPI_Pack(&process, 1, MPI_INT, buffer, bufferSize, &bpos,
-                   remoteIndices_.communicator());
-          char attr2 = iterators->second.remoteIndex().attribute();
+      for(auto insertion = insertions.begin(); insertion != insertions.end(); ) {
+        const std::pair<GlobalIndex,Attribute> globalPair = insertion->first;
 
-          MPI_Pack(&attr2, 1, MPI_CHAR, buffer, bufferSize, &bpos,
-                   remoteIndices_.communicator());
-          --indices;
+        while(global != gEnd && *global < globalPair) {
+          ++global;
+          ++position;
         }
-      assert(indices==0);
-      ++published;
-      Dune::dvverb<<" (publish="<<published<<", pairs="<<pairs<<")"<<std::endl;
-      assert(published <= infoSend_[destination].publish);
-    }
-
-    // Make sure we send all expected entries
-    assert(published == infoSend_[destination].publish);
-    assert(pairs == infoSend_[destination].pairs);
-    resetIteratorsMap();
-
-    Dune::dverb << rank_<<": Sending message of "<<bpos<<" bytes to "<<destination<<std::endl;
-
-    MPI_Issend(buffer, bpos, MPI_PACKED, destination, 345, remoteIndices_.communicator(),&request);
-  }
-
-  template<typename T>
-  inline void IndicesSyncer<T>::insertIntoRemoteIndexList(int process,
-                                                          const std::pair<GlobalIndex,Attribute>& globalPair,
-                                                          char attribute)
-  {
-    Dune::dverb<<"Inserting from "<<process<<" "<<globalPair.first<<", "<<
-    globalPair.second<<" "<<attribute<<std::endl;
-
-    resetIteratorsMap();
-
-    // There might be cases where there no remote indices for that process yet
-    typename IteratorsMap::iterator found = iteratorsMap_.find(process);
-
-    if( found == iteratorsMap_.end() ) {
-      Dune::dverb<<"Discovered new neighbour "<<process<<std::endl;
-      RemoteIndexList* rlist = new RemoteIndexList();
-      remoteIndices_.remoteIndices_.insert(std::make_pair(process,std::make_pair(rlist,rlist)));
-      Iterators iterators = Iterators(*rlist, globalMap_[process], oldMap_[process]);
-      found = iteratorsMap_.insert(std::make_pair(process, iterators)).first;
-    }
-
-    Iterators& iterators = found->second;
-
-    // Search for the remote index
-    while(iterators.isNotAtEnd() && iterators.globalIndexPair() < globalPair) {
-      // Increment all iterators
-      ++iterators;
 
-    }
+        bool isThere = global != gEnd && *global == globalPair;
+        const std::size_t first = remotes.size();
 
-    if(iterators.isAtEnd() || iterators.globalIndexPair() != globalPair) {
-      // The entry is not yet known
-      // Insert in the list and do not change the first iterator.
-      iterators.insert(RemoteIndex(Attribute(attribute)),globalPair);
-      return;
-    }
+        for(; insertion != insertions.end() && insertion->first == globalPair; ++insertion) {
+          // entry already exists with the same attribute
+          if(isThere && globalPair.second == insertion->second)
+            continue;
+          remotes.emplace_back(position, RemoteIndex(Attribute(insertion->second)));
+          globals.emplace_back(position, globalPair);
+          isThere = true;
+        }
 
-    // Global indices match
-    bool indexIsThere=false;
-    for(Iterators tmpIterators = iterators;
-        !tmpIterators.isAtEnd() && tmpIterators.globalIndexPair() == globalPair;
-        ++tmpIterators)
-      //entry already exists with the same attribute
-      if(tmpIterators.globalIndexPair().second == attribute) {
-        indexIsThere=true;
-        break;
+        // Each entry goes before the ones with the same global index pair
+        // that were there before
+        std::reverse(remotes.begin() + first, remotes.end());
+        std::reverse(globals.begin() + first, globals.end());
       }
 
-    if(!indexIsThere)
-      // The entry is not yet known
-      // Insert in the list and do not change the first iterator.
-      iterators.insert(RemoteIndex(Attribute(attribute)),globalPair);
+      rList.insert(remotes.begin(), remotes.end());
+      gList.insert(globals.begin(), globals.end());
+      insertions.clear();
+    }
   }
 
   template<typename T>
   template<typename T1>
-  void IndicesSyncer<T>::recvAndUnpack(T1& numberer, int hardSource, bool useHardSource)
+  void IndicesSyncer<T>::unpack(T1& numberer, int source, MPIPack& buffer)
   {
     const ParallelIndexSet& constIndexSet = indexSet_;
     auto iEnd   = constIndexSet.end();
     auto index  = constIndexSet.begin();
-    int bpos   = 0;
-    int publish;
-
-    assert(checkReset());
-
-    MPI_Status status;
 
-    // We have to determine the message size and source before the receive
+    Message message;
+    buffer >> message.globals >> message.attributes >> message.counts
+           >> message.processes >> message.remoteAttributes;
 
-    MPI_Probe(useHardSource ? hardSource : MPI_ANY_SOURCE, 345, remoteIndices_.communicator(), &status);
-
-    int source=status.MPI_SOURCE;
-    int count;
-    MPI_Get_count(&status, MPI_PACKED, &count);
-
-    Dune::dvverb<<rank_<<": Receiving message from "<< source<<" with "<<count<<" bytes"<<std::endl;
-
-    if(count>receiveBufferSize_) {
-      receiveBufferSize_=count;
-      delete[] receiveBuffer_;
-      receiveBuffer_ = new char[receiveBufferSize_];
-    }
-
-    MPI_Recv(receiveBuffer_, count, MPI_PACKED, source, 345, remoteIndices_.communicator(), &status);
-
-    // How many global entries were published?
-    MPI_Unpack(receiveBuffer_,  count, &bpos, &publish, 1, MPI_INT, remoteIndices_.communicator());
+    auto process = message.processes.begin();
+    auto attribute = message.remoteAttributes.begin();
+    std::vector<std::pair<int,Attribute> > sourceAttributeList;
 
     // Now unpack the remote indices and add them.
-    while(publish>0) {
-
-      // Unpack information about the local index on the source process
-      GlobalIndex global;           // global index of the current entry
-      char sourceAttribute; // Attribute on the source process
-      int pairs;
+    for(std::size_t published = 0; published < message.globals.size(); ++published) {
 
-      MPI_Unpack(receiveBuffer_,  count, &bpos, &global, 1, MPITraits<GlobalIndex>::getType(),
-                 remoteIndices_.communicator());
-      MPI_Unpack(receiveBuffer_,  count, &bpos, &sourceAttribute, 1, MPI_CHAR,
-                 remoteIndices_.communicator());
-      MPI_Unpack(receiveBuffer_,  count, &bpos, &pairs, 1, MPI_INT,
-                 remoteIndices_.communicator());
+      // Information about the local index on the source process
+      const GlobalIndex& global = message.globals[published];
 
       // Insert the entry on the remote process to our
       // remote index list
-      SLList<std::pair<int,Attribute> > sourceAttributeList;
-      sourceAttributeList.push_back(std::make_pair(source,Attribute(sourceAttribute)));
+      sourceAttributeList.clear();
+      sourceAttributeList.push_back(std::make_pair(source,Attribute(message.attributes[published])));
 #ifndef NDEBUG
       bool foundSelf = false;
 #endif
       Attribute myAttribute=Attribute();
 
       // Unpack the remote indices
-      for(; pairs>0; --pairs) {
-        // Unpack the process id that knows the index
-        int process;
-        char attribute;
-        MPI_Unpack(receiveBuffer_,  count, &bpos, &process, 1, MPI_INT,
-                   remoteIndices_.communicator());
-        // Unpack the attribute
-        MPI_Unpack(receiveBuffer_,  count, &bpos, &attribute, 1, MPI_CHAR,
-                   remoteIndices_.communicator());
-
-        if(process==rank_) {
+      for(int pairs = message.counts[published]; pairs>0; --pairs, ++process, ++attribute) {
+        if(*process==rank_) {
 #ifndef NDEBUG
           foundSelf=true;
 #endif
-          myAttribute=Attribute(attribute);
+          myAttribute=Attribute(*attribute);
           // Now we know the local attribute of the global index
           //Only add the index if it is unknown.
           // Do we know that global index already?
@@ -1117,69 +753,19 @@ namespace Dune
           }
 
         }else{
-          sourceAttributeList.push_back(std::make_pair(process,Attribute(attribute)));
+          sourceAttributeList.push_back(std::make_pair(*process,Attribute(*attribute)));
         }
       }
       assert(foundSelf);
       // Insert remote indices
-      typedef typename SLList<std::pair<int,Attribute> >::const_iterator Iter;
-      for(Iter i=sourceAttributeList.begin(), end=sourceAttributeList.end();
-          i!=end; ++i)
-        insertIntoRemoteIndexList(i->first, std::make_pair(global, myAttribute),
-                                  i->second);
-      --publish;
+      for(const auto& sourceAttribute : sourceAttributeList)
+        insertIntoRemoteIndexList(sourceAttribute.first, std::make_pair(global, myAttribute),
+                                  sourceAttribute.second);
     }
 
-    resetIteratorsMap();
+    mergeInsertions();
   }
 
-  template<typename T>
-  void IndicesSyncer<T>::resetIteratorsMap(){
-
-    // Reset iterators in all tuples.
-    const auto remoteEnd = remoteIndices_.remoteIndices_.end();
-    auto iterators = iteratorsMap_.begin();
-    auto global = globalMap_.begin();
-    auto added = oldMap_.begin();
-
-    for(auto remote = remoteIndices_.remoteIndices_.begin();
-        remote != remoteEnd; ++remote, ++global, ++added, ++iterators) {
-      iterators->second.reset(*(remote->second.first), global->second, added->second);
-    }
-  }
-
-  template<typename T>
-  bool IndicesSyncer<T>::checkReset(const Iterators& iterators, RemoteIndexList& rList, GlobalIndexList& gList,
-                                    BoolList& bList){
-
-    if(std::get<0>(iterators.iterators_) != rList.begin())
-      return false;
-    if(std::get<1>(iterators.iterators_) != gList.begin())
-      return false;
-    if(std::get<2>(iterators.iterators_) != bList.begin())
-      return false;
-    return true;
-  }
-
-
-  template<typename T>
-  bool IndicesSyncer<T>::checkReset(){
-
-    // Reset iterators in all tuples.
-    const auto remoteEnd = remoteIndices_.remoteIndices_.end();
-    auto iterators = iteratorsMap_.begin();
-    auto global = globalMap_.begin();
-    auto added = oldMap_.begin();
-    bool ret = true;
-
-    for(auto remote = remoteIndices_.remoteIndices_.begin();
-        remote != remoteEnd; ++remote, ++global, ++added, ++iterators) {
-      if(!checkReset(iterators->second, *(remote->second.first), global->second,
-                     added->second))
-        ret=false;
-    }
-    return ret;
-  }
 }
 
 #endif // HAVE_MPI
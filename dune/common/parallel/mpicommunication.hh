@@ -16,8 +16,11 @@
 #if HAVE_MPI
 
 #include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <tuple>
+#include <vector>
 
 #include <mpi.h>
 
@@ -94,6 +97,59 @@ namespace Dune
 
 #undef ComposeMPIOp
 
+  template<class K, int n> class FieldVector;
+  template<class T, std::size_t S, std::size_t A> class LoopSIMD;
+
+  namespace Impl
+  {
+    /**
+     * @brief Maps a componentwise reduction onto a reduction of intrinsic types.
+     *
+     * A value of a type consisting of `size` contiguous entries of the
+     * intrinsic type Element that is reduced componentwise with
+     * BinaryFunction is reduced as `size` entries of Element with Function
+     * instead. Thus the predefined MPI operations are used, which MPI
+     * implementations optimize, instead of a user defined one.
+     */
+    template<class BinaryFunction, class Enable=void>
+    struct IntrinsicReduction
+    {
+      static constexpr bool value = false;
+    };
+
+    template<class E, int n, class F>
+    struct IntrinsicReductionOf
+    {
+      static constexpr bool value = true;
+      using Element = E;
+      static constexpr int size = n;
+      using Function = F;
+    };
+
+    template<class K, int n>
+    struct IntrinsicReduction<std::plus<FieldVector<K,n> >,
+                              std::enable_if_t<MPITraits<K>::is_intrinsic
+                                               && sizeof(FieldVector<K,n>) == n*sizeof(K)> >
+      : IntrinsicReductionOf<K, n, std::plus<K> >
+    {};
+
+#define ComposeIntrinsicReduction(func)                                 \
+    template<class T, std::size_t S, std::size_t A>                     \
+    struct IntrinsicReduction<func<LoopSIMD<T,S,A> >,                   \
+                              std::enable_if_t<MPITraits<T>::is_intrinsic \
+                                               && sizeof(LoopSIMD<T,S,A>) == S*sizeof(T)> > \
+      : IntrinsicReductionOf<T, S, func<T> >                            \
+    {}
+
+    ComposeIntrinsicReduction(std::plus);
+    ComposeIntrinsicReduction(std::multiplies);
+    ComposeIntrinsicReduction(Min);
+    ComposeIntrinsicReduction(Max);
+
+#undef ComposeIntrinsicReduction
+
+  } // end namespace Impl
+
 
   //=======================================================
   // use singleton pattern and template specialization to
@@ -424,9 +480,8 @@ namespace Dune
     Type allreduce(Type&& in) const{
       Type lvalue_data = std::forward<Type>(in);
       auto data = getMPIData(lvalue_data);
-      MPI_Allreduce(MPI_IN_PLACE, data.ptr(), data.size(), data.type(),
-                    (Generic_MPI_Op<Type, BinaryFunction>::get()),
-                    communicator);
+      auto [count, type, op] = reduction<BinaryFunction, Type>(data.size(), data.type());
+      MPI_Allreduce(MPI_IN_PLACE, data.ptr(), count, type, op, communicator);
       return lvalue_data;
     }
 
@@ -438,9 +493,8 @@ namespace Dune
       auto mpidata_out = future.get_mpidata();
       assert(mpidata_out.size() == mpidata_in.size());
       assert(mpidata_out.type() == mpidata_in.type());
-      MPI_Iallreduce(mpidata_in.ptr(), mpidata_out.ptr(),
-                     mpidata_out.size(), mpidata_out.type(),
-                     (Generic_MPI_Op<TIN, BinaryFunction>::get()),
+      auto [count, type, op] = reduction<BinaryFunction, TIN>(mpidata_out.size(), mpidata_out.type());
+      MPI_Iallreduce(mpidata_in.ptr(), mpidata_out.ptr(), count, type, op,
                      communicator, &future.req_);
       return future;
     }
@@ -450,9 +504,8 @@ namespace Dune
     MPIFuture<T> iallreduce(T&& data) const{
       MPIFuture<T> future(std::forward<T>(data));
       auto mpidata = future.get_mpidata();
-      MPI_Iallreduce(MPI_IN_PLACE, mpidata.ptr(),
-                     mpidata.size(), mpidata.type(),
-                     (Generic_MPI_Op<T, BinaryFunction>::get()),
+      auto [count, type, op] = reduction<BinaryFunction, T>(mpidata.size(), mpidata.type());
+      MPI_Iallreduce(MPI_IN_PLACE, mpidata.ptr(), count, type, op,
                      communicator, &future.req_);
       return future;
     }
@@ -461,11 +514,54 @@ namespace Dune
     template<typename BinaryFunction, typename Type>
     int allreduce(const Type* in, Type* out, int len) const
     {
-      return MPI_Allreduce(const_cast<Type*>(in), out, len, MPITraits<Type>::getType(),
-                           (Generic_MPI_Op<Type, BinaryFunction>::get()),communicator);
+      auto [count, type, op] = reduction<BinaryFunction, Type>(len, MPITraits<Type>::getType());
+      return MPI_Allreduce(const_cast<Type*>(in), out, count, type, op, communicator);
+    }
+
+    //! @copydoc Communication::allreduce(const Type* in,Type* out,int len,int segmentLength) const
+    template<typename BinaryFunction, typename Type>
+    int allreduce(const Type* in, Type* out, int len, int segmentLength) const
+    {
+      if(segmentLength <= 0 || len <= segmentLength)
+        return allreduce<BinaryFunction>(in, out, len);
+
+      // Start the reductions of all segments so that they are pipelined
+      std::vector<MPI_Request> requests;
+      requests.reserve((len + segmentLength - 1) / segmentLength);
+      for(int start = 0; start < len; start += segmentLength) {
+        auto [count, type, op] = reduction<BinaryFunction, Type>(std::min(segmentLength, len - start),
+                                                                 MPITraits<Type>::getType());
+        requests.emplace_back();
+        int ret = MPI_Iallreduce(in + start, out + start, count, type, op,
+                                 communicator, &requests.back());
+        if(ret != MPI_SUCCESS) {
+          requests.pop_back();
+          MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+          return ret;
+        }
+      }
+      return MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
     }
 
   private:
+    /**
+     * @brief Get the count, datatype and operation for reducing len entries
+     * of type with BinaryFunction.
+     *
+     * Componentwise reductions of types with intrinsic entries are mapped
+     * onto the predefined MPI operations, see Impl::IntrinsicReduction.
+     */
+    template<typename BinaryFunction, typename Type>
+    static std::tuple<int, MPI_Datatype, MPI_Op> reduction(int len, MPI_Datatype type)
+    {
+      using Reduction = Impl::IntrinsicReduction<BinaryFunction>;
+      if constexpr (Reduction::value)
+        return {len*Reduction::size, MPITraits<typename Reduction::Element>::getType(),
+                Generic_MPI_Op<typename Reduction::Element, typename Reduction::Function>::get()};
+      else
+        return {len, type, Generic_MPI_Op<Type, BinaryFunction>::get()};
+    }
+
     MPI_Comm communicator;
     int me;
     int procs;
@@ -7,13 +7,16 @@
 
 #if HAVE_MPI
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
 #include <iostream>
 #include <ostream>
 #include <map>
 #include <memory>
 #include <set>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -22,6 +25,7 @@
 #include <dune/common/exceptions.hh>
 #include <dune/common/sllist.hh>
 #include <dune/common/stdstreams.hh>
+#include <dune/common/vectorlist.hh>
 #include <dune/common/parallel/indexset.hh>
 #include <dune/common/parallel/mpitraits.hh>
 #include <dune/common/parallel/plocalindex.hh>
@@ -75,8 +79,8 @@ namespace Dune {
     template<typename T>
     friend class IndicesSyncer;
 
-    template<typename T, typename A, typename A1>
-    friend void repairLocalIndexPointers(std::map<int,SLList<std::pair<typename T::GlobalIndex, typename T::LocalIndex::Attribute>,A> >&,
+    template<typename T, typename L, typename A1>
+    friend void repairLocalIndexPointers(std::map<int,L>&,
                                          RemoteIndices<T,A1>&,
                                          const T&);
 
@@ -178,11 +182,14 @@ namespace Dune {
    *
    * This information is managed by this class. The information can either
    * be computed automatically calling rebuild (which requires information
-   * to be sent in a ring) or set up by hand using the
+   * to be sent to the processes sharing indices, which are found by a
+   * rendezvous of the global indices if not given) or set up by hand using the
    * RemoteIndexListModifiers returned by function getModifier(int).
    *
    * @tparam T The type of the underlying index set.
-   * @tparam A The type of the allocator to use.
+   * @tparam A The type of the allocator to use. The remote index lists are
+   * stored contiguously, so it has to allocate arrays of arbitrary size.
+   * Allocators for single nodes like PoolAllocator cannot be used.
    */
   template<class T, class A=std::allocator<RemoteIndex<typename T::GlobalIndex,
               typename T::LocalIndex::Attribute> > >
@@ -190,8 +197,8 @@ namespace Dune {
   {
     friend class InterfaceBuilder;
     friend class IndicesSyncer<T>;
-    template<typename T1, typename A2, typename A1>
-    friend void repairLocalIndexPointers(std::map<int,SLList<std::pair<typename T1::GlobalIndex, typename T1::LocalIndex::Attribute>,A2> >&,
+    template<typename T1, typename L, typename A1>
+    friend void repairLocalIndexPointers(std::map<int,L>&,
                                          RemoteIndices<T1,A1>&,
                                          const T1&);
 
@@ -238,7 +245,7 @@ namespace Dune {
     using Allocator = typename std::allocator_traits<A>::template rebind_alloc<RemoteIndex>;
 
     /** @brief The type of the remote index list. */
-    typedef Dune::SLList<RemoteIndex,Allocator>
+    typedef Dune::VectorList<RemoteIndex,Allocator>
     RemoteIndexList;
 
     /** @brief The type of the map from rank to remote index list. */
@@ -257,8 +264,9 @@ namespace Dune {
      * local mapping at the destination of the communication.
      * May be the same as the source indexset.
      * @param neighbours Optional: The neighbours the process shares indices with.
-     * If this parameter is omitted a ring communication with all indices will take
-     * place to calculate this information which is O(P).
+     * If this parameter is omitted the neighbours are found by sending the
+     * public global indices to rendezvous processes determined by their hash
+     * (see rebuild()).
      * @param includeSelf If true, sending from indices of the processor to other
      * indices on the same processor is enabled even if the same indexset is used
      * on both the
@@ -291,8 +299,9 @@ namespace Dune {
      * local mapping at the destination of the communication.
      * May be the same as the source indexset.
      * @param neighbours Optional: The neighbours the process shares indices with.
-     * If this parameter is omitted a ring communication with all indices will take
-     * place to calculate this information which is O(P).
+     * If this parameter is omitted the neighbours are found by sending the
+     * public global indices to rendezvous processes determined by their hash
+     * (see rebuild()).
      */
     void setIndexSets(const ParallelIndexSet& source, const ParallelIndexSet& destination,
                       const MPI_Comm& comm, const std::vector<int>& neighbours=std::vector<int>());
@@ -323,6 +332,14 @@ namespace Dune {
      *
      * If the template parameter ignorePublic is true all indices will be treated
      * as public.
+     *
+     * If no neighbours were given, the processes sharing indices are found
+     * first: each process sends its public global indices with
+     * MPI_Alltoallv to the process determined by the hash of the index,
+     * which replies with the processes that sent the same global index. This
+     * needs O(N) traffic for N public indices and a fixed number of
+     * collectives instead of the O(P) rounds of a ring. The ring is only used
+     * if there is no std::hash for the global index type.
      */
     template<bool ignorePublic>
     void rebuild();
@@ -423,6 +440,12 @@ namespace Dune {
     /** @brief The communicator tag to use. */
     const static int commTag_=333;
 
+    /**
+     * @brief Whether the neighbours can be found by a rendezvous of the
+     * hashed global indices.
+     */
+    constexpr static bool rendezvous_ = std::is_default_constructible<std::hash<GlobalIndex> >::value;
+
     /**
      * @brief The sequence number of the source index set when the remote indices
      * where build.
@@ -478,6 +501,20 @@ namespace Dune {
     template<bool ignorePublic>
     inline void buildRemote(bool includeSelf);
 
+    /**
+     * @brief Find the processes sharing global indices with us.
+     *
+     * The global indices are sent to the rendezvous process given by their
+     * hash, which tells all processes that sent the same global index about
+     * each other.
+     *
+     * If the template parameter ignorePublic is true all indices will be treated
+     * as public.
+     * @return The ranks of the other processes sharing indices.
+     */
+    template<bool ignorePublic>
+    inline std::set<int> findNeighbours(int rank, int procs);
+
     /**
      * @brief Count the number of public indices in an index set.
      * @param indexSet The index set whose indices we count.
@@ -542,6 +579,13 @@ namespace Dune {
    *
    * In some cases it might advisable to run IndicesSyncer::sync afterwards.
    *
+   * The remote index lists store their entries contiguously. Insertions and
+   * removals are collected and merged into the list in one pass when the
+   * modifier is destroyed or repairLocalIndexPointers() is called.
+   * Afterwards the modifier and its copies must not be used anymore, a new
+   * one has to be requested by RemoteIndices::getModifier(). Many indices
+   * are best inserted at once by insert(Iterator, Iterator).
+   *
    * @warning Use with care. If the indices are not consistent afterwards
    * communication attempts might deadlock!
    */
@@ -597,13 +641,13 @@ namespace Dune {
     typedef A Allocator;
 
     /** @brief The type of the remote index list. */
-    typedef Dune::SLList<RemoteIndex,Allocator>
+    typedef Dune::VectorList<RemoteIndex,Allocator>
     RemoteIndexList;
 
     /**
      * @brief The type of the modifying iterator of the remote index list.
      */
-    typedef SLListModifyIterator<RemoteIndex,Allocator> ModifyIterator;
+    typedef typename RemoteIndexList::ModifyIterator ModifyIterator;
 
     /**
      * @brief The type of the remote index list iterator.
@@ -642,6 +686,23 @@ namespace Dune {
      */
     void insert(const RemoteIndex& index, const GlobalIndex& global);
 
+    /**
+     * @brief Insert several indices into the list at once.
+     *
+     * The indices are inserted as by the insert methods above and merged
+     * into the list in one pass. Further indices may be inserted or
+     * removed afterwards.
+     *
+     * @param first The first index to insert. If MODIFYINDEXSET is false
+     * the range contains remote indices, otherwise pairs of a remote index
+     * and its global index. In both cases sorted by ascending global index.
+     * @param last The end of the indices to insert.
+     * @exception InvalidPosition Thrown if the indices are not in ascending
+     * order of the global index.
+     */
+    template<class Iterator>
+    void insert(Iterator first, Iterator last);
+
     /**
      * @brief Remove a remote index.
      * @param global The global index corresponding to the remote index.
@@ -673,9 +734,14 @@ namespace Dune {
      * @warning Object is not usable!
      */
     RemoteIndexListModifier()
-      : glist_()
+      : rList_(nullptr), glist_()
     {}
 
+    /**
+     * @brief Merge the modifications into the remote index list.
+     */
+    ~RemoteIndexListModifier();
+
   private:
 
     /**
@@ -733,7 +799,7 @@ namespace Dune {
     using Allocator = typename std::allocator_traits<A>::template rebind_alloc<RemoteIndex>;
 
     /** @brief The type of the remote index list. */
-    typedef Dune::SLList<RemoteIndex,Allocator> RemoteIndexList;
+    typedef Dune::VectorList<RemoteIndex,Allocator> RemoteIndexList;
 
     /** @brief The of map for storing the iterators. */
     typedef std::map<int,std::pair<typename RemoteIndexList::const_iterator,
@@ -1057,6 +1123,96 @@ namespace Dune {
   }
 
 
+  template<typename T, typename A>
+  template<bool ignorePublic>
+  inline std::set<int> RemoteIndices<T,A>::findNeighbours([[maybe_unused]] int rank,
+                                                          [[maybe_unused]] int procs)
+  {
+    std::set<int> neighbours;
+    if constexpr (rendezvous_) {
+      // The global indices we publish, sorted and without duplicates
+      std::vector<GlobalIndex> globals;
+      for(const ParallelIndexSet* indexSet : {source_, target_}) {
+        for(const auto& index : *indexSet)
+          if(ignorePublic || index.local().isPublic())
+            globals.push_back(index.global());
+        if(source_==target_)
+          break;
+      }
+      std::sort(globals.begin(), globals.end());
+      globals.erase(std::unique(globals.begin(), globals.end()), globals.end());
+
+      // Send each global index to its rendezvous process
+      std::vector<int> rendezvous(globals.size());
+      std::vector<int> sendCounts(procs, 0), sendDispls(procs, 0);
+      const std::hash<GlobalIndex> hash;
+      for(std::size_t i=0; i < globals.size(); ++i) {
+        rendezvous[i] = hash(globals[i]) % procs;
+        ++sendCounts[rendezvous[i]];
+      }
+      for(int proc=1; proc < procs; ++proc)
+        sendDispls[proc] = sendDispls[proc-1] + sendCounts[proc-1];
+
+      std::vector<GlobalIndex> sendGlobals(globals.size());
+      std::vector<int> position(sendDispls);
+      for(std::size_t i=0; i < globals.size(); ++i)
+        sendGlobals[position[rendezvous[i]]++] = globals[i];
+
+      std::vector<int> recvCounts(procs), recvDispls(procs, 0);
+      MPI_Alltoall(sendCounts.data(), 1, MPI_INT, recvCounts.data(), 1, MPI_INT, comm_);
+      for(int proc=1; proc < procs; ++proc)
+        recvDispls[proc] = recvDispls[proc-1] + recvCounts[proc-1];
+
+      std::vector<GlobalIndex> recvGlobals(recvDispls[procs-1] + recvCounts[procs-1]);
+      MPI_Datatype type = MPITraits<GlobalIndex>::getType();
+      MPI_Alltoallv(sendGlobals.data(), sendCounts.data(), sendDispls.data(), type,
+                    recvGlobals.data(), recvCounts.data(), recvDispls.data(), type, comm_);
+
+      // Group the received global indices with the processes that sent them
+      std::vector<std::pair<GlobalIndex,int> > entries;
+      entries.reserve(recvGlobals.size());
+      for(int proc=0; proc < procs; ++proc)
+        for(int i=recvDispls[proc]; i < recvDispls[proc] + recvCounts[proc]; ++i)
+          entries.emplace_back(recvGlobals[i], proc);
+      std::sort(entries.begin(), entries.end());
+
+      // The processes that each process shares global indices with
+      std::vector<std::vector<int> > shared(procs);
+      for(auto group = entries.begin(); group != entries.end();) {
+        auto groupEnd = group;
+        while(groupEnd != entries.end() && !(group->first < groupEnd->first))
+          ++groupEnd;
+        for(auto i = group; i != groupEnd; ++i)
+          for(auto j = group; j != groupEnd; ++j)
+            if(i != j)
+              shared[i->second].push_back(j->second);
+        group = groupEnd;
+      }
+
+      // Reply with the sharing processes
+      std::vector<int> sendRanks;
+      for(int proc=0; proc < procs; ++proc) {
+        std::sort(shared[proc].begin(), shared[proc].end());
+        shared[proc].erase(std::unique(shared[proc].begin(), shared[proc].end()), shared[proc].end());
+        sendCounts[proc] = shared[proc].size();
+        sendDispls[proc] = sendRanks.size();
+        sendRanks.insert(sendRanks.end(), shared[proc].begin(), shared[proc].end());
+      }
+
+      MPI_Alltoall(sendCounts.data(), 1, MPI_INT, recvCounts.data(), 1, MPI_INT, comm_);
+      for(int proc=1; proc < procs; ++proc)
+        recvDispls[proc] = recvDispls[proc-1] + recvCounts[proc-1];
+
+      std::vector<int> recvRanks(recvDispls[procs-1] + recvCounts[procs-1]);
+      MPI_Alltoallv(sendRanks.data(), sendCounts.data(), sendDispls.data(), MPI_INT,
+                    recvRanks.data(), recvCounts.data(), recvDispls.data(), MPI_INT, comm_);
+
+      neighbours.insert(recvRanks.begin(), recvRanks.end());
+      neighbours.erase(rank);
+    }
+    return neighbours;
+  }
+
   template<typename T, typename A>
   inline void RemoteIndices<T,A>::unpackCreateRemote(char* p_in, PairType** sourcePairs,
                                                      PairType** destPairs, int remoteProc,
@@ -1220,7 +1376,7 @@ namespace Dune {
 
     neighbourIds.erase(rank);
 
-    if(neighbourIds.size()==0)
+    if(neighbourIds.size()==0 && !rendezvous_)
     {
       Dune::dvverb<<rank<<": Sending messages in a ring"<<std::endl;
       // send messages in ring
@@ -1254,15 +1410,21 @@ namespace Dune {
     }
     else
     {
-      MPI_Request* requests=new MPI_Request[neighbourIds.size()];
+      // Find the neighbours if they were not given
+      std::set<int> foundNeighbours;
+      if(neighbourIds.size()==0)
+        foundNeighbours = findNeighbours<ignorePublic>(rank, procs);
+      const std::set<int>& neighbours = neighbourIds.size()==0 ? foundNeighbours : neighbourIds;
+
+      MPI_Request* requests=new MPI_Request[neighbours.size()];
       MPI_Request* req=requests;
 
       typedef typename std::set<int>::size_type size_type;
-      size_type noNeighbours=neighbourIds.size();
+      size_type noNeighbours=neighbours.size();
 
       // setup sends
-      for(std::set<int>::iterator neighbour=neighbourIds.begin();
-          neighbour!= neighbourIds.end(); ++neighbour) {
+      for(std::set<int>::const_iterator neighbour=neighbours.begin();
+          neighbour!= neighbours.end(); ++neighbour) {
         // Only send the information to the neighbouring processors
         MPI_Issend(buffer[0], position , MPI_PACKED, *neighbour, commTag_, comm_, req++);
       }
@@ -1285,10 +1447,10 @@ namespace Dune {
                            destPublish, bufferSize, sendTwo);
       }
       // wait for completion of pending requests
-      MPI_Status* statuses = new MPI_Status[neighbourIds.size()];
+      MPI_Status* statuses = new MPI_Status[neighbours.size()];
 
-      if(int(MPI_ERR_IN_STATUS)==MPI_Waitall(neighbourIds.size(), requests, statuses)) {
-        for(size_type i=0; i < neighbourIds.size(); ++i)
+      if(int(MPI_ERR_IN_STATUS)==MPI_Waitall(neighbours.size(), requests, statuses)) {
+        for(size_type i=0; i < neighbours.size(); ++i)
           if(statuses[i].MPI_ERROR!=MPI_SUCCESS) {
             std::cerr<<rank<<": MPI_Error occurred while receiving message."<<std::endl;
             MPI_Abort(comm_, 999);
@@ -1570,6 +1732,13 @@ namespace Dune {
       first_(other.first_), last_(other.last_)
   {}
 
+  template<typename T, typename A, bool mode>
+  RemoteIndexListModifier<T,A,mode>::~RemoteIndexListModifier()
+  {
+    if(rList_)
+      rList_->finishModify();
+  }
+
   template<typename T, typename A, bool mode>
   inline void RemoteIndexListModifier<T,A,mode>::repairLocalIndexPointers()
   {
@@ -1648,6 +1817,23 @@ namespace Dune {
     first_ = false;
   }
 
+  template<typename T, typename A, bool mode>
+  template<class Iterator>
+  void RemoteIndexListModifier<T,A,mode>::insert(Iterator first, Iterator last)
+  {
+    for(; first != last; ++first) {
+      if constexpr (MODIFYINDEXSET)
+        insert(first->first, first->second);
+      else
+        insert(*first);
+    }
+    // The positions of the iterators refer to the list before the merge
+    rList_->finishModify();
+    iter_ = rList_->beginModify();
+    if(MODIFYINDEXSET)
+      giter_ = glist_.beginModify();
+  }
+
   template<typename T, typename A, bool mode>
   bool RemoteIndexListModifier<T,A,mode>::remove(const GlobalIndex& global)
   {
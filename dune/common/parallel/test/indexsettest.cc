@@ -9,9 +9,10 @@
 #include <dune/common/parallel/indexset.hh>
 #include <dune/common/parallel/localindex.hh>
 
+template<int N>
 int testDeleteIndices()
 {
-  Dune::ParallelIndexSet<int,Dune::LocalIndex,15> indexSet;
+  Dune::ParallelIndexSet<int,Dune::LocalIndex,N> indexSet;
   Dune::ParallelIndexSet<int,Dune::LocalIndex,25> indexSet1;
 
   indexSet.beginResize();
@@ -25,7 +26,7 @@ int testDeleteIndices()
   indexSet.endResize();
   indexSet1.endResize();
 
-  typedef Dune::ParallelIndexSet<int,Dune::LocalIndex,15>::iterator
+  typedef typename Dune::ParallelIndexSet<int,Dune::LocalIndex,N>::iterator
   Iterator;
 
   Iterator entry = indexSet.begin();
@@ -74,7 +75,58 @@ int testDeleteIndices()
   return ret;
 }
 
+// Compare the lookup in a contiguous storage with the ArrayList storage
+template<int N>
+int testLookup()
+{
+  Dune::ParallelIndexSet<int,Dune::LocalIndex,N> indexSet;
+  Dune::ParallelIndexSet<int,Dune::LocalIndex,15> reference;
+  int ret=0;
+
+  // add strided global indices in reverse order in two resizes
+  for(int round=0; round < 2; round++) {
+    indexSet.beginResize();
+    reference.beginResize();
+    for(int i=500; i > 0; i--) {
+      indexSet.add(1024*(2*i+round), Dune::LocalIndex(2*i+round));
+      reference.add(1024*(2*i+round), Dune::LocalIndex(2*i+round));
+    }
+    indexSet.endResize();
+    reference.endResize();
+  }
+
+  if(indexSet != reference) {
+    std::cerr<<"Index set with N="<<N<<" differs from ArrayList storage!"<<std::endl;
+    ++ret;
+  }
+
+  for(int i=0; i < 2100; i++) {
+    const int global = 1024*i;
+    if(indexSet.exists(global) != reference.exists(global)) {
+      std::cerr<<"Existence of "<<global<<" differs for N="<<N<<"!"<<std::endl;
+      ++ret;
+    }else if(indexSet.exists(global) && (indexSet[global].local() != reference.at(global).local()
+                                         || indexSet.at(global).global() != global)) {
+      std::cerr<<"Lookup of "<<global<<" differs for N="<<N<<"!"<<std::endl;
+      ++ret;
+    }
+  }
+
+  try {
+    indexSet.at(1);
+    std::cerr<<"No exception for missing global index with N="<<N<<"!"<<std::endl;
+    ++ret;
+  }catch(const Dune::RangeError&) {}
+
+  return ret;
+}
+
 int main(int, char **)
 {
-  std::exit(testDeleteIndices());
+  int ret = testDeleteIndices<15>();
+  ret += testDeleteIndices<0>();
+  ret += testDeleteIndices<-1>();
+  ret += testLookup<0>();
+  ret += testLookup<-1>();
+  std::exit(ret);
 }
@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
 #include <algorithm>
 #include <iostream>
+#include <limits>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -68,6 +69,11 @@ public:
   {
     return vals_[i];
   }
+
+  int size() const
+  {
+    return size_;
+  }
 private:
   Array(const Array&)
   {}
@@ -393,6 +399,363 @@ void testIndicesBuffered(MPI_Comm comm)
   //std::cout << remote<<std::endl<<std::flush;
 }
 
+/**
+ * @brief Check that persistent requests give the same results as the
+ * requests posted anew in each communication.
+ * @return The number of entries that differ.
+ */
+int testPersistentBuffered(MPI_Comm comm)
+{
+  const int Nx = 20;
+  const int Ny = 2;
+
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef Dune::ParallelIndexSet<int,Dune::ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+  ParallelIndexSet indexSet, persistentIndexSet;
+  Array array, persistentArray;
+  setupDistributed<Nx,Ny>(array, indexSet, rank, procs);
+  setupDistributed<Nx,Ny>(persistentArray, persistentIndexSet, rank, procs);
+
+  typedef Dune::RemoteIndices<ParallelIndexSet> RemoteIndices;
+  RemoteIndices overlapIndices(indexSet, indexSet, comm);
+  overlapIndices.rebuild<false>();
+
+  Dune::Interface overlapInterface;
+  overlapInterface.build(overlapIndices, Dune::EnumItem<GridFlags,owner>(),
+                         Dune::EnumItem<GridFlags,overlap>());
+
+  Dune::BufferedCommunicator communicator;
+  Dune::BufferedCommunicator persistentCommunicator(true);
+  communicator.build<Array>(overlapInterface);
+  persistentCommunicator.build(persistentArray, persistentArray, overlapInterface);
+  assert(persistentCommunicator.persistent() && !communicator.persistent());
+
+  int differences = 0;
+  auto compare = [&]{
+    for(int i=0; i < array.size(); i++)
+      if(array[i] != persistentArray[i])
+        ++differences;
+  };
+
+  // the requests are reused in every communication
+  for(int iteration=0; iteration < 5; iteration++) {
+    communicator.forward<ArrayGatherScatter>(array);
+    persistentCommunicator.forward<ArrayGatherScatter>(persistentArray);
+    compare();
+
+    array += rank + iteration;
+    persistentArray += rank + iteration;
+
+    communicator.backward<ArrayGatherScatter>(array, array);
+    persistentCommunicator.backward<ArrayGatherScatter>(persistentArray, persistentArray);
+    compare();
+  }
+
+  // a rebuild replaces the requests
+  persistentCommunicator.free();
+  persistentCommunicator.build<Array>(overlapInterface);
+  array += 1;
+  persistentArray += 1;
+  communicator.forward<ArrayGatherScatter>(array, array);
+  persistentCommunicator.forward<ArrayGatherScatter>(persistentArray, persistentArray);
+  compare();
+
+  if(differences)
+    std::cerr<<rank<<": "<<differences<<" entries differ with persistent requests"<<std::endl;
+  return differences;
+}
+
+
+int testSplitPhaseBuffered(MPI_Comm comm, bool persistent)
+{
+  const int Nx = 20;
+  const int Ny = 2;
+
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef Dune::ParallelIndexSet<int,Dune::ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+  ParallelIndexSet indexSet, asyncIndexSet;
+  Array array, asyncArray;
+  setupDistributed<Nx,Ny>(array, indexSet, rank, procs);
+  setupDistributed<Nx,Ny>(asyncArray, asyncIndexSet, rank, procs);
+
+  typedef Dune::RemoteIndices<ParallelIndexSet> RemoteIndices;
+  RemoteIndices overlapIndices(indexSet, indexSet, comm);
+  overlapIndices.rebuild<false>();
+
+  Dune::Interface overlapInterface;
+  overlapInterface.build(overlapIndices, Dune::EnumItem<GridFlags,owner>(),
+                         Dune::EnumItem<GridFlags,overlap>());
+
+  Dune::BufferedCommunicator communicator;
+  Dune::BufferedCommunicator asyncCommunicator(persistent);
+  communicator.build<Array>(overlapInterface);
+  asyncCommunicator.build<Array>(overlapInterface);
+
+  int differences = 0;
+  auto compare = [&]{
+    for(int i=0; i < array.size(); i++)
+      if(array[i] != asyncArray[i])
+        ++differences;
+  };
+
+  for(int iteration=0; iteration < 3; iteration++) {
+    communicator.forward<ArrayGatherScatter>(array);
+    auto future = asyncCommunicator.iforward<ArrayGatherScatter>(asyncArray);
+    while(!future.ready());
+    future.get();
+    assert(!future.valid());
+    compare();
+
+    array += rank + iteration;
+    asyncArray += rank + iteration;
+
+    communicator.backward<ArrayGatherScatter>(array, array);
+    auto backwardFuture = asyncCommunicator.ibackward<ArrayGatherScatter>(asyncArray, asyncArray);
+    backwardFuture.wait();
+    compare();
+  }
+
+  // a pending future completes the communication when destroyed
+  array += 1;
+  asyncArray += 1;
+  communicator.forward<ArrayGatherScatter>(array, array);
+  asyncCommunicator.iforward<ArrayGatherScatter>(asyncArray, asyncArray);
+  compare();
+
+  if(differences)
+    std::cerr<<rank<<": "<<differences<<" entries differ with split-phase communication"<<std::endl;
+  return differences;
+}
+
+
+int testZeroCopyBuffered(MPI_Comm comm)
+{
+  const int Nx = 20;
+  const int Ny = 2;
+
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef Dune::ParallelIndexSet<int,Dune::ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+  typedef std::vector<double> Vector;
+  typedef Dune::CopyGatherScatter<Vector> CopyGatherScatter;
+  ParallelIndexSet indexSet;
+  Array array;
+  setupDistributed<Nx,Ny>(array, indexSet, rank, procs);
+  Vector copied(array.size()), zeroCopied(array.size());
+  for(int i=0; i < array.size(); i++)
+    copied[i] = zeroCopied[i] = array[i];
+
+  typedef Dune::RemoteIndices<ParallelIndexSet> RemoteIndices;
+  RemoteIndices overlapIndices(indexSet, indexSet, comm);
+  overlapIndices.rebuild<false>();
+
+  Dune::Interface overlapInterface;
+  overlapInterface.build(overlapIndices, Dune::EnumItem<GridFlags,owner>(),
+                         Dune::EnumItem<GridFlags,overlap>());
+
+  // the reference copies in ArrayGatherScatter, the others are forced to
+  // copy or to use datatypes for all messages
+  Dune::BufferedCommunicator communicator, copyCommunicator, zeroCopyCommunicator;
+  copyCommunicator.setZeroCopyRunLength(std::numeric_limits<double>::infinity());
+  zeroCopyCommunicator.setZeroCopyRunLength(0);
+  communicator.build<Array>(overlapInterface);
+  copyCommunicator.build<Vector>(overlapInterface);
+  zeroCopyCommunicator.build(zeroCopied, zeroCopied, overlapInterface);
+
+  int differences = 0;
+  auto compare = [&]{
+    for(int i=0; i < array.size(); i++)
+      if(array[i] != copied[i] || array[i] != zeroCopied[i])
+        ++differences;
+  };
+  auto add = [&](double d){
+    array += d;
+    for(int i=0; i < array.size(); i++) {
+      copied[i] += d;
+      zeroCopied[i] += d;
+    }
+  };
+
+  for(int iteration=0; iteration < 3; iteration++) {
+    communicator.forward<ArrayGatherScatter>(array);
+    copyCommunicator.forward<CopyGatherScatter>(copied);
+    zeroCopyCommunicator.forward<CopyGatherScatter>(zeroCopied);
+    compare();
+    add(rank + iteration);
+
+    communicator.backward<ArrayGatherScatter>(array, array);
+    copyCommunicator.backward<CopyGatherScatter>(copied, copied);
+    zeroCopyCommunicator.ibackward<CopyGatherScatter>(zeroCopied, zeroCopied).get();
+    compare();
+    add(1);
+  }
+
+  if(differences)
+    std::cerr<<rank<<": "<<differences<<" entries differ when communicating without copies"<<std::endl;
+  return differences;
+}
+
+
+int testNeighborBuffered(MPI_Comm comm)
+{
+  const int Nx = 20;
+  const int Ny = 2;
+
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef Dune::ParallelIndexSet<int,Dune::ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+  typedef std::vector<double> Vector;
+  typedef Dune::CopyGatherScatter<Vector> CopyGatherScatter;
+  ParallelIndexSet indexSet;
+  Array array;
+  setupDistributed<Nx,Ny>(array, indexSet, rank, procs);
+  Vector neighbor(array.size());
+  for(int i=0; i < array.size(); i++)
+    neighbor[i] = array[i];
+
+  typedef Dune::RemoteIndices<ParallelIndexSet> RemoteIndices;
+  RemoteIndices overlapIndices(indexSet, indexSet, comm);
+  overlapIndices.rebuild<false>();
+
+  Dune::Interface overlapInterface;
+  overlapInterface.build(overlapIndices, Dune::EnumItem<GridFlags,owner>(),
+                         Dune::EnumItem<GridFlags,overlap>());
+
+  Dune::BufferedCommunicator communicator, neighborCommunicator;
+  neighborCommunicator.setNeighborCollectives(true);
+  communicator.build<Array>(overlapInterface);
+  neighborCommunicator.build<Vector>(overlapInterface);
+
+  int differences = 0;
+  auto compare = [&]{
+    for(int i=0; i < array.size(); i++)
+      if(array[i] != neighbor[i])
+        ++differences;
+  };
+  auto add = [&](double d){
+    array += d;
+    for(int i=0; i < array.size(); i++)
+      neighbor[i] += d;
+  };
+
+  for(int iteration=0; iteration < 3; iteration++) {
+    communicator.forward<ArrayGatherScatter>(array);
+    neighborCommunicator.forward<CopyGatherScatter>(neighbor);
+    compare();
+    add(rank + iteration);
+
+    communicator.backward<ArrayGatherScatter>(array, array);
+    neighborCommunicator.backward<CopyGatherScatter>(neighbor, neighbor);
+    compare();
+    add(1);
+
+    communicator.forward<ArrayGatherScatter>(array);
+    auto future = neighborCommunicator.iforward<CopyGatherScatter>(neighbor);
+    future.wait();
+    compare();
+    add(2);
+
+    communicator.backward<ArrayGatherScatter>(array, array);
+    neighborCommunicator.ibackward<CopyGatherScatter>(neighbor).get();
+    compare();
+    add(1);
+  }
+
+  if(differences)
+    std::cerr<<rank<<": "<<differences<<" entries differ when communicating with neighborhood collectives"<<std::endl;
+  return differences;
+}
+
+int testRendezvous(MPI_Comm comm)
+{
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef Dune::ParallelIndexSet<int,Dune::ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+  typedef Dune::RemoteIndices<ParallelIndexSet> RemoteIndices;
+  ParallelIndexSet source, dest;
+  Array sourceArray, destArray;
+  setupDistributed<20,2>(sourceArray, source, rank, procs);
+  setupDistributed<20,3>(destArray, dest, rank, procs);
+
+  // exchanging the indices with all processes yields the complete remote indices
+  std::vector<int> all(procs);
+  for(int i=0; i < procs; i++)
+    all[i] = i;
+
+  int failures = 0;
+  auto compare = [&](RemoteIndices& found, RemoteIndices& reference, const char* what){
+    if(!(found == reference)) {
+      std::cerr<<rank<<": remote indices found by rendezvous differ "<<what<<std::endl;
+      ++failures;
+    }
+  };
+
+  RemoteIndices found(source, source, comm), reference(source, source, comm, all);
+  found.rebuild<false>();
+  reference.rebuild<false>();
+  compare(found, reference, "for public indices");
+  found.rebuild<true>();
+  reference.rebuild<true>();
+  compare(found, reference, "when ignoring the public flag");
+
+  RemoteIndices foundTwo(source, dest, comm), referenceTwo(source, dest, comm, all);
+  foundTwo.rebuild<false>();
+  referenceTwo.rebuild<false>();
+  compare(foundTwo, referenceTwo, "for two index sets");
+
+  if(procs > 1 && found.neighbours() == 0) {
+    std::cerr<<rank<<": no neighbours found by rendezvous"<<std::endl;
+    ++failures;
+  }
+  return failures;
+}
+
+// Set up remote indices by hand, inserting most of each list at once.
+int testModifier(MPI_Comm comm)
+{
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef Dune::ParallelIndexSet<int,Dune::ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+  typedef Dune::RemoteIndices<ParallelIndexSet> RemoteIndices;
+  ParallelIndexSet indexSet;
+  Array array;
+  setupDistributed<20,2>(array, indexSet, rank, procs);
+
+  RemoteIndices reference(indexSet, indexSet, comm), modified(indexSet, indexSet, comm);
+  reference.rebuild<false>();
+
+  for(auto remote = reference.begin(); remote != reference.end(); ++remote) {
+    std::vector<RemoteIndices::RemoteIndex> indices;
+    for(const auto& index : *(remote->second.first))
+      indices.push_back(index);
+
+    auto modifier = modified.getModifier<false,true>(remote->first);
+    auto middle = indices.begin() + indices.size()/2;
+    modifier.insert(indices.begin(), middle);
+    for(; middle != indices.end(); ++middle)
+      modifier.insert(*middle);
+  }
+
+  if(!(modified == reference)) {
+    std::cerr<<rank<<": remote indices inserted by the modifier differ"<<std::endl;
+    return 1;
+  }
+  return 0;
+}
 
 void testRedistributeIndices(MPI_Comm comm)
 {
@@ -709,8 +1072,19 @@ int main(int argc, char **argv)
 
   //  testRedistributeIndices(comm);
   testRedistributeIndicesBuffered(comm);
+
+  int differences = testPersistentBuffered(comm);
+  differences += testSplitPhaseBuffered(comm, false);
+  differences += testSplitPhaseBuffered(comm, true);
+  differences += testZeroCopyBuffered(comm);
+  differences += testNeighborBuffered(comm);
+  differences += testRendezvous(comm);
+  differences += testModifier(comm);
+  int globalDifferences = 0;
+  MPI_Allreduce(&differences, &globalDifferences, 1, MPI_INT, MPI_SUM, comm);
+
   MPI_Comm_free(&comm);
   MPI_Finalize();
 
-  return 0;
+  return globalDifferences == 0 ? 0 : 1;
 }
@@ -3,6 +3,8 @@
 // SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
 // SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
 #include <iostream>
+#include <limits>
+#include <set>
 #include <string>
 #include <tuple>
 
@@ -223,7 +225,24 @@ void addFakeRemoteIndices(T& indices,
   std::cout<<"Added "<<added<<" fake remote indices!"<<std::endl;
 }
 
-bool testIndicesSyncer()
+/**
+ * @brief Numberer giving all added indices the same invalid local index.
+ */
+struct InvalidNumberer
+{
+  std::size_t operator()(int)
+  {
+    return std::numeric_limits<std::size_t>::max();
+  }
+};
+
+/**
+ * @brief Test syncing the indices.
+ * @param timed If true, report the phases of sync through the timing hook and
+ * sync with a numberer, otherwise call sync() without arguments.
+ * @param useFixedOrder Whether the messages are unpacked in a fixed order.
+ */
+bool testIndicesSyncer(bool timed, bool useFixedOrder = false)
 {
   //using namespace Dune;
 
@@ -311,7 +330,22 @@ bool testIndicesSyncer()
 
   std::cout<<"Syncing!"<<std::endl;
 
-  syncer.sync();
+  if(timed) {
+    std::set<std::string> phases;
+    syncer.setTimingHook([&](const std::string& phase, double time){
+        std::cout<<rank<<": sync phase "<<phase<<" took "<<time<<" s"<<std::endl;
+        phases.insert(phase);
+      });
+
+    InvalidNumberer numberer;
+    syncer.sync(numberer, useFixedOrder);
+
+    if(phases != std::set<std::string>{"store", "pack", "exchange", "unpack", "repair"}) {
+      std::cerr<<"Not all phases of sync were reported!"<<std::endl;
+      return false;
+    }
+  }else
+    syncer.sync();
 
   std::cout<<rank<<": Synced:   "<<changedIndexSet<<std::endl<<changedRemoteIndices<<std::endl;
   if( areEqual(indexSet, remoteIndices,changedIndexSet, changedRemoteIndices))
@@ -357,7 +391,9 @@ int main(int argc, char** argv){
   int procs, rank;
   MPI_Comm_size(MPI_COMM_WORLD, &procs);
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  bool ret=testIndicesSyncer();
+  bool ret=testIndicesSyncer(false);
+  ret=testIndicesSyncer(true, false) && ret;
+  ret=testIndicesSyncer(true, true) && ret;
   MPI_Barrier(MPI_COMM_WORLD);
   std::cout<<rank<<": ENd="<<ret<<std::endl;
   if(!ret)
@@ -333,6 +333,15 @@ int main(int argc, char** argv)
         std::cout<<"===================== backward ========================="<<std::endl;
         comm.backward(vhandle);
         vhandle.verify(procs, 0, 0);
+        std::cout<<"=================== split-phase ========================"<<std::endl;
+        auto future = comm.iforward(handle);
+        while(!future.ready());
+        future.get();
+        assert(!future.valid());
+        handle.verify(procs, 0, 0);
+        auto vfuture = comm.ibackward(vhandle);
+        vfuture.wait();
+        vhandle.verify(procs, 0, 0);
     }
     else
     {
@@ -429,6 +438,34 @@ int main(int argc, char** argv)
         comm.backward(vhandle);
         MPI_Barrier(MPI_COMM_WORLD);
         vhandle.verify(procs, start, end);
+        MPI_Barrier(MPI_COMM_WORLD);
+        if(rank==0)
+            std::cout<<"=================== split-phase ========================"<<std::endl;
+        MPI_Barrier(MPI_COMM_WORLD);
+        auto future = comm.iforward(handle);
+        while(!future.ready());
+        future.get();
+        assert(!future.valid());
+        MPI_Barrier(MPI_COMM_WORLD);
+        handle.verify(procs, start, end);
+        MPI_Barrier(MPI_COMM_WORLD);
+        auto vfuture = comm.ibackward(vhandle);
+        vfuture.wait();
+        MPI_Barrier(MPI_COMM_WORLD);
+        vhandle.verify(procs, start, end);
+
+        // there is a wait time for each neighbour
+        if(comm.waitTimes().size() != inf.size())
+        {
+            std::cerr << rank << ": Number of wait times does not match!" << std::endl;
+            std::abort();
+        }
+        for(const auto& waitTime : comm.waitTimes())
+            if(!inf.count(waitTime.first) || waitTime.second < 0)
+            {
+                std::cerr << rank << ": Unexpected wait time for " << waitTime.first << "!" << std::endl;
+                std::abort();
+            }
     }
 
     MPI_Finalize();
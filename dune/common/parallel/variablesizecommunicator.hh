@@ -19,6 +19,8 @@
 #include <mpi.h>
 
 #include <dune/common/concept.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/future.hh>
 #include <dune/common/parallel/interface.hh>
 #include <dune/common/parallel/mpitraits.hh>
 
@@ -487,10 +489,69 @@ public:
     communicate<false>(handle);
   }
 
+  template<bool FORWARD, class DataHandle>
+  class ExchangeFuture;
+
+  /**
+   * @brief Start communicating forward without waiting for the
+   * communication to complete.
+   *
+   * The messages are gathered and posted as far as possible. The
+   * communication is continued and the received data is scattered by
+   * wait() or get() of the returned future, or in steps while polling
+   * ready(). Meanwhile one can compute on the entries that are not received,
+   * e.g. the interior ones.
+   *
+   * The communicator and the handle have to stay alive until the
+   * communication completed and only one communication of a communicator
+   * may be pending at a time. As gathering may continue after this function
+   * returned, the sent data must not be changed until then either.
+   *
+   * @see forward() for the interface of DataHandle.
+   * @param handle A handle responsible for describing the data, gathering, and scattering it.
+   * @return A future completing the communication.
+   */
+  template<class DataHandle>
+  ExchangeFuture<true,DataHandle> iforward(DataHandle& handle)
+  {
+    return ExchangeFuture<true,DataHandle>(*this, handle);
+  }
+
+  /**
+   * @brief Start communicating backwards without waiting for the
+   * communication to complete.
+   *
+   * @see iforward() for the semantics and forward() for the interface of DataHandle.
+   * @param handle A handle responsible for describing the data, gathering, and scattering it.
+   * @return A future completing the communication.
+   */
+  template<class DataHandle>
+  ExchangeFuture<false,DataHandle> ibackward(DataHandle& handle)
+  {
+    return ExchangeFuture<false,DataHandle>(*this, handle);
+  }
+
+  /**
+   * @brief Get the time waited for each neighbour in the last communication.
+   *
+   * Maps the rank of each neighbour to the time in seconds from the start
+   * of the last completed communication until the last message from this
+   * neighbour arrived, or to zero if nothing was received from it. Large
+   * values identify the neighbours that delay the communication.
+   */
+  const std::map<int,double>& waitTimes() const
+  {
+    return waitTimes_;
+  }
+
 private:
+  /**
+   * @brief The state of a communication.
+   * @tparam FORWARD If true we send in the forward direction.
+   * @tparam DataHandle DataHandle The type of the data handle.
+   */
   template<bool FORWARD, class DataHandle>
-  void communicateSizes(DataHandle& handle,
-                        std::vector<InterfaceTracker>& recv_trackers);
+  class Exchange;
 
   /**
    * @brief Communicates data according to the interface.
@@ -513,24 +574,6 @@ private:
   void setupInterfaceTrackers(DataHandle& handle,
                               std::vector<InterfaceTracker>& send_trackers,
                               std::vector<InterfaceTracker>& recv_trackers);
-  /**
-   * @brief Communicate data with a fixed amount of data per entry.
-   * @tparam FORWARD If true we send in the forward direction.
-   * @tparam DataHandle DataHandle The type of the data handle.
-   * @param handle The handle describing the data and responsible for gather
-   * and scatter operations.
-   */
-  template<bool FORWARD, class DataHandle>
-  void communicateFixedSize(DataHandle& handle);
-   /**
-   * @brief Communicate data with a variable amount of data per entry.
-   * @tparam FORWARD If true we send in the forward direction.
-   * @tparam DataHandle DataHandle The type of the data handle.
-   * @param handle The handle describing the data and responsible for gather
-   * and scatter operations.
-   */
-  template<bool FORWARD, class DataHandle>
-  void communicateVariableSize(DataHandle& handle);
   /**
    * @brief The maximum size if the buffers used for gather and scatter.
    *
@@ -552,6 +595,10 @@ private:
    * This is a cloned communicator to ensure there are no interferences.
    */
   MPI_Comm communicator_;
+  /**
+   * @brief The time waited for each neighbour in the last communication.
+   */
+  std::map<int,double> waitTimes_;
 };
 
 /** @} */
@@ -791,29 +838,29 @@ struct UnpackSizeEntries{
  * @param[out] recv_requests The request for the asynchronous receive operations.
  */
 [[maybe_unused]] void sendFixedSize(std::vector<InterfaceTracker>& send_trackers,
-                                    std::vector<MPI_Request>& send_requests,
+                                    MPI_Request* send_requests,
                                     std::vector<InterfaceTracker>& recv_trackers,
-                                    std::vector<MPI_Request>& recv_requests,
+                                    MPI_Request* recv_requests,
                                     MPI_Comm communicator)
 {
   typedef std::vector<InterfaceTracker>::iterator TIter;
-  std::vector<MPI_Request>::iterator mIter=recv_requests.begin();
+  MPI_Request* mIter=recv_requests;
 
   for(TIter iter=recv_trackers.begin(), end=recv_trackers.end(); iter!=end;
       ++iter, ++mIter)
   {
     MPI_Irecv(&(iter->fixedSize), 1, MPITraits<std::size_t>::getType(),
-              iter->rank(), 933881, communicator, &(*mIter));
+              iter->rank(), 933881, communicator, mIter);
   }
 
   // Send our size to all neighbours using non-blocking synchronous communication.
-  std::vector<MPI_Request>::iterator mIter1=send_requests.begin();
+  MPI_Request* mIter1=send_requests;
   for(TIter iter=send_trackers.begin(), end=send_trackers.end();
       iter!=end;
       ++iter, ++mIter1)
   {
     MPI_Issend(&(iter->fixedSize), 1, MPITraits<std::size_t>::getType(),
-               iter->rank(), 933881, communicator, &(*mIter1));
+               iter->rank(), 933881, communicator, mIter1);
   }
 }
 
@@ -880,135 +927,42 @@ struct NullPackUnpackFunctor
 };
 
 /**
- * @brief Check whether some of the requests finished and continue send/receive operation.
+ * @brief Process a finished request and continue the send/receive operation with the neighbour.
  * @tparam DataHandle The type of the data handle describing the data.
  * @tparam BufferFunctor A functor that packs or unpacks data from the buffer.
  * E.g. NullPackUnpackFunctor.
  * @tparam CommunicationFuntor A functor responsible for continuing the communication.
  * @param handle The data handle describing the data.
- * @param trackers The trackers indicating the current position in the communication.
- * @param requests The requests to test whether they finished.
- * @param requests2 The requests to use for setting up the continuing communication. Might
- * be the same as requests.
+ * @param index The index of the neighbour.
+ * @param tracker The tracker indicating the current position in the communication.
+ * @param buffer The buffer of the finished request.
+ * @param request The request to use for continuing the communication. It stays
+ * MPI_REQUEST_NULL if the communication with the neighbour is finished.
  * @param comm The MPI communicator to use.
  * @param buffer_func The functor that does the packing or unpacking of the data.
+ * @param comm_func The functor that continues the communication.
+ * @param count The number of entries received, if needed by buffer_func.
  */
 template<class DataHandle, class BufferFunctor, class CommunicationFunctor>
-std::size_t checkAndContinue(DataHandle& handle,
-                             std::vector<InterfaceTracker>& trackers,
-                             std::vector<MPI_Request>& requests,
-                             std::vector<MPI_Request>& requests2,
-                             std::vector<MessageBuffer<typename DataHandle::DataType> >& buffers,
-                             MPI_Comm comm,
-                             BufferFunctor buffer_func,
-                             CommunicationFunctor comm_func,
-                             bool valid=true,
-                             bool getCount=false)
+void continueCommunication(DataHandle& handle,
+                           std::size_t index,
+                           InterfaceTracker& tracker,
+                           MessageBuffer<typename DataHandle::DataType>& buffer,
+                           MPI_Request& request,
+                           MPI_Comm comm,
+                           BufferFunctor buffer_func,
+                           CommunicationFunctor comm_func,
+                           int count=0)
 {
-  std::size_t size=requests.size();
-  std::vector<MPI_Status> statuses(size);
-  int no_completed;
-  std::vector<int> indices(size, -1); // the indices for which the communication finished.
-
-  MPI_Testsome(size, &(requests[0]), &no_completed, &(indices[0]), &(statuses[0]));
-  indices.resize(no_completed);
-  for(std::vector<int>::iterator index=indices.begin(), end=indices.end();
-      index!=end; ++index)
-  {
-    InterfaceTracker& tracker=trackers[*index];
-    setReceivingIndex(handle, *index);
-    if(getCount)
-    {
-      // Get the number of entries received
-      int count;
-      MPI_Get_count(&(statuses[index-indices.begin()]),
-                    MPITraits<typename DataHandle::DataType>::getType(),
-                    &count);
-      // Communication completed, we can reuse the buffers, e.g. unpack or repack
-      buffer_func(handle, tracker, buffers[*index], count);
-    }else
-      buffer_func(handle, tracker, buffers[*index]);
+  setReceivingIndex(handle, index);
+  // Communication completed, we can reuse the buffers, e.g. unpack or repack
+  buffer_func(handle, tracker, buffer, count);
+  tracker.skipZeroIndices();
+  if(!tracker.finished()){
+    // Maybe start another communication.
+    comm_func(handle, tracker, buffer, request, comm);
     tracker.skipZeroIndices();
-    if(!tracker.finished()){
-      // Maybe start another communication.
-      comm_func(handle, tracker, buffers[*index], requests2[*index], comm);
-      tracker.skipZeroIndices();
-      if(valid)
-      --no_completed; // communication not finished, decrement counter for finished ones.
-    }
   }
-  return no_completed;
-
-}
-
-/**
- * @brief Receive the size per data entry and set up requests for receiving the data.
- * @tparam DataHandle The type of the data handle.
- * @param trackers The trackers indicating the indices where we send and from which rank.
- * @param size_requests The requests for receiving the size.
- * @param data_requests The requests for sending the data.
- * @param buffers The buffers to use for sending.
- * @param comm The mpi communicator to use.
- */
-template<class DataHandle>
-std::size_t receiveSizeAndSetupReceive(DataHandle& handle,
-                                       std::vector<InterfaceTracker>& trackers,
-                                       std::vector<MPI_Request>& size_requests,
-                                       std::vector<MPI_Request>& data_requests,
-                                       std::vector<MessageBuffer<typename DataHandle::DataType> >& buffers,
-                                       MPI_Comm comm)
-{
-  return checkAndContinue(handle, trackers, size_requests, data_requests, buffers, comm,
-                   NullPackUnpackFunctor<DataHandle>(), SetupRecvRequest<DataHandle>(), false);
-}
-
-/**
- * @brief Check whether send request completed and continue sending if necessary.
- * @tparam DataHandle The type of the data handle.
- * @param trackers The trackers indicating the indices where we send and from which rank.
- * @param requests The requests for the asynchronous communication.
- * @param buffers The buffers to use for sending.
- * @param comm The mpi communicator to use.
- */
-template<class DataHandle>
-std::size_t checkSendAndContinueSending(DataHandle& handle,
-                                        std::vector<InterfaceTracker>& trackers,
-                                        std::vector<MPI_Request>& requests,
-                                        std::vector<MessageBuffer<typename DataHandle::DataType> >& buffers,
-                                        MPI_Comm comm)
-{
-  return checkAndContinue(handle, trackers, requests, requests, buffers, comm,
-                          NullPackUnpackFunctor<DataHandle>(), SetupSendRequest<DataHandle>());
-}
-
-/**
- * @brief Check whether receive request completed and continue receiving if necessary.
- * @tparam DataHandle The type of the data handle.
- * @param trackers The trackers indicating the indices where we receive and from which rank.
- * @param requests The requests for the asynchronous communication.
- * @param buffers The buffers to use for receiving.
- * @param comm The mpi communicator to use.
- */
-template<class DataHandle>
-std::size_t checkReceiveAndContinueReceiving(DataHandle& handle,
-                                             std::vector<InterfaceTracker>& trackers,
-                                             std::vector<MPI_Request>& requests,
-                                             std::vector<MessageBuffer<typename DataHandle::DataType> >& buffers,
-                                             MPI_Comm comm)
-{
-  return checkAndContinue(handle, trackers, requests, requests, buffers, comm,
-                          UnpackEntries<DataHandle>(), SetupRecvRequest<DataHandle>(),
-                          true, !Impl::callFixedSize(handle));
-}
-
-
-[[maybe_unused]] bool validRecvRequests(const std::vector<MPI_Request>& reqs)
-{
-  for(std::vector<MPI_Request>::const_iterator i=reqs.begin(), end=reqs.end();
-      i!=end; ++i)
-    if(*i!=MPI_REQUEST_NULL)
-      return true;
-  return false;
 }
 
 /**
@@ -1025,14 +979,14 @@ template<class DataHandle, class Functor>
 std::size_t setupRequests(DataHandle& handle,
                    std::vector<InterfaceTracker>& trackers,
                    std::vector<MessageBuffer<typename DataHandle::DataType> >& buffers,
-                   std::vector<MPI_Request>& requests,
+                   MPI_Request* requests,
                    const Functor& setupFunctor,
                    MPI_Comm communicator)
 {
   typedef typename std::vector<InterfaceTracker>::iterator TIter;
   typename std::vector<MessageBuffer<typename DataHandle::DataType> >::iterator
     biter=buffers.begin();
-  typename std::vector<MPI_Request>::iterator riter=requests.begin();
+  MPI_Request* riter=requests;
   std::size_t complete=0;
   for(TIter titer=trackers.begin(), end=trackers.end(); titer!=end; ++titer, ++biter, ++riter)
   {
@@ -1073,167 +1027,302 @@ void VariableSizeCommunicator<Allocator>::setupInterfaceTrackers(DataHandle& han
   }
 }
 
+/**
+ * @brief The state of a communication of the VariableSizeCommunicator.
+ *
+ * The requests of all neighbours are kept in one array. Whenever some of
+ * them finished, the received messages are unpacked and the communication
+ * with the respective neighbours is continued, regardless of the state of
+ * the other neighbours.
+ */
 template<class Allocator>
 template<bool FORWARD, class DataHandle>
-void VariableSizeCommunicator<Allocator>::communicateFixedSize(DataHandle& handle)
+class VariableSizeCommunicator<Allocator>::Exchange
 {
-  std::vector<MPI_Request> size_send_req(interface_->size());
-  std::vector<MPI_Request> size_recv_req(interface_->size());
+  typedef typename DataHandle::DataType DataType;
+  typedef SizeDataHandle<DataHandle> SizeHandle;
 
-  std::vector<InterfaceTracker> send_trackers;
-  std::vector<InterfaceTracker> recv_trackers;
-  setupInterfaceTrackers<FORWARD>(handle,send_trackers, recv_trackers);
-  sendFixedSize(send_trackers,  size_send_req, recv_trackers, size_recv_req, communicator_);
+  /** @brief The segments of the array of requests, each with one request per neighbour. */
+  enum { sizeSend, sizeRecv, dataSend, dataRecv, segments };
 
-  std::vector<MPI_Request> data_send_req(interface_->size(), MPI_REQUEST_NULL);
-  std::vector<MPI_Request> data_recv_req(interface_->size(), MPI_REQUEST_NULL);
-  typedef typename DataHandle::DataType DataType;
-  std::vector<MessageBuffer<DataType> > send_buffers(interface_->size(), MessageBuffer<DataType>(maxBufferSize_)),
-    recv_buffers(interface_->size(), MessageBuffer<DataType>(maxBufferSize_));
+public:
+  /**
+   * @brief Set up the trackers and start the communication.
+   *
+   * With a fixed amount of data per entry the size per entry and the first
+   * messages of the data are sent. Otherwise the sizes of the entries are
+   * communicated first and the data only after all of them were received.
+   */
+  Exchange(VariableSizeCommunicator& communicator, DataHandle& handle)
+    : communicator_(communicator), handle_(handle), sizeHandle_(handle, recvTrackers_),
+      comm_(communicator.communicator_), fixedSize_(Impl::callFixedSize(handle)),
+      dataStarted_(fixedSize_), neighbours_(communicator.interface_->size()),
+      requests_(segments*neighbours_, MPI_REQUEST_NULL), indices_(requests_.size()),
+      statuses_(requests_.size()), active_(0), start_(MPI_Wtime()), waitTimes_(neighbours_, 0.0)
+  {
+    const std::size_t size = neighbours_;
+    communicator.template setupInterfaceTrackers<FORWARD>(handle_, sendTrackers_, recvTrackers_);
+    sendBuffers_ = std::vector<MessageBuffer<DataType> >(size, MessageBuffer<DataType>(communicator.maxBufferSize_));
+    recvBuffers_ = std::vector<MessageBuffer<DataType> >(size, MessageBuffer<DataType>(communicator.maxBufferSize_));
 
+    if(fixedSize_)
+    {
+      sendFixedSize(sendTrackers_, segment(sizeSend), recvTrackers_, segment(sizeRecv), comm_);
+      setupRequests(handle_, sendTrackers_, sendBuffers_, segment(dataSend),
+                    SetupSendRequest<DataHandle>(), comm_);
+    }
+    else
+    {
+      communicator.template setupInterfaceTrackers<FORWARD>(sizeHandle_, sizeSendTrackers_, sizeRecvTrackers_);
+      sizeSendBuffers_ = std::vector<MessageBuffer<std::size_t> >(size, MessageBuffer<std::size_t>(communicator.maxBufferSize_));
+      sizeRecvBuffers_ = std::vector<MessageBuffer<std::size_t> >(size, MessageBuffer<std::size_t>(communicator.maxBufferSize_));
+      setupRequests(sizeHandle_, sizeSendTrackers_, sizeSendBuffers_, segment(sizeSend),
+                    SetupSendRequest<SizeHandle>(), comm_);
+      setupRequests(sizeHandle_, sizeRecvTrackers_, sizeRecvBuffers_, segment(sizeRecv),
+                    SetupRecvRequest<SizeHandle>(), comm_);
+    }
+    // Count valid requests that we have to wait for.
+    active_ = std::count_if(requests_.begin(), requests_.end(),
+                            [](const MPI_Request& req) { return req != MPI_REQUEST_NULL; });
+  }
 
-  setupRequests(handle, send_trackers, send_buffers, data_send_req,
-                SetupSendRequest<DataHandle>(), communicator_);
+  /**
+   * @brief Continue the communication with the neighbours whose requests finished.
+   * @param block If true wait until at least one request finished.
+   * @return True if the communication completed.
+   */
+  bool progress(bool block)
+  {
+    if(active_)
+    {
+      int count;
+      if(block)
+        MPI_Waitsome(requests_.size(), requests_.data(), &count, indices_.data(), statuses_.data());
+      else
+        MPI_Testsome(requests_.size(), requests_.data(), &count, indices_.data(), statuses_.data());
+      const double now = MPI_Wtime();
+      for(int i=0; i < count; ++i)
+        finished(indices_[i], statuses_[i], now);
+    }
+    if(active_)
+      return false;
 
-  std::size_t no_size_to_recv,  no_to_send, no_to_recv, old_size;
-  no_size_to_recv = no_to_send = no_to_recv = old_size = interface_->size();
+    if(!dataStarted_)
+    {
+      // All sizes are known, setup requests for sending and receiving.
+      setupRequests(handle_, sendTrackers_, sendBuffers_, segment(dataSend),
+                    SetupSendRequest<DataHandle>(), comm_);
+      setupRequests(handle_, recvTrackers_, recvBuffers_, segment(dataRecv),
+                    SetupRecvRequest<DataHandle>(), comm_);
+      active_ = std::count_if(requests_.begin(), requests_.end(),
+                              [](const MPI_Request& req) { return req != MPI_REQUEST_NULL; });
+      dataStarted_ = true;
+      if(active_)
+        return false;
+    }
 
-  // Skip empty interfaces.
-  typedef typename std::vector<InterfaceTracker>::const_iterator Iter;
-  for(Iter i=recv_trackers.begin(), end=recv_trackers.end(); i!=end; ++i)
-    if(i->empty())
-       --no_to_recv;
-  for(Iter i=send_trackers.begin(), end=send_trackers.end(); i!=end; ++i)
-    if(i->empty())
-      --no_to_send;
+    communicator_.waitTimes_.clear();
+    for(std::size_t i=0; i < neighbours_; ++i)
+      communicator_.waitTimes_[recvTrackers_[i].rank()] = waitTimes_[i];
+    return true;
+  }
 
-  while(no_size_to_recv+no_to_send+no_to_recv)
+private:
+  MPI_Request* segment(int s)
   {
-    // Receive the fixedsize and setup receives accordingly
-    if(no_size_to_recv)
-      no_size_to_recv -= receiveSizeAndSetupReceive(handle,recv_trackers, size_recv_req,
-                                                  data_recv_req, recv_buffers,
-                                                  communicator_);
-
-    // Check send completion and initiate other necessary sends
-    if(no_to_send)
-      no_to_send -= checkSendAndContinueSending(handle, send_trackers, data_send_req,
-                                              send_buffers, communicator_);
-    if(validRecvRequests(data_recv_req))
-      // Receive data and setup new unblocking receives if necessary
-      no_to_recv -= checkReceiveAndContinueReceiving(handle, recv_trackers, data_recv_req,
-                                                     recv_buffers, communicator_);
+    return requests_.data() + s*neighbours_;
   }
 
-  // Wait for completion of sending the size.
-  //std::vector<MPI_Status> statuses(interface_->size(), MPI_STATUSES_IGNORE);
-  MPI_Waitall(size_send_req.size(), &(size_send_req[0]), MPI_STATUSES_IGNORE);
+  /**
+   * @brief Continue the communication after the request with the given index finished.
+   */
+  void finished(int index, const MPI_Status& status, double now)
+  {
+    const std::size_t i = index % neighbours_;
+    MPI_Request& request = requests_[index];
+    MPI_Request* next = &request;
+    --active_;
+    switch(index / neighbours_)
+    {
+    case sizeSend :
+      if(!fixedSize_)
+        continueCommunication(sizeHandle_, i, sizeSendTrackers_[i], sizeSendBuffers_[i], request, comm_,
+                              NullPackUnpackFunctor<SizeHandle>(), SetupSendRequest<SizeHandle>());
+      break;
+    case sizeRecv :
+      if(fixedSize_)
+      {
+        // Received the fixed size, setup receives accordingly
+        next = segment(dataRecv) + i;
+        continueCommunication(handle_, i, recvTrackers_[i], recvBuffers_[i], *next, comm_,
+                              NullPackUnpackFunctor<DataHandle>(), SetupRecvRequest<DataHandle>());
+      }
+      else
+        // Could have done this using NullPackUnpackFunctor
+        // But the call below is more efficient as UnpackSizeEntries
+        // uses std::copy.
+        continueCommunication(sizeHandle_, i, sizeRecvTrackers_[i], sizeRecvBuffers_[i], request, comm_,
+                              UnpackSizeEntries<DataHandle>(), SetupRecvRequest<SizeHandle>());
+      break;
+    case dataSend :
+      continueCommunication(handle_, i, sendTrackers_[i], sendBuffers_[i], request, comm_,
+                            NullPackUnpackFunctor<DataHandle>(), SetupSendRequest<DataHandle>());
+      break;
+    case dataRecv :
+    {
+      waitTimes_[i] = now - start_;
+      // Get the number of entries received
+      int count = 0;
+      if(!fixedSize_)
+        MPI_Get_count(const_cast<MPI_Status*>(&status), MPITraits<DataType>::getType(), &count);
+      // Unpack the data and setup a new unblocking receive if necessary
+      continueCommunication(handle_, i, recvTrackers_[i], recvBuffers_[i], request, comm_,
+                            UnpackEntries<DataHandle>(), SetupRecvRequest<DataHandle>(), count);
+      break;
+    }
+    }
+    if(*next != MPI_REQUEST_NULL)
+      ++active_;
+  }
 
-}
+  VariableSizeCommunicator& communicator_;
+  DataHandle& handle_;
+  std::vector<InterfaceTracker> sendTrackers_;
+  std::vector<InterfaceTracker> recvTrackers_;
+  /** @brief The handle for communicating the sizes into recvTrackers_. */
+  SizeHandle sizeHandle_;
+  MPI_Comm comm_;
+  bool fixedSize_;
+  /** @brief Whether the requests for the data were set up. */
+  bool dataStarted_;
+  std::size_t neighbours_;
+
+  std::vector<MessageBuffer<DataType> > sendBuffers_;
+  std::vector<MessageBuffer<DataType> > recvBuffers_;
+  /** @brief Trackers and buffers for communicating variable sizes. */
+  std::vector<InterfaceTracker> sizeSendTrackers_;
+  std::vector<InterfaceTracker> sizeRecvTrackers_;
+  std::vector<MessageBuffer<std::size_t> > sizeSendBuffers_;
+  std::vector<MessageBuffer<std::size_t> > sizeRecvBuffers_;
+
+  /** @brief The requests of all neighbours, see the segments. */
+  std::vector<MPI_Request> requests_;
+  std::vector<int> indices_;
+  std::vector<MPI_Status> statuses_;
+  /** @brief The number of requests that did not finish yet. */
+  std::size_t active_;
+
+  /** @brief The time the communication started. */
+  double start_;
+  /** @brief The time until the last message of each neighbour arrived. */
+  std::vector<double> waitTimes_;
+};
 
+/**
+ * @brief A future for a communication started by
+ * VariableSizeCommunicator::iforward() or VariableSizeCommunicator::ibackward().
+ *
+ * It provides the interface of Future<void>: wait() completes the
+ * communication, ready() continues it as far as possible without blocking
+ * and tests whether it completed, and get() additionally invalidates the
+ * future. A future that is destroyed while still pending completes the
+ * communication.
+ */
 template<class Allocator>
 template<bool FORWARD, class DataHandle>
-void VariableSizeCommunicator<Allocator>::communicateSizes(DataHandle& handle,
-                                                           std::vector<InterfaceTracker>& data_recv_trackers)
+class VariableSizeCommunicator<Allocator>::ExchangeFuture
 {
-  std::vector<InterfaceTracker> send_trackers;
-  std::vector<InterfaceTracker> recv_trackers;
-  std::size_t size = interface_->size();
-  std::vector<MPI_Request> send_requests(size, MPI_REQUEST_NULL);
-  std::vector<MPI_Request> recv_requests(size, MPI_REQUEST_NULL);
-  std::vector<MessageBuffer<std::size_t> >
-    send_buffers(size, MessageBuffer<std::size_t>(maxBufferSize_)),
-    recv_buffers(size, MessageBuffer<std::size_t>(maxBufferSize_));
-  SizeDataHandle<DataHandle> size_handle(handle,data_recv_trackers);
-  setupInterfaceTrackers<FORWARD>(size_handle,send_trackers, recv_trackers);
-  setupRequests(size_handle, send_trackers, send_buffers, send_requests,
-                                SetupSendRequest<SizeDataHandle<DataHandle> >(), communicator_);
-  setupRequests(size_handle, recv_trackers, recv_buffers, recv_requests,
-                SetupRecvRequest<SizeDataHandle<DataHandle> >(), communicator_);
-
-  // Count valid requests that we have to wait for.
-  auto valid_req_func =
-    [](const MPI_Request& req) { return req != MPI_REQUEST_NULL; };
-
-  auto size_to_send = std::count_if(send_requests.begin(), send_requests.end(),
-                                    valid_req_func);
-  auto size_to_recv = std::count_if(recv_requests.begin(), recv_requests.end(),
-                                    valid_req_func);
-
-  while(size_to_send+size_to_recv)
-  {
-    if(size_to_send)
-      size_to_send -=
-        checkSendAndContinueSending(size_handle, send_trackers, send_requests,
-                                    send_buffers, communicator_);
-    if(size_to_recv)
-      // Could have done this using checkSendAndContinueSending
-      // But the call below is more efficient as UnpackSizeEntries
-      // uses std::copy.
-      size_to_recv -=
-        checkAndContinue(size_handle, recv_trackers, recv_requests, recv_requests,
-                         recv_buffers, communicator_, UnpackSizeEntries<DataHandle>(),
-                         SetupRecvRequest<SizeDataHandle<DataHandle> >());
+  friend class VariableSizeCommunicator;
+
+  ExchangeFuture(VariableSizeCommunicator& communicator, DataHandle& handle)
+    : exchange_(std::make_unique<Exchange<FORWARD,DataHandle> >(communicator, handle)),
+      valid_(true)
+  {}
+
+public:
+  /**
+   * @brief Constructs an invalid future.
+   */
+  ExchangeFuture()
+    : valid_(false)
+  {}
+
+  ExchangeFuture(ExchangeFuture&& other)
+    : exchange_(std::move(other.exchange_)), valid_(std::exchange(other.valid_, false))
+  {}
+
+  ExchangeFuture& operator=(ExchangeFuture&& other)
+  {
+    if(this != &other) {
+      if(valid())
+        wait();
+      exchange_ = std::move(other.exchange_);
+      valid_ = std::exchange(other.valid_, false);
+    }
+    return *this;
   }
-}
 
-template<class Allocator>
-template<bool FORWARD, class DataHandle>
-void VariableSizeCommunicator<Allocator>::communicateVariableSize(DataHandle& handle)
-{
+  ~ExchangeFuture()
+  {
+    if(exchange_)
+      wait();
+  }
 
-  std::vector<InterfaceTracker> send_trackers;
-  std::vector<InterfaceTracker> recv_trackers;
-  setupInterfaceTrackers<FORWARD>(handle, send_trackers, recv_trackers);
+  /**
+   * @brief Whether the future refers to a communication.
+   */
+  bool valid() const
+  {
+    return valid_;
+  }
 
-  std::vector<MPI_Request> send_requests(interface_->size(), MPI_REQUEST_NULL);
-  std::vector<MPI_Request> recv_requests(interface_->size(), MPI_REQUEST_NULL);
-  typedef typename DataHandle::DataType DataType;
-  std::vector<MessageBuffer<DataType> >
-    send_buffers(interface_->size(), MessageBuffer<DataType>(maxBufferSize_)),
-    recv_buffers(interface_->size(), MessageBuffer<DataType>(maxBufferSize_));
-
-  communicateSizes<FORWARD>(handle, recv_trackers);
-  // Setup requests for sending and receiving.
-  setupRequests(handle, send_trackers, send_buffers, send_requests,
-                SetupSendRequest<DataHandle>(), communicator_);
-  setupRequests(handle, recv_trackers, recv_buffers, recv_requests,
-                SetupRecvRequest<DataHandle>(), communicator_);
-
-  // Determine number of valid requests.
-  auto valid_req_func =
-    [](const MPI_Request& req) { return req != MPI_REQUEST_NULL;};
-
-  auto no_to_send = std::count_if(send_requests.begin(), send_requests.end(),
-                             valid_req_func);
-  auto no_to_recv = std::count_if(recv_requests.begin(), recv_requests.end(),
-                             valid_req_func);
-  while(no_to_send+no_to_recv)
-  {
-    // Check send completion and initiate other necessary sends
-    if(no_to_send)
-      no_to_send -= checkSendAndContinueSending(handle, send_trackers, send_requests,
-                                              send_buffers, communicator_);
-    if(no_to_recv)
-      // Receive data and setup new unblocking receives if necessary
-      no_to_recv -= checkReceiveAndContinueReceiving(handle, recv_trackers, recv_requests,
-                                                     recv_buffers, communicator_);
+  /**
+   * @brief Wait for the communication to complete.
+   */
+  void wait()
+  {
+    if(!valid())
+      DUNE_THROW(InvalidFutureException, "The ExchangeFuture is not valid!");
+    if(exchange_) {
+      while(!exchange_->progress(true));
+      exchange_.reset();
+    }
   }
-}
+
+  /**
+   * @brief Continue the communication and test whether it completed.
+   */
+  bool ready() const
+  {
+    if(!valid())
+      DUNE_THROW(InvalidFutureException, "The ExchangeFuture is not valid!");
+    if(exchange_ && exchange_->progress(false))
+      exchange_.reset();
+    return !exchange_;
+  }
+
+  /**
+   * @brief Wait for the communication to complete and invalidate the
+   * future.
+   */
+  void get()
+  {
+    wait();
+    valid_ = false;
+  }
+
+private:
+  /** @brief The state of the communication, empty once it completed. */
+  mutable std::unique_ptr<Exchange<FORWARD,DataHandle> > exchange_;
+  bool valid_;
+};
 
 template<class Allocator>
 template<bool FORWARD, class DataHandle>
 void VariableSizeCommunicator<Allocator>::communicate(DataHandle& handle)
 {
-  if( interface_->size() == 0)
-    // Simply return as otherwise we will index an empty container
-    // either for MPI_Wait_all or MPI_Test_some.
-    return;
-
-  if(Impl::callFixedSize(handle))
-    communicateFixedSize<FORWARD>(handle);
-  else
-    communicateVariableSize<FORWARD>(handle);
+  Exchange<FORWARD,DataHandle> exchange(*this, handle);
+  while(!exchange.progress(true));
 }
 } // end namespace Dune
 
@@ -8,9 +8,12 @@
 #include <cstddef>
 #include <cstdlib>
 #include <cstdint>
+#include <functional>
 #include <ostream>
+#include <type_traits>
 
 #include <dune/common/math.hh>
+#include <dune/common/simd/loopintrinsics.hh>
 #include <dune/common/simd/simd.hh>
 #include <dune/common/typetraits.hh>
 
@@ -176,22 +179,30 @@ namespace Dune {
   };
 
   //Arithmetic operators
-#define DUNE_SIMD_LOOP_BINARY_OP(SYMBOL)                        \
+#define DUNE_SIMD_LOOP_BINARY_OP(SYMBOL, FUNCTOR)               \
   template<class T, std::size_t S, std::size_t A>                                \
   auto operator SYMBOL(const LoopSIMD<T,S,A> &v, const Simd::Scalar<T> s) { \
     LoopSIMD<T,S,A> out;                                                 \
-    DUNE_PRAGMA_OMP_SIMD                                        \
-    for(std::size_t i=0; i<S; i++){                             \
-      out[i] = v[i] SYMBOL s;                                   \
+    if constexpr (Impl::LoopSIMDIntrinsics<T,S>::template supports<FUNCTOR>) \
+      Impl::LoopSIMDKernels<T,S>::apply(FUNCTOR{}, out.data(), v.data(), s); \
+    else {                                                      \
+      DUNE_PRAGMA_OMP_SIMD                                      \
+      for(std::size_t i=0; i<S; i++){                           \
+        out[i] = v[i] SYMBOL s;                                 \
+      }                                                         \
     }                                                           \
     return out;                                                 \
   }                                                             \
   template<class T, std::size_t S, std::size_t A>                              \
   auto operator SYMBOL(const Simd::Scalar<T> s, const LoopSIMD<T,S,A> &v) { \
     LoopSIMD<T,S,A> out;                                                 \
-    DUNE_PRAGMA_OMP_SIMD                                        \
-    for(std::size_t i=0; i<S; i++){                             \
-      out[i] = s SYMBOL v[i];                                   \
+    if constexpr (Impl::LoopSIMDIntrinsics<T,S>::template supports<FUNCTOR>) \
+      Impl::LoopSIMDKernels<T,S>::apply(FUNCTOR{}, out.data(), s, v.data()); \
+    else {                                                      \
+      DUNE_PRAGMA_OMP_SIMD                                      \
+      for(std::size_t i=0; i<S; i++){                           \
+        out[i] = s SYMBOL v[i];                                 \
+      }                                                         \
     }                                                           \
     return out;                                                 \
   }                                                             \
@@ -199,23 +210,27 @@ namespace Dune {
   auto operator SYMBOL(const LoopSIMD<T,S,A> &v,                         \
                        const LoopSIMD<T,S,A> &w) {                       \
     LoopSIMD<T,S,A> out;                                                 \
-    DUNE_PRAGMA_OMP_SIMD                                        \
-    for(std::size_t i=0; i<S; i++){                             \
-      out[i] = v[i] SYMBOL w[i];                                \
+    if constexpr (Impl::LoopSIMDIntrinsics<T,S>::template supports<FUNCTOR>) \
+      Impl::LoopSIMDKernels<T,S>::apply(FUNCTOR{}, out.data(), v.data(), w.data()); \
+    else {                                                      \
+      DUNE_PRAGMA_OMP_SIMD                                      \
+      for(std::size_t i=0; i<S; i++){                           \
+        out[i] = v[i] SYMBOL w[i];                              \
+      }                                                         \
     }                                                           \
     return out;                                                 \
   }                                                             \
   static_assert(true, "expecting ;")
 
-  DUNE_SIMD_LOOP_BINARY_OP(+);
-  DUNE_SIMD_LOOP_BINARY_OP(-);
-  DUNE_SIMD_LOOP_BINARY_OP(*);
-  DUNE_SIMD_LOOP_BINARY_OP(/);
-  DUNE_SIMD_LOOP_BINARY_OP(%);
+  DUNE_SIMD_LOOP_BINARY_OP(+, std::plus<>);
+  DUNE_SIMD_LOOP_BINARY_OP(-, std::minus<>);
+  DUNE_SIMD_LOOP_BINARY_OP(*, std::multiplies<>);
+  DUNE_SIMD_LOOP_BINARY_OP(/, std::divides<>);
+  DUNE_SIMD_LOOP_BINARY_OP(%, std::modulus<>);
 
-  DUNE_SIMD_LOOP_BINARY_OP(&);
-  DUNE_SIMD_LOOP_BINARY_OP(|);
-  DUNE_SIMD_LOOP_BINARY_OP(^);
+  DUNE_SIMD_LOOP_BINARY_OP(&, std::bit_and<>);
+  DUNE_SIMD_LOOP_BINARY_OP(|, std::bit_or<>);
+  DUNE_SIMD_LOOP_BINARY_OP(^, std::bit_xor<>);
 
 #undef DUNE_SIMD_LOOP_BINARY_OP
 
@@ -248,22 +263,31 @@ namespace Dune {
 #undef DUNE_SIMD_LOOP_BITSHIFT_OP
 
   //Comparison operators
-#define DUNE_SIMD_LOOP_COMPARISON_OP(SYMBOL)                      \
+#define DUNE_SIMD_LOOP_COMPARISON_OP(SYMBOL, FUNCTOR)             \
   template<class T, std::size_t S, std::size_t A, class U>                       \
   auto operator SYMBOL(const LoopSIMD<T,S,A> &v, const U s) {            \
     Simd::Mask<LoopSIMD<T,S,A>> out;                                     \
-    DUNE_PRAGMA_OMP_SIMD                                          \
-    for(std::size_t i=0; i<S; i++){                               \
-      out[i] = v[i] SYMBOL s;                                     \
+    if constexpr (std::is_same<U,T>::value &&                     \
+                  Impl::LoopSIMDIntrinsics<T,S>::template supportsCompare<FUNCTOR>) \
+      Impl::LoopSIMDKernels<T,S>::compare(FUNCTOR{}, out.data(), v.data(), s); \
+    else {                                                        \
+      DUNE_PRAGMA_OMP_SIMD                                        \
+      for(std::size_t i=0; i<S; i++){                             \
+        out[i] = v[i] SYMBOL s;                                   \
+      }                                                           \
     }                                                             \
     return out;                                                   \
   }                                                               \
   template<class T, std::size_t S, std::size_t A>                                \
   auto operator SYMBOL(const Simd::Scalar<T> s, const LoopSIMD<T,S,A> &v) { \
     Simd::Mask<LoopSIMD<T,S,A>> out;                                     \
-    DUNE_PRAGMA_OMP_SIMD                                          \
-    for(std::size_t i=0; i<S; i++){                               \
-      out[i] = s SYMBOL v[i];                                     \
+    if constexpr (Impl::LoopSIMDIntrinsics<T,S>::template supportsCompare<FUNCTOR>) \
+      Impl::LoopSIMDKernels<T,S>::compare(FUNCTOR{}, out.data(), s, v.data()); \
+    else {                                                        \
+      DUNE_PRAGMA_OMP_SIMD                                        \
+      for(std::size_t i=0; i<S; i++){                             \
+        out[i] = s SYMBOL v[i];                                   \
+      }                                                           \
     }                                                             \
     return out;                                                   \
   }                                                               \
@@ -271,20 +295,24 @@ namespace Dune {
   auto operator SYMBOL(const LoopSIMD<T,S,A> &v,                         \
                        const LoopSIMD<T,S,A> &w) {                       \
     Simd::Mask<LoopSIMD<T,S,A>> out;                                     \
-    DUNE_PRAGMA_OMP_SIMD                                          \
-    for(std::size_t i=0; i<S; i++){                               \
-      out[i] = v[i] SYMBOL w[i];                                  \
+    if constexpr (Impl::LoopSIMDIntrinsics<T,S>::template supportsCompare<FUNCTOR>) \
+      Impl::LoopSIMDKernels<T,S>::compare(FUNCTOR{}, out.data(), v.data(), w.data()); \
+    else {                                                        \
+      DUNE_PRAGMA_OMP_SIMD                                        \
+      for(std::size_t i=0; i<S; i++){                             \
+        out[i] = v[i] SYMBOL w[i];                                \
+      }                                                           \
     }                                                             \
     return out;                                                   \
   }                                                               \
   static_assert(true, "expecting ;")
 
-  DUNE_SIMD_LOOP_COMPARISON_OP(<);
-  DUNE_SIMD_LOOP_COMPARISON_OP(>);
-  DUNE_SIMD_LOOP_COMPARISON_OP(<=);
-  DUNE_SIMD_LOOP_COMPARISON_OP(>=);
-  DUNE_SIMD_LOOP_COMPARISON_OP(==);
-  DUNE_SIMD_LOOP_COMPARISON_OP(!=);
+  DUNE_SIMD_LOOP_COMPARISON_OP(<, std::less<>);
+  DUNE_SIMD_LOOP_COMPARISON_OP(>, std::greater<>);
+  DUNE_SIMD_LOOP_COMPARISON_OP(<=, std::less_equal<>);
+  DUNE_SIMD_LOOP_COMPARISON_OP(>=, std::greater_equal<>);
+  DUNE_SIMD_LOOP_COMPARISON_OP(==, std::equal_to<>);
+  DUNE_SIMD_LOOP_COMPARISON_OP(!=, std::not_equal_to<>);
 #undef DUNE_SIMD_LOOP_COMPARISON_OP
 
   //Boolean operators
@@ -381,8 +409,12 @@ namespace Dune {
       auto cond(ADLTag<5>, const Simd::Mask<LoopSIMD<T,S,AM>>& mask,
                 const LoopSIMD<T,S,AD>& ifTrue, const LoopSIMD<T,S,AD>& ifFalse) {
         LoopSIMD<T,S,AD> out;
-        for(std::size_t i=0; i<S; i++) {
-          out[i] = Simd::cond(mask[i], ifTrue[i], ifFalse[i]);
+        if constexpr (Impl::LoopSIMDIntrinsics<T,S>::value)
+          Impl::LoopSIMDKernels<T,S>::select(out.data(), mask.data(), ifTrue.data(), ifFalse.data());
+        else {
+          for(std::size_t i=0; i<S; i++) {
+            out[i] = Simd::cond(mask[i], ifTrue[i], ifFalse[i]);
+          }
         }
         return out;
       }
@@ -571,8 +603,12 @@ namespace Dune {
   auto expr(const LoopSIMD<T,S,A> &v, const LoopSIMD<T,S,A> &w) {        \
     using std::expr;                                          \
     LoopSIMD<T,S,A> out;                                       \
-    for(std::size_t i=0; i<S; i++) {                          \
-      out[i] = expr(v[i],w[i]);                               \
+    if constexpr (Impl::LoopSIMDIntrinsics<T,S>::value)        \
+      Impl::LoopSIMDKernels<T,S>::expr(out.data(), v.data(), w.data()); \
+    else {                                                    \
+      for(std::size_t i=0; i<S; i++) {                        \
+        out[i] = expr(v[i],w[i]);                             \
+      }                                                       \
     }                                                         \
     return out;                                               \
   }                                                           \
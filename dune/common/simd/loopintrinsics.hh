@@ -0,0 +1,370 @@
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_SIMD_LOOPINTRINSICS_HH
+#define DUNE_COMMON_SIMD_LOOPINTRINSICS_HH
+
+/** @file
+ *  @brief x86 intrinsics kernels for LoopSIMD of float and double
+ *
+ * LoopSIMD<float,S> and LoopSIMD<double,S> use these kernels for the
+ * arithmetic operators `+`, `-`, `*`, `/`, the comparisons, `cond()` and the
+ * binary `max()`/`min()` whenever their storage is a multiple of a register
+ * size the target supports, e.g. S = 2, 4, 8, 16 for double with SSE2.  The
+ * widest such register is chosen from the target flags at compile time:
+ * AVX-512F (64 bytes), AVX (32 bytes) or SSE2 (16 bytes).  The results are
+ * the same as those of the generic loops, including NaN handling.
+ *
+ * Define `DUNE_SIMD_LOOP_INTRINSICS` to 0 before including any DUNE header to
+ * use the generic loops everywhere.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+#ifndef DUNE_SIMD_LOOP_INTRINSICS
+#define DUNE_SIMD_LOOP_INTRINSICS 1
+#endif
+
+#if DUNE_SIMD_LOOP_INTRINSICS && (defined(__SSE2__) || defined(__AVX__) || defined(__AVX512F__))
+#include <immintrin.h>
+#endif
+
+namespace Dune {
+  namespace Impl {
+
+    //! the values of n <= 8 consecutive bool as bits, by multiplying their bytes into the top byte
+    template<std::size_t n>
+    unsigned gatherBoolBits (const bool* b)
+    {
+      std::uint64_t x = 0;
+      std::memcpy(&x, b, n);
+      return unsigned((x * 0x0102040810204080ULL) >> 56);
+    }
+
+    //! the inverse of gatherBoolBits(), adding 0x7F carries the nonzero bytes into their top bit
+    template<std::size_t n>
+    void scatterBoolBits (unsigned bits, bool* b)
+    {
+      std::uint64_t x = ((bits & 0xFFu) * 0x0101010101010101ULL) & 0x8040201008040201ULL;
+      x = ((x + 0x7F7F7F7F7F7F7F7FULL) >> 7) & 0x0101010101010101ULL;
+      std::memcpy(b, &x, n);
+    }
+
+    /* A register of the given size holding elements of type T
+     *
+     * Specializations provide load/store/broadcast, the arithmetic
+     * operations as overloads of apply() for the std function objects,
+     * comparisons returning one bit per element, and select() blending two
+     * registers according to an array of bool.
+     */
+    template<class T, std::size_t bytes>
+    struct X86Register
+    {
+      static constexpr bool available = false;
+    };
+
+#if DUNE_SIMD_LOOP_INTRINSICS && defined(__SSE2__)
+    //! n <= 8 consecutive bool as bytes 0xFF or 0
+    template<std::size_t n>
+    __m128i boolBytes (const bool* b)
+    {
+      long long x = 0;
+      std::memcpy(&x, b, n);
+      // _mm_cvtsi64_si128 is only available on x86-64
+      return _mm_sub_epi8(_mm_setzero_si128(),
+                          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&x)));
+    }
+
+    template<>
+    struct X86Register<double, 16>
+    {
+      static constexpr bool available = true;
+      using type = __m128d;
+
+      static type load(const double* p) { return _mm_loadu_pd(p); }
+      static void store(double* p, type a) { _mm_storeu_pd(p, a); }
+      static type broadcast(double s) { return _mm_set1_pd(s); }
+
+      static type apply(std::plus<>, type a, type b) { return _mm_add_pd(a, b); }
+      static type apply(std::minus<>, type a, type b) { return _mm_sub_pd(a, b); }
+      static type apply(std::multiplies<>, type a, type b) { return _mm_mul_pd(a, b); }
+      static type apply(std::divides<>, type a, type b) { return _mm_div_pd(a, b); }
+      // the second operand is returned for NaN and equal zeros, like std::max(b,a)
+      static type max(type a, type b) { return _mm_max_pd(a, b); }
+      static type min(type a, type b) { return _mm_min_pd(a, b); }
+
+      static unsigned compare(std::less<>, type a, type b) { return _mm_movemask_pd(_mm_cmplt_pd(a, b)); }
+      static unsigned compare(std::greater<>, type a, type b) { return _mm_movemask_pd(_mm_cmpgt_pd(a, b)); }
+      static unsigned compare(std::less_equal<>, type a, type b) { return _mm_movemask_pd(_mm_cmple_pd(a, b)); }
+      static unsigned compare(std::greater_equal<>, type a, type b) { return _mm_movemask_pd(_mm_cmpge_pd(a, b)); }
+      static unsigned compare(std::equal_to<>, type a, type b) { return _mm_movemask_pd(_mm_cmpeq_pd(a, b)); }
+      static unsigned compare(std::not_equal_to<>, type a, type b) { return _mm_movemask_pd(_mm_cmpneq_pd(a, b)); }
+
+      static type select(const bool* mask, type t, type f)
+      {
+        __m128i m = boolBytes<2>(mask);
+        m = _mm_unpacklo_epi8(m, m);
+        m = _mm_unpacklo_epi16(m, m);
+        const type md = _mm_castsi128_pd(_mm_unpacklo_epi32(m, m));
+        return _mm_or_pd(_mm_and_pd(md, t), _mm_andnot_pd(md, f));
+      }
+    };
+
+    template<>
+    struct X86Register<float, 16>
+    {
+      static constexpr bool available = true;
+      using type = __m128;
+
+      static type load(const float* p) { return _mm_loadu_ps(p); }
+      static void store(float* p, type a) { _mm_storeu_ps(p, a); }
+      static type broadcast(float s) { return _mm_set1_ps(s); }
+
+      static type apply(std::plus<>, type a, type b) { return _mm_add_ps(a, b); }
+      static type apply(std::minus<>, type a, type b) { return _mm_sub_ps(a, b); }
+      static type apply(std::multiplies<>, type a, type b) { return _mm_mul_ps(a, b); }
+      static type apply(std::divides<>, type a, type b) { return _mm_div_ps(a, b); }
+      static type max(type a, type b) { return _mm_max_ps(a, b); }
+      static type min(type a, type b) { return _mm_min_ps(a, b); }
+
+      static unsigned compare(std::less<>, type a, type b) { return _mm_movemask_ps(_mm_cmplt_ps(a, b)); }
+      static unsigned compare(std::greater<>, type a, type b) { return _mm_movemask_ps(_mm_cmpgt_ps(a, b)); }
+      static unsigned compare(std::less_equal<>, type a, type b) { return _mm_movemask_ps(_mm_cmple_ps(a, b)); }
+      static unsigned compare(std::greater_equal<>, type a, type b) { return _mm_movemask_ps(_mm_cmpge_ps(a, b)); }
+      static unsigned compare(std::equal_to<>, type a, type b) { return _mm_movemask_ps(_mm_cmpeq_ps(a, b)); }
+      static unsigned compare(std::not_equal_to<>, type a, type b) { return _mm_movemask_ps(_mm_cmpneq_ps(a, b)); }
+
+      static type select(const bool* mask, type t, type f)
+      {
+        __m128i m = boolBytes<4>(mask);
+        m = _mm_unpacklo_epi8(m, m);
+        const type ms = _mm_castsi128_ps(_mm_unpacklo_epi16(m, m));
+        return _mm_or_ps(_mm_and_ps(ms, t), _mm_andnot_ps(ms, f));
+      }
+    };
+#endif // __SSE2__
+
+#if DUNE_SIMD_LOOP_INTRINSICS && defined(__AVX__)
+    template<>
+    struct X86Register<double, 32>
+    {
+      static constexpr bool available = true;
+      using type = __m256d;
+
+      static type load(const double* p) { return _mm256_loadu_pd(p); }
+      static void store(double* p, type a) { _mm256_storeu_pd(p, a); }
+      static type broadcast(double s) { return _mm256_set1_pd(s); }
+
+      static type apply(std::plus<>, type a, type b) { return _mm256_add_pd(a, b); }
+      static type apply(std::minus<>, type a, type b) { return _mm256_sub_pd(a, b); }
+      static type apply(std::multiplies<>, type a, type b) { return _mm256_mul_pd(a, b); }
+      static type apply(std::divides<>, type a, type b) { return _mm256_div_pd(a, b); }
+      static type max(type a, type b) { return _mm256_max_pd(a, b); }
+      static type min(type a, type b) { return _mm256_min_pd(a, b); }
+
+      static unsigned compare(std::less<>, type a, type b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ)); }
+      static unsigned compare(std::greater<>, type a, type b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ)); }
+      static unsigned compare(std::less_equal<>, type a, type b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LE_OQ)); }
+      static unsigned compare(std::greater_equal<>, type a, type b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GE_OQ)); }
+      static unsigned compare(std::equal_to<>, type a, type b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+      static unsigned compare(std::not_equal_to<>, type a, type b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_NEQ_UQ)); }
+
+      static type select(const bool* mask, type t, type f)
+      {
+        __m128i m = boolBytes<4>(mask);
+        m = _mm_unpacklo_epi8(m, m);
+        m = _mm_unpacklo_epi16(m, m);
+        const __m256i mi = _mm256_set_m128i(_mm_unpackhi_epi32(m, m), _mm_unpacklo_epi32(m, m));
+        return _mm256_blendv_pd(f, t, _mm256_castsi256_pd(mi));
+      }
+    };
+
+    template<>
+    struct X86Register<float, 32>
+    {
+      static constexpr bool available = true;
+      using type = __m256;
+
+      static type load(const float* p) { return _mm256_loadu_ps(p); }
+      static void store(float* p, type a) { _mm256_storeu_ps(p, a); }
+      static type broadcast(float s) { return _mm256_set1_ps(s); }
+
+      static type apply(std::plus<>, type a, type b) { return _mm256_add_ps(a, b); }
+      static type apply(std::minus<>, type a, type b) { return _mm256_sub_ps(a, b); }
+      static type apply(std::multiplies<>, type a, type b) { return _mm256_mul_ps(a, b); }
+      static type apply(std::divides<>, type a, type b) { return _mm256_div_ps(a, b); }
+      static type max(type a, type b) { return _mm256_max_ps(a, b); }
+      static type min(type a, type b) { return _mm256_min_ps(a, b); }
+
+      static unsigned compare(std::less<>, type a, type b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+      static unsigned compare(std::greater<>, type a, type b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ)); }
+      static unsigned compare(std::less_equal<>, type a, type b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LE_OQ)); }
+      static unsigned compare(std::greater_equal<>, type a, type b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GE_OQ)); }
+      static unsigned compare(std::equal_to<>, type a, type b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+      static unsigned compare(std::not_equal_to<>, type a, type b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_NEQ_UQ)); }
+
+      static type select(const bool* mask, type t, type f)
+      {
+        __m128i m = boolBytes<8>(mask);
+        m = _mm_unpacklo_epi8(m, m);
+        const __m256i mi = _mm256_set_m128i(_mm_unpackhi_epi16(m, m), _mm_unpacklo_epi16(m, m));
+        return _mm256_blendv_ps(f, t, _mm256_castsi256_ps(mi));
+      }
+    };
+#endif // __AVX__
+
+#if DUNE_SIMD_LOOP_INTRINSICS && defined(__AVX512F__)
+    template<>
+    struct X86Register<double, 64>
+    {
+      static constexpr bool available = true;
+      using type = __m512d;
+
+      static type load(const double* p) { return _mm512_loadu_pd(p); }
+      static void store(double* p, type a) { _mm512_storeu_pd(p, a); }
+      static type broadcast(double s) { return _mm512_set1_pd(s); }
+
+      static type apply(std::plus<>, type a, type b) { return _mm512_add_pd(a, b); }
+      static type apply(std::minus<>, type a, type b) { return _mm512_sub_pd(a, b); }
+      static type apply(std::multiplies<>, type a, type b) { return _mm512_mul_pd(a, b); }
+      static type apply(std::divides<>, type a, type b) { return _mm512_div_pd(a, b); }
+      // the zero-masked forms avoid GCC's -Wuninitialized on _mm512_undefined_pd()
+      static type max(type a, type b) { return _mm512_maskz_max_pd(__mmask8(-1), a, b); }
+      static type min(type a, type b) { return _mm512_maskz_min_pd(__mmask8(-1), a, b); }
+
+      static unsigned compare(std::less<>, type a, type b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+      static unsigned compare(std::greater<>, type a, type b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+      static unsigned compare(std::less_equal<>, type a, type b) { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+      static unsigned compare(std::greater_equal<>, type a, type b) { return _mm512_cmp_pd_mask(a, b, _CMP_GE_OQ); }
+      static unsigned compare(std::equal_to<>, type a, type b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+      static unsigned compare(std::not_equal_to<>, type a, type b) { return _mm512_cmp_pd_mask(a, b, _CMP_NEQ_UQ); }
+
+      static type select(const bool* mask, type t, type f)
+      {
+        return _mm512_mask_blend_pd(__mmask8(gatherBoolBits<8>(mask)), f, t);
+      }
+    };
+
+    template<>
+    struct X86Register<float, 64>
+    {
+      static constexpr bool available = true;
+      using type = __m512;
+
+      static type load(const float* p) { return _mm512_loadu_ps(p); }
+      static void store(float* p, type a) { _mm512_storeu_ps(p, a); }
+      static type broadcast(float s) { return _mm512_set1_ps(s); }
+
+      static type apply(std::plus<>, type a, type b) { return _mm512_add_ps(a, b); }
+      static type apply(std::minus<>, type a, type b) { return _mm512_sub_ps(a, b); }
+      static type apply(std::multiplies<>, type a, type b) { return _mm512_mul_ps(a, b); }
+      static type apply(std::divides<>, type a, type b) { return _mm512_div_ps(a, b); }
+      static type max(type a, type b) { return _mm512_maskz_max_ps(__mmask16(-1), a, b); }
+      static type min(type a, type b) { return _mm512_maskz_min_ps(__mmask16(-1), a, b); }
+
+      static unsigned compare(std::less<>, type a, type b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+      static unsigned compare(std::greater<>, type a, type b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+      static unsigned compare(std::less_equal<>, type a, type b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+      static unsigned compare(std::greater_equal<>, type a, type b) { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+      static unsigned compare(std::equal_to<>, type a, type b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+      static unsigned compare(std::not_equal_to<>, type a, type b) { return _mm512_cmp_ps_mask(a, b, _CMP_NEQ_UQ); }
+
+      static type select(const bool* mask, type t, type f)
+      {
+        return _mm512_mask_blend_ps(__mmask16(gatherBoolBits<8>(mask) | (gatherBoolBits<8>(mask + 8) << 8)), f, t);
+      }
+    };
+#endif // __AVX512F__
+
+    //! The widest register size available for T that divides `storage` bytes, 0 if none
+    template<class T>
+    constexpr std::size_t x86RegisterBytes (std::size_t storage)
+    {
+      for (std::size_t bytes : {64, 32, 16})
+        if (storage % bytes == 0 &&
+            ((bytes == 64 && X86Register<T, 64>::available) ||
+             (bytes == 32 && X86Register<T, 32>::available) ||
+             (bytes == 16 && X86Register<T, 16>::available)))
+          return bytes;
+      return 0;
+    }
+
+    /* Kernels for the S entries of LoopSIMD<T,S>
+     *
+     * `value` tells whether the kernels are available.  Operands are either
+     * pointers to S entries or scalars that are broadcast, masks are arrays
+     * of S bool.
+     */
+    template<class T, std::size_t S>
+    struct LoopSIMDIntrinsics
+    {
+      using Reg = X86Register<T, x86RegisterBytes<T>(S*sizeof(T))>;
+      static constexpr bool value = Reg::available;
+
+      //! whether the operation Op, e.g. std::plus<>, has a kernel
+      template<class Op, class R = Reg>
+      static constexpr bool supports = requires(typename R::type a) { R::apply(Op{}, a, a); };
+
+      //! whether the comparison Op, e.g. std::less<>, has a kernel
+      template<class Op, class R = Reg>
+      static constexpr bool supportsCompare = requires(typename R::type a) { R::compare(Op{}, a, a); };
+    };
+
+    template<class T, std::size_t S>
+      requires LoopSIMDIntrinsics<T, S>::value
+    struct LoopSIMDKernels
+    {
+      using Reg = typename LoopSIMDIntrinsics<T, S>::Reg;
+      using Type = typename Reg::type;
+      static constexpr std::size_t width = sizeof(Type) / sizeof(T);
+      static constexpr std::size_t count = S / width;
+
+      static Type get(const T* p, std::size_t k) { return Reg::load(p + k*width); }
+      static Type get(T s, std::size_t) { return Reg::broadcast(s); }
+
+      template<class Op, class X, class Y>
+      static void apply(Op op, T* out, const X& x, const Y& y)
+      {
+        for (std::size_t k = 0; k < count; ++k)
+          Reg::store(out + k*width, Reg::apply(op, get(x, k), get(y, k)));
+      }
+
+      template<class Op, class X, class Y>
+      static void compare(Op op, bool* out, const X& x, const Y& y)
+      {
+        for (std::size_t k = 0; k < count; ++k)
+        {
+          const unsigned bits = Reg::compare(op, get(x, k), get(y, k));
+          for (std::size_t j = 0; j < width; j += 8)
+            scatterBoolBits<std::min<std::size_t>(width, 8)>(bits >> j, out + k*width + j);
+        }
+      }
+
+      static void select(T* out, const bool* mask, const T* t, const T* f)
+      {
+        for (std::size_t k = 0; k < count; ++k)
+          Reg::store(out + k*width, Reg::select(mask + k*width, get(t, k), get(f, k)));
+      }
+
+      // same results as std::max(x[i], y[i]) and std::min(x[i], y[i])
+      static void max(T* out, const T* x, const T* y)
+      {
+        for (std::size_t k = 0; k < count; ++k)
+          Reg::store(out + k*width, Reg::max(get(y, k), get(x, k)));
+      }
+
+      static void min(T* out, const T* x, const T* y)
+      {
+        for (std::size_t k = 0; k < count; ++k)
+          Reg::store(out + k*width, Reg::min(get(y, k), get(x, k)));
+      }
+    };
+
+  } // end namespace Impl
+} // end namespace Dune
+
+#endif // DUNE_COMMON_SIMD_LOOPINTRINSICS_HH
@@ -0,0 +1,560 @@
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_SIMD_STDSIMD_HH
+#define DUNE_COMMON_SIMD_STDSIMD_HH
+
+/** @file
+ *  @ingroup SIMDStdSimd
+ *  @brief SIMD abstractions for std::experimental::simd
+ */
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include <experimental/simd>
+
+#include <dune/common/indices.hh>
+#include <dune/common/simd/base.hh>
+#include <dune/common/simd/defaults.hh>
+#include <dune/common/simd/loop.hh>
+#include <dune/common/typetraits.hh>
+
+/** @defgroup SIMDStdSimd SIMD Abstraction Implementation for std::experimental::simd
+ *  @ingroup SIMDApp
+ *
+ * This implements the vectorization interface for the types of the
+ * Parallelism TS 2, namely `std::experimental::simd` and
+ * `std::experimental::simd_mask` with any ABI tag, e.g.
+ * `std::experimental::native_simd<double>` or
+ * `std::experimental::fixed_size_simd<float, 8>`.  Unlike the Vc abstraction
+ * this does not need any external library, the types are provided by the
+ * standard library (libstdc++ since GCC 11).
+ *
+ * As an application developer, you need to `#include
+ * <dune/common/simd/stdsimd.hh>`.  You need to make sure that
+ * `DUNE_HAVE_CXX_EXPERIMENTAL_SIMD` is true before doing so:
+ *
+ * - If your program works both in the presence and the absence of
+ *   `<experimental/simd>`, wrap the include in `#if
+ *   DUNE_HAVE_CXX_EXPERIMENTAL_SIMD` and `#endif`
+ *
+ * - If you write a unit test, in your `CMakeLists.txt` use
+ *   `dune_add_test(... CMAKE_GUARD DUNE_HAVE_CXX_EXPERIMENTAL_SIMD)`
+ *
+ * The width of `native_simd` is determined by the instruction set the
+ * compiler targets, so you will usually want to compile with flags like
+ * `-march=native` to get more than SSE2 on x86_64.
+ *
+ * @section SIMDStdSimdRestrictions Restrictions
+ *
+ * - Broadcasts and mixed vector-scalar operations only accept scalars that
+ *   convert to `Scalar<V>` without loss of information, and `int`.  Use
+ *   `Simd::broadcast<V>()` or an explicit conversion otherwise.
+ *
+ * - `&&` and `||` are only available for masks; use `Simd::maskAnd()` and
+ *   `Simd::maskOr()` for vectors, as required by the interface anyway.
+ *
+ * - `==` and `!=` on masks yield masks, not `bool`.
+ *
+ * - The element access operator of the vector types returns a proxy that
+ *   cannot be copied and only accepts value-preserving assignments.
+ *   `Simd::lane()` therefore returns a proxy of its own on mutable lvalues.
+ */
+
+namespace Dune {
+  namespace Simd {
+
+    namespace StdSimdImpl {
+
+      namespace stdx = std::experimental;
+
+      //! specialized to true for std::experimental::simd_mask types
+      template<class V>
+      struct IsMask : std::false_type {};
+
+      template<class T, class Abi>
+      struct IsMask<stdx::simd_mask<T, Abi> > : std::true_type {};
+
+      //! specialized to true for std::experimental::simd and simd_mask types
+      template<class V>
+      struct IsVector : IsMask<V> {};
+
+      template<class T, class Abi>
+      struct IsVector<stdx::simd<T, Abi> > : std::true_type {};
+
+      //! whether std::experimental::simd can hold elements of type T
+      template<class T>
+      struct IsVectorizable
+        : std::bool_constant<std::is_arithmetic<T>::value &&
+                             !std::is_same<T, bool>::value> {};
+
+      //! the simd type a simd or simd_mask type belongs to
+      template<class V>
+      struct VectorType;
+
+      template<class T, class Abi>
+      struct VectorType<stdx::simd<T, Abi> > { using type = stdx::simd<T, Abi>; };
+
+      template<class T, class Abi>
+      struct VectorType<stdx::simd_mask<T, Abi> > { using type = stdx::simd<T, Abi>; };
+
+      //! A reference-like proxy for elements of std::experimental::simd
+      /**
+       * The element access operator of std::experimental::simd returns a
+       * proxy that can neither be copied nor assigned from values that would
+       * need to be converted to the element type with loss of information.
+       * This class holds a reference to the vector and a lane index instead,
+       * and converts assigned values explicitly.
+       *
+       * The vector type is deliberately not a template argument: that would
+       * make argument-dependent lookup find the operators of the vector type,
+       * which are non-template friends accepting anything that converts to
+       * the vector.  These would be ambiguous with the built-in operators for
+       * operations between two proxies.
+       */
+      template<class E, class Abi, bool isMask>
+      class Proxy
+      {
+      public:
+        using vector_type = std::conditional_t<isMask,
+                                               stdx::simd_mask<E, Abi>,
+                                               stdx::simd<E, Abi> >;
+        using value_type = typename vector_type::value_type;
+
+      private:
+        vector_type &vec_;
+        std::size_t idx_;
+
+        value_type get() const { return vec_[idx_]; }
+        void set(const value_type &v) const { vec_[idx_] = v; }
+
+      public:
+        Proxy(std::size_t idx, vector_type &vec)
+          : vec_(vec), idx_(idx)
+        { }
+
+        Proxy(const Proxy&) = delete;
+        // allow move construction so we can return proxies from functions
+        Proxy(Proxy&&) = default;
+
+        operator value_type() const { return get(); }
+
+        // The vectors broadcast from proxies implicitly, since these convert
+        // to their elements.  The broadcast constructor of the masks is
+        // explicit, so provide the conversion for mixed mask operations.
+        template<class T, class A, bool m = isMask,
+                 class = std::enable_if_t<m> >
+        operator stdx::simd_mask<T, A>() const
+        {
+          return stdx::simd_mask<T, A>(get());
+        }
+
+        // The vectors provide shifts by vectors and by int.  Both would
+        // need a conversion of the proxy, so spell out the shift by the
+        // proxied element.
+#define DUNE_SIMD_STDSIMD_SHIFT(OP)                                     \
+        template<class A>                                               \
+        friend auto operator OP(const stdx::simd<E, A> &l, const Proxy &r) \
+          -> decltype(l OP std::declval<value_type>())                  \
+        {                                                               \
+          return l OP r.get();                                          \
+        }                                                               \
+        template<class A>                                               \
+        friend auto operator OP##=(stdx::simd<E, A> &l, const Proxy &r) \
+          -> decltype(l OP##= std::declval<value_type>())               \
+        {                                                               \
+          return l OP##= r.get();                                       \
+        }
+        DUNE_SIMD_STDSIMD_SHIFT(<<);
+        DUNE_SIMD_STDSIMD_SHIFT(>>);
+#undef DUNE_SIMD_STDSIMD_SHIFT
+
+        // assignment operators
+        template<class T,
+                 class = decltype(std::declval<value_type&>() =
+                                  autoCopy(std::declval<T>()) )>
+        Proxy operator=(T &&o) &&
+        {
+          set(static_cast<value_type>(autoCopy(std::forward<T>(o))));
+          return { idx_, vec_ };
+        }
+
+#define DUNE_SIMD_STDSIMD_ASSIGNMENT(OP)                         \
+        template<class T,                                        \
+                 class = decltype(std::declval<value_type&>() OP \
+                                  autoCopy(std::declval<T>()) )> \
+        Proxy operator OP(T &&o) &&                              \
+        {                                                        \
+          value_type tmp = get();                                \
+          tmp OP autoCopy(std::forward<T>(o));                   \
+          set(tmp);                                              \
+          return { idx_, vec_ };                                 \
+        }
+        DUNE_SIMD_STDSIMD_ASSIGNMENT(*=);
+        DUNE_SIMD_STDSIMD_ASSIGNMENT(/=);
+        DUNE_SIMD_STDSIMD_ASSIGNMENT(%=);
+        DUNE_SIMD_STDSIMD_ASSIGNMENT(+=);
+        DUNE_SIMD_STDSIMD_ASSIGNMENT(-=);
+        DUNE_SIMD_STDSIMD_ASSIGNMENT(<<=);
+        DUNE_SIMD_STDSIMD_ASSIGNMENT(>>=);
+        DUNE_SIMD_STDSIMD_ASSIGNMENT(&=);
+        DUNE_SIMD_STDSIMD_ASSIGNMENT(^=);
+        DUNE_SIMD_STDSIMD_ASSIGNMENT(|=);
+#undef DUNE_SIMD_STDSIMD_ASSIGNMENT
+
+        // unary (prefix) operators
+        template<class T = value_type,
+                 class = std::enable_if_t<!std::is_same<T, bool>::value> >
+        Proxy operator++()
+        {
+          value_type tmp = get();
+          set(++tmp);
+          return { idx_, vec_ };
+        }
+        template<class T = value_type,
+                 class = std::enable_if_t<!std::is_same<T, bool>::value> >
+        Proxy operator--()
+        {
+          value_type tmp = get();
+          set(--tmp);
+          return { idx_, vec_ };
+        }
+
+        // postfix operators
+        template<class T = value_type,
+                 class = std::enable_if_t<!std::is_same<T, bool>::value> >
+        value_type operator++(int)
+        {
+          value_type tmp = get();
+          value_type result = tmp++;
+          set(tmp);
+          return result;
+        }
+        template<class T = value_type,
+                 class = std::enable_if_t<!std::is_same<T, bool>::value> >
+        value_type operator--(int)
+        {
+          value_type tmp = get();
+          value_type result = tmp--;
+          set(tmp);
+          return result;
+        }
+
+        // swap on proxies swaps the proxied vector entries.  As such, it
+        // applies to rvalues of proxies too, not just lvalues
+        friend void swap(const Proxy &a, const Proxy &b) {
+          value_type tmp = a.get();
+          a.set(b.get());
+          b.set(tmp);
+        }
+        friend void swap(value_type &a, const Proxy &b) {
+          value_type tmp = a;
+          a = b.get();
+          b.set(tmp);
+        }
+        friend void swap(const Proxy &a, value_type &b) {
+          value_type tmp = a.get();
+          a.set(b);
+          b = tmp;
+        }
+      };
+
+    } // namespace StdSimdImpl
+
+    namespace Overloads {
+
+      /** @name Specialized classes and overloaded functions
+       *  @ingroup SIMDStdSimd
+       *  @{
+       */
+
+      //! should have a member type \c type
+      /**
+       * Implements Simd::Scalar
+       */
+      template<class V>
+      struct ScalarType<V, std::enable_if_t<StdSimdImpl::IsVector<V>::value> >
+      {
+        using type = typename V::value_type;
+      };
+
+      //! should have a member type \c type
+      /**
+       * Implements Simd::Rebind
+       *
+       * This specialization covers
+       * - simd_mask -> bool
+       * - simd -> Scalar<simd>
+       */
+      template<class V>
+      struct RebindType<Simd::Scalar<V>, V,
+                        std::enable_if_t<StdSimdImpl::IsVector<V>::value> >
+      {
+        using type = V;
+      };
+
+      //! should have a member type \c type
+      /**
+       * Implements Simd::Rebind
+       *
+       * This specialization covers
+       * - simd -> bool
+       */
+      template<class V>
+      struct RebindType<bool, V,
+                        std::enable_if_t<StdSimdImpl::IsVector<V>::value &&
+                                         !StdSimdImpl::IsMask<V>::value> >
+      {
+        using type = typename V::mask_type;
+      };
+
+      //! should have a member type \c type
+      /**
+       * Implements Simd::Rebind
+       *
+       * This specialization covers
+       * - simd_mask -> vectorizable type
+       * - simd -> vectorizable type except Scalar<simd>
+       *
+       * The ABI of the result is deduced by
+       * `std::experimental::rebind_simd_t`, so the result has the same number
+       * of lanes, but may use a different number of registers.
+       */
+      template<class S, class V>
+      struct RebindType<S, V,
+                        std::enable_if_t<StdSimdImpl::IsVector<V>::value &&
+                                         StdSimdImpl::IsVectorizable<S>::value &&
+                                         !std::is_same<S, Scalar<V> >::value> >
+      {
+        using type = std::experimental::rebind_simd_t<
+          S, typename StdSimdImpl::VectorType<V>::type>;
+      };
+
+      //! should have a member type \c type
+      /**
+       * Implements Simd::Rebind
+       *
+       * This specialization covers
+       * - simd_mask -> non-vectorizable type except bool
+       * - simd -> non-vectorizable type except bool
+       */
+      template<class S, class V>
+      struct RebindType<S, V,
+                        std::enable_if_t<StdSimdImpl::IsVector<V>::value &&
+                                         !StdSimdImpl::IsVectorizable<S>::value &&
+                                         !std::is_same<S, bool>::value> >
+      {
+        using type = LoopSIMD<S, Simd::lanes<V>()>;
+      };
+
+      //! should be derived from an Dune::index_constant
+      /**
+       * Implements Simd::lanes()
+       */
+      template<class V>
+      struct LaneCount<V, std::enable_if_t<StdSimdImpl::IsVector<V>::value> >
+        : public index_constant<V::size()>
+      { };
+
+      //! implements Simd::lane()
+      template<class V>
+      auto lane(ADLTag<5, StdSimdImpl::IsVector<V>::value>,
+                std::size_t l, V &v)
+      {
+        using Vector = typename StdSimdImpl::VectorType<V>::type;
+        return StdSimdImpl::Proxy<typename Vector::value_type,
+                                  typename Vector::abi_type,
+                                  StdSimdImpl::IsMask<V>::value>{ l, v };
+      }
+
+      //! implements Simd::lane()
+      template<class V>
+      Scalar<V> lane(ADLTag<5, StdSimdImpl::IsVector<V>::value>,
+                     std::size_t l, const V &v)
+      {
+        return v[l];
+      }
+
+      //! implements Simd::lane()
+      template<class V,
+               class = std::enable_if_t<!std::is_reference<V>::value> >
+      Scalar<V> lane(ADLTag<5, StdSimdImpl::IsVector<V>::value>,
+                     std::size_t l, V &&v)
+      {
+        return v[l];
+      }
+
+      //! implements Simd::cond()
+      template<class V>
+      V cond(ADLTag<5, StdSimdImpl::IsVector<V>::value &&
+                       !StdSimdImpl::IsMask<V>::value>,
+             const Mask<V> &mask, const V &ifTrue, const V &ifFalse)
+      {
+        V result = ifFalse;
+        where(mask, result) = ifTrue;
+        return result;
+      }
+
+      //! implements Simd::cond()
+      template<class V>
+      V cond(ADLTag<5, StdSimdImpl::IsMask<V>::value>,
+             const V &mask, const V &ifTrue, const V &ifFalse)
+      {
+        return (mask && ifTrue) || (!mask && ifFalse);
+      }
+
+      //! implements binary Simd::max()
+      template<class V>
+      auto max(ADLTag<5, StdSimdImpl::IsVector<V>::value &&
+                         !StdSimdImpl::IsMask<V>::value>,
+               const V &v1, const V &v2)
+      {
+        return std::experimental::max(v1, v2);
+      }
+
+      //! implements binary Simd::max()
+      template<class M>
+      auto max(ADLTag<5, StdSimdImpl::IsMask<M>::value>,
+               const M &m1, const M &m2)
+      {
+        return m1 || m2;
+      }
+
+      //! implements binary Simd::min()
+      template<class V>
+      auto min(ADLTag<5, StdSimdImpl::IsVector<V>::value &&
+                         !StdSimdImpl::IsMask<V>::value>,
+               const V &v1, const V &v2)
+      {
+        return std::experimental::min(v1, v2);
+      }
+
+      //! implements binary Simd::min()
+      template<class M>
+      auto min(ADLTag<5, StdSimdImpl::IsMask<M>::value>,
+               const M &m1, const M &m2)
+      {
+        return m1 && m2;
+      }
+
+      //! implements Simd::anyTrue()
+      template<class M>
+      bool anyTrue (ADLTag<5, StdSimdImpl::IsMask<M>::value>, const M &mask)
+      {
+        return std::experimental::any_of(mask);
+      }
+
+      //! implements Simd::allTrue()
+      template<class M>
+      bool allTrue (ADLTag<5, StdSimdImpl::IsMask<M>::value>, const M &mask)
+      {
+        return std::experimental::all_of(mask);
+      }
+
+      //! implements Simd::anyFalse()
+      template<class M>
+      bool anyFalse(ADLTag<5, StdSimdImpl::IsMask<M>::value>, const M &mask)
+      {
+        return !std::experimental::all_of(mask);
+      }
+
+      //! implements Simd::allFalse()
+      template<class M>
+      bool allFalse(ADLTag<5, StdSimdImpl::IsMask<M>::value>, const M &mask)
+      {
+        return std::experimental::none_of(mask);
+      }
+
+      //! implements Simd::maxValue()
+      template<class V>
+      auto max(ADLTag<5, StdSimdImpl::IsVector<V>::value &&
+                         !StdSimdImpl::IsMask<V>::value>,
+               const V &v)
+      {
+        return std::experimental::hmax(v);
+      }
+
+      //! implements Simd::maxValue()
+      template<class M>
+      bool max(ADLTag<5, StdSimdImpl::IsMask<M>::value>, const M &mask)
+      {
+        return std::experimental::any_of(mask);
+      }
+
+      //! implements Simd::minValue()
+      template<class V>
+      auto min(ADLTag<5, StdSimdImpl::IsVector<V>::value &&
+                         !StdSimdImpl::IsMask<V>::value>,
+               const V &v)
+      {
+        return std::experimental::hmin(v);
+      }
+
+      //! implements Simd::minValue()
+      template<class M>
+      bool min(ADLTag<5, StdSimdImpl::IsMask<M>::value>, const M &mask)
+      {
+        return std::experimental::all_of(mask);
+      }
+
+      //! implements Simd::maskAnd()
+      template<class S1, class V2>
+      auto maskAnd(ADLTag<5, std::is_same<Mask<S1>, bool>::value &&
+                             StdSimdImpl::IsVector<V2>::value>,
+                   const S1 &s1, const V2 &v2)
+      {
+        return Simd::Mask<V2>(Simd::mask(s1)) && Simd::mask(v2);
+      }
+
+      //! implements Simd::maskAnd()
+      template<class V1, class S2>
+      auto maskAnd(ADLTag<5, StdSimdImpl::IsVector<V1>::value &&
+                             std::is_same<Mask<S2>, bool>::value>,
+                   const V1 &v1, const S2 &s2)
+      {
+        return Simd::mask(v1) && Simd::Mask<V1>(Simd::mask(s2));
+      }
+
+      //! implements Simd::maskOr()
+      template<class S1, class V2>
+      auto maskOr(ADLTag<5, std::is_same<Mask<S1>, bool>::value &&
+                            StdSimdImpl::IsVector<V2>::value>,
+                   const S1 &s1, const V2 &v2)
+      {
+        return Simd::Mask<V2>(Simd::mask(s1)) || Simd::mask(v2);
+      }
+
+      //! implements Simd::maskOr()
+      template<class V1, class S2>
+      auto maskOr(ADLTag<5, StdSimdImpl::IsVector<V1>::value &&
+                            std::is_same<Mask<S2>, bool>::value>,
+                   const V1 &v1, const S2 &s2)
+      {
+        return Simd::mask(v1) || Simd::Mask<V1>(Simd::mask(s2));
+      }
+
+      //! @} group SIMDStdSimd
+
+    } // namespace Overloads
+
+  } // namespace Simd
+
+  /*
+   * Specialize IsNumber for std::experimental::simd to be able to use it as a
+   * scalar in DenseMatrix etc.
+   */
+  template <typename T, typename Abi>
+  struct IsNumber<std::experimental::simd<T, Abi>>
+    : public std::integral_constant<bool, IsNumber<T>::value> {
+  };
+
+  //! Specialization of AutonomousValue for std::experimental::simd proxies
+  template<class T, class Abi, bool isMask>
+  struct AutonomousValueType<Simd::StdSimdImpl::Proxy<T, Abi, isMask> > :
+    AutonomousValueType<
+      typename Simd::StdSimdImpl::Proxy<T, Abi, isMask>::value_type> {};
+
+} // namespace Dune
+
+#endif // DUNE_COMMON_SIMD_STDSIMD_HH
@@ -0,0 +1,209 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <vector>
+
+#include <dune/common/arenaallocator.hh>
+#include <dune/common/arraylist.hh>
+#include <dune/common/sllist.hh>
+
+using namespace Dune;
+
+// Count the calls to an upstream resource.
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+  int allocations = 0;
+  int deallocations = 0;
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override
+  {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+  {
+    ++deallocations;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+  {
+    return this == &other;
+  }
+};
+
+struct alignas(64) Aligned
+{
+  char c;
+};
+
+int testArena()
+{
+  int ret = 0;
+  CountingResource upstream;
+  {
+    Arena arena(256, &upstream);
+    ArenaAllocator<char> calloc(&arena);
+    ArenaAllocator<Aligned> aalloc(&arena);
+    ArenaAllocator<double> dalloc(&arena);
+
+    for(int i = 0; i < 100; ++i) {
+      calloc.allocate(3);
+      if(reinterpret_cast<std::uintptr_t>(aalloc.allocate(1)) % 64 != 0) {
+        std::cerr<<"Memory is not aligned! "<<__FILE__<<":"<<__LINE__<<std::endl;
+        ++ret;
+      }
+      double* d = dalloc.allocate(2);
+      if(reinterpret_cast<std::uintptr_t>(d) % alignof(double) != 0) {
+        std::cerr<<"Memory is not aligned! "<<__FILE__<<":"<<__LINE__<<std::endl;
+        ++ret;
+      }
+      dalloc.deallocate(d, 2);
+    }
+    // a request larger than a block
+    char* large = calloc.allocate(100000);
+    large[99999] = 1;
+
+    if(arena.used() != 100*(3+sizeof(Aligned)+2*sizeof(double)) + 100000) {
+      std::cerr<<"Wrong number of used bytes "<<arena.used()<<"! "<<__FILE__<<":"<<__LINE__<<std::endl;
+      ++ret;
+    }
+    if(upstream.deallocations != 0) {
+      std::cerr<<"Arena returned memory before release()! "<<__FILE__<<":"<<__LINE__<<std::endl;
+      ++ret;
+    }
+    int blocks = upstream.allocations;
+    arena.release();
+    if(upstream.deallocations != blocks || arena.used() != 0) {
+      std::cerr<<"release() did not return all blocks! "<<__FILE__<<":"<<__LINE__<<std::endl;
+      ++ret;
+    }
+
+    // after release() one block suffices for the same allocations
+    for(int i = 0; i < 100; ++i) {
+      calloc.allocate(3);
+      aalloc.allocate(1);
+      dalloc.allocate(2);
+    }
+    calloc.allocate(100000);
+    if(upstream.allocations != blocks + 1) {
+      std::cerr<<"Arena did not reuse the size of the released blocks! "<<__FILE__<<":"<<__LINE__<<std::endl;
+      ++ret;
+    }
+  }
+  if(upstream.allocations != upstream.deallocations) {
+    std::cerr<<"Destructor did not return all blocks! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ++ret;
+  }
+  return ret;
+}
+
+int testScope()
+{
+  int ret = 0;
+  Arena arena, inner;
+
+  if(ArenaAllocator<int>().resource() != std::pmr::get_default_resource()) {
+    std::cerr<<"Allocator does not use the default resource without scope! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ++ret;
+  }
+  {
+    ArenaScope scope(arena);
+    ArenaAllocator<int> a;
+    {
+      ArenaScope innerScope(inner);
+      if(ArenaAllocator<double>().resource() != &inner) {
+        std::cerr<<"Allocator does not use the resource of the inner scope! "<<__FILE__<<":"<<__LINE__<<std::endl;
+        ++ret;
+      }
+    }
+    ArenaAllocator<double> b;
+    if(a.resource() != &arena || a != b || a == ArenaAllocator<int>(&inner)) {
+      std::cerr<<"Allocator does not use the resource of the scope! "<<__FILE__<<":"<<__LINE__<<std::endl;
+      ++ret;
+    }
+  }
+  if(ArenaAllocator<int>().resource() != std::pmr::get_default_resource()) {
+    std::cerr<<"Scope did not restore the default resource! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ++ret;
+  }
+  return ret;
+}
+
+// Fill the containers of dune-common and the standard library from an arena.
+template<class Resource>
+int testContainers(Resource& resource)
+{
+  int ret = 0;
+  ArenaScope scope(resource);
+
+  SLList<int, ArenaAllocator<int> > slist;
+  ArrayList<int, 8, ArenaAllocator<int> > alist;
+  std::vector<int, ArenaAllocator<int> > vector;
+  std::list<int, ArenaAllocator<int> > list;
+  std::map<int, double, std::less<int>, ArenaAllocator<std::pair<const int,double> > > map;
+  std::pmr::vector<int> pmrVector(ArenaAllocator<int>{});
+
+  for(int i = 0; i < 1000; ++i) {
+    slist.push_back(i);
+    alist.push_back(i);
+    vector.push_back(i);
+    list.push_back(i);
+    map[i] = i;
+    pmrVector.push_back(i);
+  }
+
+  int i = 0;
+  auto aiter = alist.begin();
+  auto viter = vector.begin();
+  auto liter = list.begin();
+  auto miter = map.begin();
+  auto piter = pmrVector.begin();
+  for(auto iter = slist.begin(); iter != slist.end(); ++iter, ++aiter, ++viter, ++liter, ++miter, ++piter, ++i)
+    if(*iter != i || *aiter != i || *viter != i || *liter != i || miter->second != i || *piter != i) {
+      std::cerr<<"Containers hold wrong value at "<<i<<"! "<<__FILE__<<":"<<__LINE__<<std::endl;
+      ++ret;
+    }
+  if(i != 1000) {
+    std::cerr<<"Containers hold wrong number of values! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ++ret;
+  }
+  if(pmrVector.get_allocator().resource() != &resource) {
+    std::cerr<<"Conversion to polymorphic_allocator lost the resource! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ++ret;
+  }
+  return ret;
+}
+
+int main()
+{
+  int ret = 0;
+
+  ret += testArena();
+  ret += testScope();
+
+  Arena arena;
+  ret += testContainers(arena);
+  if(arena.used() == 0) {
+    std::cerr<<"Containers did not allocate from the arena! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ++ret;
+  }
+  arena.release();
+
+  // wrap resources of the standard library
+  std::pmr::unsynchronized_pool_resource pool;
+  ret += testContainers(pool);
+  std::pmr::monotonic_buffer_resource monotonic;
+  ret += testContainers(monotonic);
+
+  return ret;
+}
@@ -2,7 +2,17 @@
 // vi: set et ts=4 sw=2 sts=2:
 // SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
 // SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <numeric>
+#include <utility>
+#include <vector>
+
 #include <dune/common/bitsetvector.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/rangeutilities.hh>
 
 #if defined(__GNUC__) && ! defined(__clang__)
 #include <ext/malloc_allocator.h>
@@ -180,11 +190,160 @@ void doTest() {
 #endif
 }
 
+// Compare the word-wise operations with a bit by bit reference
+template<int block_size>
+int testWordOperations(int blocks)
+{
+  typedef Dune::BitSetVector<block_size> BBF;
+  int ret = 0;
+  auto check = [&](bool ok, int line){
+    if(!ok) {
+      std::cerr<<"Check failed for block size "<<block_size<<"! "<<__FILE__<<":"<<line<<std::endl;
+      ++ret;
+    }
+  };
+
+  std::srand(block_size);
+  std::vector<bool> a(blocks*block_size), b(blocks*block_size);
+  for(std::size_t i=0; i<a.size(); ++i) {
+    a[i] = std::rand() % 3 == 0;
+    b[i] = std::rand() % 2 == 0;
+  }
+  BBF x(a), y(b);
+
+  // count and block access
+  std::size_t count = std::count(a.begin(), a.end(), true);
+  check(x.count() == count, __LINE__);
+  std::size_t blockCount = 0;
+  for(int i=0; i<blocks; ++i) {
+    typename BBF::value_type bits = x[i];
+    for(int j=0; j<block_size; ++j)
+      check(bits[j] == a[i*block_size+j] && x[i][j] == a[i*block_size+j], __LINE__);
+    check(x[i].count() == bits.count() && x[i].any() == bits.any() && x[i].all() == bits.all(), __LINE__);
+    blockCount += x[i].count();
+  }
+  check(blockCount == count, __LINE__);
+
+  // set bits
+  std::size_t visited = 0;
+  x.forEachSetBit([&](std::size_t i, std::size_t j){
+      check(a[i*block_size+j], __LINE__);
+      ++visited;
+    });
+  check(visited == count, __LINE__);
+
+  // logical operations
+  BBF z = x;
+  z &= y;
+  for(int i=0; i<blocks; ++i)
+    for(int j=0; j<block_size; ++j)
+      check(z[i][j] == (a[i*block_size+j] && b[i*block_size+j]), __LINE__);
+  z = x;
+  z |= y;
+  for(int i=0; i<blocks; ++i)
+    for(int j=0; j<block_size; ++j)
+      check(z[i][j] == (a[i*block_size+j] || b[i*block_size+j]), __LINE__);
+  z ^= z;
+  check(z.none() && z.count() == 0, __LINE__);
+
+  // block assignment
+  z[blocks/2] = x[blocks/2];
+  check(z[blocks/2] == x[blocks/2] && z.count() == x[blocks/2].count(), __LINE__);
+  z[blocks/2].flip();
+  check(z.count() == block_size - x[blocks/2].count(), __LINE__);
+  z[blocks/2] = true;
+  check(z[blocks/2].all() && z.count() == block_size, __LINE__);
+
+  // resize keeps the unused bits of the last word cleared
+  z.setAll();
+  check(z.all() && z.count() == std::size_t(blocks*block_size), __LINE__);
+  z.resize(blocks - 1);
+  check(z.all() && z.count() == std::size_t((blocks-1)*block_size), __LINE__);
+  z.resize(blocks + 1);
+  check(!z.all() && z.count() == std::size_t((blocks-1)*block_size), __LINE__);
+  z.resize(blocks + 3, true);
+  check(z.count() == std::size_t((blocks+1)*block_size) && z[blocks+2].all() && z[blocks-1].none(), __LINE__);
+  z.unsetAll();
+  check(z.none(), __LINE__);
+
+  return ret;
+}
+
+// Iterate over the set blocks and gather/scatter masked entries
+int testSparse()
+{
+  int ret = 0;
+  auto check = [&](bool ok, int line){
+    if(!ok) {
+      std::cerr<<"Check failed! "<<__FILE__<<":"<<line<<std::endl;
+      ++ret;
+    }
+  };
+
+  typedef Dune::BitSetVector<3> BBF;
+  const int blocks = 1000;
+  BBF mask(blocks);
+  std::vector<int> setBlocks = {0, 21, 22, 500, 999};
+  for(int i : setBlocks)
+    mask[i][i%3] = true;
+  mask[22][0] = true;
+
+  // set blocks with their indices
+  std::size_t k = 0;
+  for(auto&& [block, i] : Dune::sparseRange(std::as_const(mask).setBlocks())) {
+    check(k < setBlocks.size() && i == std::size_t(setBlocks[k]) && block.any(), __LINE__);
+    ++k;
+  }
+  check(k == setBlocks.size(), __LINE__);
+  for(auto&& block : mask.setBlocks())
+    block.reset();
+  check(mask.none() && mask.setBlocks().begin() == mask.setBlocks().end(), __LINE__);
+  BBF empty;
+  check(empty.setBlocks().begin() == empty.setBlocks().end(), __LINE__);
+
+  for(int i : setBlocks)
+    mask[i][i%3] = true;
+  mask[22][0] = true;
+
+  // blocked vector
+  std::vector<Dune::FieldVector<double,3> > x(blocks);
+  for(int i=0; i<blocks; ++i)
+    for(int j=0; j<3; ++j)
+      x[i][j] = 3*i + j;
+  std::vector<double> values;
+  mask.gather(x, std::back_inserter(values));
+  check(values == std::vector<double>({0, 3*21, 3*22, 3*22+1, 3*500+2, 3*999}), __LINE__);
+
+  for(auto& v : values)
+    v = -v;
+  auto end = mask.scatter(values.begin(), x);
+  check(end == values.end(), __LINE__);
+  for(int i=0; i<blocks; ++i)
+    for(int j=0; j<3; ++j)
+      check(x[i][j] == (mask[i][j] ? -1 : 1)*(3*i + j), __LINE__);
+
+  // flat vector
+  Dune::DynamicVector<double> y(3*blocks, 0.0);
+  mask.scatter(values.begin(), y);
+  std::vector<double> flat;
+  mask.gather(y, std::back_inserter(flat));
+  check(flat == values && y.one_norm() == -std::accumulate(values.begin(), values.end(), 0.0), __LINE__);
+
+  return ret;
+}
+
 int main()
 {
+  int ret = 0;
+  ret += testSparse();
+  ret += testWordOperations<1>(200);
+  ret += testWordOperations<3>(100);
+  ret += testWordOperations<64>(10);
+  ret += testWordOperations<70>(10);
+
   doTest<4, std::allocator<bool> >();
 #if defined(__GNUC__) && ! defined(__clang__)
   doTest<4, __gnu_cxx::malloc_allocator<bool> >();
 #endif
-  return 0;
+  return ret;
 }
@@ -0,0 +1,173 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <map>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <dune/common/arraylist.hh>
+#include <dune/common/concurrentpoolallocator.hh>
+#include <dune/common/sllist.hh>
+
+using namespace Dune;
+
+// Allocate from several threads at once and check that no memory is
+// handed out twice. Each thread frees the memory allocated by its
+// neighbour to exercise the exchange of free elements between threads.
+template<class T>
+int testThreads(int numThreads, int count)
+{
+  typedef ConcurrentPoolAllocator<T,10> Allocator;
+  std::vector<std::vector<T*> > allocated(numThreads);
+  std::atomic<int> arrived(0);
+
+  auto allocate = [&](int thread){
+    Allocator alloc;
+    for(int i = 0; i < count; ++i) {
+      T* p = alloc.allocate(1);
+      *p = T(thread*count + i);
+      allocated[thread].push_back(p);
+    }
+    ++arrived;
+    while(arrived < numThreads)
+      std::this_thread::yield();
+    // free the memory of the next thread
+    for(T* p : allocated[(thread+1)%numThreads])
+      alloc.deallocate(p, 1);
+  };
+
+  int ret = 0;
+  for(int round = 0; round < 3; ++round) {
+    for(auto& a : allocated)
+      a.clear();
+    arrived = 0;
+
+    std::vector<std::thread> threads;
+    for(int t = 0; t < numThreads; ++t)
+      threads.emplace_back(allocate, t);
+    for(auto& t : threads)
+      t.join();
+
+    // all allocations were alive at the same time, so they have to differ
+    std::vector<std::uintptr_t> addresses;
+    for(int t = 0; t < numThreads; ++t)
+      for(T* p : allocated[t])
+        addresses.push_back(reinterpret_cast<std::uintptr_t>(p));
+    std::sort(addresses.begin(), addresses.end());
+    if(std::adjacent_find(addresses.begin(), addresses.end()) != addresses.end()) {
+      std::cerr<<"Memory was allocated twice! "<<__FILE__<<":"<<__LINE__<<std::endl;
+      ++ret;
+    }
+    if(addresses.size() != std::size_t(numThreads*count)) {
+      std::cerr<<"Wrong number of allocations! "<<__FILE__<<":"<<__LINE__<<std::endl;
+      ++ret;
+    }
+  }
+  return ret;
+}
+
+// Check that values written by different threads do not overwrite each other.
+int testValues(int numThreads, int count)
+{
+  typedef ConcurrentPoolAllocator<long,16> Allocator;
+  std::atomic<int> errors(0);
+
+  auto work = [&](long thread){
+    Allocator alloc;
+    std::vector<long*> pointers;
+    for(int round = 0; round < 10; ++round) {
+      for(int i = 0; i < count; ++i) {
+        pointers.push_back(alloc.allocate(1));
+        *pointers.back() = thread*count + i;
+      }
+      for(int i = 0; i < count; ++i)
+        if(*pointers[i] != thread*count + i)
+          ++errors;
+      // free in a different order than allocated
+      for(int i = 0; i < count; i += 2)
+        alloc.deallocate(pointers[i], 1);
+      for(int i = 1; i < count; i += 2)
+        alloc.deallocate(pointers[i], 1);
+      pointers.clear();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for(int t = 0; t < numThreads; ++t)
+    threads.emplace_back(work, t);
+  for(auto& t : threads)
+    t.join();
+
+  if(errors) {
+    std::cerr<<errors<<" values were overwritten by another thread! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+// Use the allocator with the containers of dune-common and the standard library.
+int testContainers()
+{
+  int ret = 0;
+
+  SLList<int, ConcurrentPoolAllocator<int,100> > slist;
+  ArrayList<int, 8, ConcurrentPoolAllocator<int,100> > alist;
+  std::vector<int, ConcurrentPoolAllocator<int,100> > vector;
+  std::list<int, ConcurrentPoolAllocator<int,100> > list;
+  std::set<int, std::less<int>, ConcurrentPoolAllocator<int,100> > set;
+  std::map<int, double, std::less<int>, ConcurrentPoolAllocator<std::pair<const int,double>,100> > map;
+
+  for(int i = 0; i < 1000; ++i) {
+    slist.push_back(i);
+    alist.push_back(i);
+    vector.push_back(i);
+    list.push_back(i);
+    set.insert(i);
+    map[i] = i;
+  }
+
+  int i = 0;
+  auto aiter = alist.begin();
+  auto viter = vector.begin();
+  auto liter = list.begin();
+  auto siter = set.begin();
+  auto miter = map.begin();
+  for(auto iter = slist.begin(); iter != slist.end(); ++iter, ++aiter, ++viter, ++liter, ++siter, ++miter, ++i)
+    if(*iter != i || *aiter != i || *viter != i || *liter != i || *siter != i || miter->second != i) {
+      std::cerr<<"Containers hold wrong value at "<<i<<"! "<<__FILE__<<":"<<__LINE__<<std::endl;
+      ++ret;
+    }
+  if(i != 1000) {
+    std::cerr<<"Containers hold wrong number of values! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ++ret;
+  }
+
+  // containers may be moved between threads
+  std::thread([&](){ slist.clear(); list.clear(); set.clear(); }).join();
+  if(!slist.empty() || !list.empty() || !set.empty()) {
+    std::cerr<<"Containers not empty after clear! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ++ret;
+  }
+  return ret;
+}
+
+int main()
+{
+  int ret = 0;
+  const int numThreads = 4;
+
+  ret += testThreads<double>(numThreads, 1000);
+  ret += testThreads<char>(numThreads, 1000);
+  ret += testThreads<std::uint64_t>(1, 10);
+  ret += testValues(numThreads, 500);
+  ret += testContainers();
+
+  return ret;
+}
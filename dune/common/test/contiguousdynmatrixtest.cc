@@ -0,0 +1,198 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <complex>
+#include <iostream>
+#include <limits>
+
+#include <dune/common/classname.hh>
+#include <dune/common/contiguousdynmatrix.hh>
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/test/testsuite.hh>
+
+using namespace Dune;
+
+template<class K>
+void fill(DynamicMatrix<K>& A)
+{
+  for (std::size_t i = 0; i < A.N(); ++i)
+    for (std::size_t j = 0; j < A.M(); ++j)
+      A[i][j] = K(1 + i*A.M() + j) / K(A.N()*A.M()) + (i == j ? K(A.N()) : K(0));
+}
+
+template<class K>
+void testMatrix(TestSuite& test, std::size_t n, std::size_t m)
+{
+  TestSuite t(className<K>() + " " + std::to_string(n) + "x" + std::to_string(m));
+  using std::abs;
+  using real_type = typename FieldTraits<K>::real_type;
+  const real_type tol = 1000*std::numeric_limits<real_type>::epsilon();
+
+  DynamicMatrix<K> R(n, m);
+  fill(R);
+  ContiguousDynamicMatrix<K> A = R;
+
+  t.check(A.N() == n && A.M() == m) << "size after assignment";
+  t.check(A == R) << "entries after assignment";
+  for (std::size_t i = 0; i < n; ++i)
+    t.check(A[i].data() == A.data() + i*m) << "row " << i << " is not contiguous";
+
+  // iterators
+  std::size_t rowCount = 0;
+  for (auto rit = A.begin(); rit != A.end(); ++rit, ++rowCount)
+  {
+    t.check(rit.index() == rowCount) << "row iterator index";
+    t.check(rit->size() == m) << "row size";
+    for (auto cit = rit->begin(); cit != rit->end(); ++cit)
+      t.check(*cit == R[rit.index()][cit.index()]) << "column iterator";
+  }
+  t.check(rowCount == n) << "number of rows visited";
+
+  const auto& cA = A;
+  typename ContiguousDynamicMatrix<K>::ConstRowIterator crit = A.begin();
+  t.check(crit == cA.begin()) << "mutable and const row iterators compare equal";
+
+  // copies have their own storage
+  auto B = A;
+  B[0][0] += K(1);
+  t.check(B.data() != A.data() && A == R) << "copy shares the storage";
+  auto C = std::move(B);
+  t.check(C[0][0] == R[0][0] + K(1) && C[n-1].data() == C.data() + (n-1)*m)
+    << "move construction";
+  B = C;
+  t.check(B == C && B[n-1].data() == B.data() + (n-1)*m) << "copy assignment";
+  auto& self = B;
+  B = std::move(self);
+  t.check(B == C && B.N() == n && B[n-1].data() == B.data() + (n-1)*m) << "self-move assignment";
+
+  // matrix vector products
+  DynamicVector<K> x(m), y(n), yr(n), z(m), zr(m);
+  for (std::size_t j = 0; j < m; ++j)
+    x[j] = K(j) - K(1);
+  for (std::size_t i = 0; i < n; ++i)
+    y[i] = K(i) + K(1);
+
+  A.mv(x, yr);
+  R.mv(x, y);
+  t.check((y - yr).infinity_norm() <= tol*(1 + y.infinity_norm())) << "mv";
+
+  A.umv(x, yr);
+  R.umv(x, y);
+  t.check((y - yr).infinity_norm() <= tol*(1 + y.infinity_norm())) << "umv";
+
+  A.mtv(y, zr);
+  R.mtv(y, z);
+  t.check((z - zr).infinity_norm() <= tol*(1 + z.infinity_norm())) << "mtv";
+
+  A.umtv(y, zr);
+  R.umtv(y, z);
+  t.check((z - zr).infinity_norm() <= tol*(1 + z.infinity_norm())) << "umtv";
+
+  A.mmv(x, yr);
+  R.mmv(x, y);
+  t.check((y - yr).infinity_norm() <= tol*(1 + y.infinity_norm())) << "mmv";
+
+  // transposed
+  auto AT = A.transposed();
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < m; ++j)
+      t.check(AT[j][i] == A[i][j]) << "transposed";
+
+  // row operations
+  {
+    using std::swap;
+    swap(A[0], A[n-1]);
+    for (std::size_t j = 0; j < m; ++j)
+      t.check(A[0][j] == R[n-1][j] && A[n-1][j] == R[0][j]) << "row swap";
+    swap(A[0], A[n-1]);
+  }
+  A[0] = A[n-1];
+  for (std::size_t j = 0; j < m; ++j)
+    t.check(A[0][j] == R[n-1][j]) << "row assignment copies the entries";
+  A[0] += R[0];
+  A[0] -= R[n-1];
+  for (std::size_t j = 0; j < m; ++j)
+    t.check(abs(A[0][j] - R[0][j]) <= tol) << "row arithmetic";
+
+  if (n == m)
+  {
+    t.check(abs(A.determinant() - R.determinant()) <= tol*abs(R.determinant()))
+      << "determinant";
+
+    DynamicVector<K> sa(n), sr(n);
+    A.solve(sa, y);
+    R.solve(sr, y);
+    t.check((sa - sr).infinity_norm() <= tol) << "solve";
+
+    auto Ai = A;
+    auto Ri = R;
+    Ai.invert();
+    Ri.invert();
+    t.check((ContiguousDynamicMatrix<K>(Ri) -= Ai).infinity_norm() <= tol) << "invert";
+
+    auto AR = A;
+    AR.rightmultiply(Ai);
+    for (std::size_t i = 0; i < n; ++i)
+      AR[i][i] -= K(1);
+    t.check(AR.infinity_norm() <= tol) << "rightmultiply with inverse";
+  }
+
+  test.subTest(t);
+}
+
+int main()
+{
+  TestSuite test;
+
+  for (std::size_t n : {1, 2, 3, 5, 17})
+  {
+    testMatrix<double>(test, n, n);
+    testMatrix<float>(test, n, n+2);
+    testMatrix<std::complex<double>>(test, n, n);
+  }
+
+  // resizing must not reallocate as long as the capacity suffices
+  {
+    ContiguousDynamicMatrix<double> A(10, 10, 1.0);
+    const double* data = A.data();
+    A.resize(5, 20, 2.0);
+    test.check(A.N() == 5 && A.M() == 20) << "size after resize";
+    test.check(A.data() == data) << "resize with sufficient capacity reallocated";
+    test.check(A[4][19] == 2.0) << "value after resize";
+    A.resize(3, 3);
+    test.check(A.data() == data) << "shrinking resize reallocated";
+    test.check(A.capacity() >= 100) << "capacity after shrinking";
+
+    A.reserve(400);
+    data = A.data();
+    A.resize(20, 20);
+    test.check(A.data() == data) << "resize after reserve reallocated";
+  }
+
+  // construction from an initializer list and conversion to other matrices
+  {
+    ContiguousDynamicMatrix<double> A = {{1, 2, 3}, {4, 5, 6}};
+    test.check(A.N() == 2 && A.M() == 3) << "initializer list size";
+    test.check(A[1][2] == 6) << "initializer list entries";
+
+    FieldMatrix<double,2,3> F = A;
+    test.check(F[1][0] == 4) << "conversion to FieldMatrix";
+
+    DynamicMatrix<double> D = A;
+    test.check(D == A) << "conversion to DynamicMatrix";
+
+    A = 7.0;
+    test.check(A[0][0] == 7.0 && A[1][2] == 7.0) << "scalar assignment";
+
+    const auto& cA = A;
+    DynamicVector<double> row = cA[1];
+    row = cA[1];
+    test.check(row.size() == 3 && row[0] == 7.0) << "copy of a const row";
+  }
+
+  return test.exit();
+}
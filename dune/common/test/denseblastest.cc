@@ -0,0 +1,139 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <complex>
+#include <limits>
+#include <string>
+
+#include <dune/common/classname.hh>
+#include <dune/common/contiguousdynmatrix.hh>
+#include <dune/common/denseblas.hh>
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/common/test/testsuite.hh>
+
+using namespace Dune;
+
+// a diagonally dominant, nonsymmetric matrix
+template<class Matrix>
+Matrix testMatrix(std::size_t n, std::size_t m)
+{
+  using K = typename Matrix::value_type;
+  Matrix A(n, m);
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < m; ++j)
+      A[i][j] = K(1 + (3*i + 7*j) % 11) / K(11*m) + (i == j ? K(2) : K(0));
+  return A;
+}
+
+// Compare the BLAS/LAPACK code paths (threshold 1) with the generic
+// implementations of DenseMatrix (threshold larger than the matrix).
+template<class Matrix>
+void testDispatch(TestSuite& test, std::size_t n, std::size_t m)
+{
+  using K = typename Matrix::value_type;
+  using real_type = typename FieldTraits<K>::real_type;
+  using std::abs;
+  const real_type tol = 1000*n*std::numeric_limits<real_type>::epsilon();
+  TestSuite t(className<Matrix>() + " " + std::to_string(n) + "x" + std::to_string(m));
+
+  const Matrix A = testMatrix<Matrix>(n, m);
+  DynamicVector<K> x(m), xt(n);
+  for (std::size_t j = 0; j < m; ++j)
+    x[j] = K(j) - K(2);
+  for (std::size_t i = 0; i < n; ++i)
+    xt[i] = K(1) / K(i+1);
+
+  auto run = [&](std::size_t threshold) {
+    DenseBlas::threshold() = threshold;
+    struct {
+      DynamicVector<K> y, yt, sol;
+      Matrix inverse, right, left;
+      K det;
+    } r;
+    r.y.resize(n, K(1));
+    A.umv(x, r.y);
+    r.yt.resize(m);
+    A.mtv(xt, r.yt);
+    A.umtv(xt, r.yt);
+    if (n == m)
+    {
+      r.sol.resize(n);
+      A.solve(r.sol, xt);
+      r.det = A.determinant();
+      r.inverse = A;
+      r.inverse.invert();
+      r.right = A;
+      r.right.rightmultiply(r.inverse);
+      r.left = A;
+      r.left.leftmultiply(A);
+    }
+    return r;
+  };
+
+  const auto generic = run(n + m);
+  const auto blas = run(1);
+
+  t.check((generic.y - blas.y).infinity_norm() <= tol*generic.y.infinity_norm()) << "umv";
+  t.check((generic.yt - blas.yt).infinity_norm() <= tol*generic.yt.infinity_norm()) << "mtv/umtv";
+  if (n == m)
+  {
+    t.check((generic.sol - blas.sol).infinity_norm() <= tol*generic.sol.infinity_norm()) << "solve";
+    t.check(abs(generic.det - blas.det) <= tol*abs(generic.det)) << "determinant";
+    Matrix diff = generic.inverse;
+    diff -= blas.inverse;
+    t.check(diff.infinity_norm() <= tol*generic.inverse.infinity_norm()) << "invert";
+    diff = blas.right;
+    for (std::size_t i = 0; i < n; ++i)
+      diff[i][i] -= K(1);
+    t.check(diff.infinity_norm() <= tol) << "rightmultiply with the inverse";
+    diff = generic.left;
+    diff -= blas.left;
+    t.check(diff.infinity_norm() <= tol*generic.left.infinity_norm()) << "leftmultiply";
+  }
+
+  // singular matrices
+  if (n == m)
+  {
+    DenseBlas::threshold() = 1;
+    Matrix S = A;
+    S[n-1] = K(0);
+    t.check(S.determinant() == K(0)) << "determinant of a singular matrix";
+    t.checkThrow<FMatrixError>([&]{ S.invert(); }) << "inverting a singular matrix";
+    DynamicVector<K> s(n);
+    t.checkThrow<FMatrixError>([&]{ S.solve(s, xt); }) << "solving with a singular matrix";
+  }
+
+  test.subTest(t);
+}
+
+int main()
+{
+  TestSuite test;
+
+  for (std::size_t n : {1, 2, 5, 40})
+  {
+    testDispatch<DynamicMatrix<double>>(test, n, n);
+    testDispatch<DynamicMatrix<float>>(test, n, n);
+    testDispatch<DynamicMatrix<std::complex<double>>>(test, n, n);
+    testDispatch<ContiguousDynamicMatrix<double>>(test, n, n);
+    testDispatch<ContiguousDynamicMatrix<std::complex<float>>>(test, n, n);
+    testDispatch<ContiguousDynamicMatrix<double>>(test, n, n+3);
+    testDispatch<ContiguousDynamicMatrix<float>>(test, n+3, n);
+  }
+
+  // non-BLAS field types always use the generic implementation
+  {
+    DenseBlas::threshold() = 1;
+    DynamicMatrix<long double> A = testMatrix<DynamicMatrix<long double>>(6, 6);
+    DynamicMatrix<long double> B = A;
+    B.invert();
+    A.rightmultiply(B);
+    for (std::size_t i = 0; i < 6; ++i)
+      A[i][i] -= 1;
+    test.check(A.infinity_norm() < 1e-12) << "long double inversion";
+  }
+
+  return test.exit();
+}
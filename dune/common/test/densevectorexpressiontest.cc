@@ -0,0 +1,109 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <complex>
+#include <type_traits>
+
+#include <dune/common/classname.hh>
+#include <dune/common/densevectorexpression.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/test/testsuite.hh>
+
+using namespace Dune;
+
+template<class Vector>
+Vector filled(std::size_t n, double offset)
+{
+  using K = typename Vector::value_type;
+  Vector v;
+  if constexpr (requires { v.resize(n); })
+    v.resize(n);
+  for (std::size_t i = 0; i < v.size(); ++i)
+    v[i] = K(offset + 0.5*i);
+  return v;
+}
+
+template<class Vector>
+void testExpressions(TestSuite& test, std::size_t n)
+{
+  using K = typename Vector::value_type;
+  TestSuite t(className<Vector>());
+
+  const Vector b = filled<Vector>(n, 1), c = filled<Vector>(n, -2), d = filled<Vector>(n, 3);
+  const K alpha = K(2.5);
+
+  // reference results from the eager operators
+  Vector ref = b;
+  ref.axpy(alpha, c);
+  ref -= d;
+
+  Vector a = filled<Vector>(n, 0);
+  a = lazy(b) + alpha*lazy(c) - d;
+  t.check(a == ref) << "a = lazy(b) + alpha*lazy(c) - d";
+
+  a = b + lazy(c)*alpha - lazy(d);
+  t.check(a == ref) << "mixed operands, scalar from the right";
+
+  Vector e = lazy(b) + alpha*lazy(c) - lazy(d);
+  t.check(e == ref) << "construction from an expression";
+
+  a = -(lazy(d) - lazy(b)) + lazy(c)*alpha/K(2) + alpha/K(2)*lazy(c);
+  t.check(a == ref) << "negation and division";
+
+  // the target may appear as an operand
+  a = b;
+  a = lazy(a) + alpha*lazy(c) - lazy(d);
+  t.check(a == ref) << "aliasing target";
+
+  // compound assignment and axpy
+  a = b;
+  a += alpha*lazy(c);
+  a -= lazy(d);
+  t.check(a == ref) << "operator+= and operator-=";
+
+  a = b;
+  a.axpy(alpha, lazy(c) - lazy(d)/alpha);
+  Vector ref2 = b;
+  for (std::size_t i = 0; i < n; ++i)
+    ref2[i] += alpha*(c[i] - d[i]/alpha);
+  t.check(a == ref2) << "axpy with an expression";
+
+  // the element type of the expression follows the promotion of its operands
+  using Promoted = typename decltype(2.0*lazy(b))::value_type;
+  static_assert(std::is_same_v<Promoted, decltype(2.0 * K())>);
+
+  test.subTest(t);
+}
+
+int main()
+{
+  TestSuite test;
+
+  testExpressions<DynamicVector<double>>(test, 17);
+  testExpressions<DynamicVector<std::complex<double>>>(test, 5);
+  testExpressions<FieldVector<double,3>>(test, 3);
+  testExpressions<FieldVector<float,8>>(test, 8);
+
+  // expressions of different vector types
+  {
+    DynamicVector<double> a(3);
+    const FieldVector<double,3> f = {1, 2, 3};
+    const DynamicVector<double> g = {4, 5, 6};
+    a = lazy(f) + 2*lazy(g);
+    test.check(a == DynamicVector<double>{9, 12, 15}) << "FieldVector and DynamicVector operands";
+
+    FieldVector<double,3> h = lazy(g) - f;
+    test.check(h == FieldVector<double,3>{3, 3, 3}) << "FieldVector from a DynamicVector expression";
+  }
+
+  // the eager operators are not affected by including the expression header
+  {
+    const DynamicVector<double> x = {1, 2}, y = {3, 4};
+    static_assert(std::is_same_v<decltype(x + y), DynamicVector<double>>);
+    static_assert(std::is_same_v<decltype(2.0 * FieldVector<double,2>{}), FieldVector<double,2>>);
+  }
+
+  return test.exit();
+}
@@ -0,0 +1,211 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <string>
+
+#include <dune/common/classname.hh>
+#include <dune/common/contiguousdynmatrix.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/test/testsuite.hh>
+
+using namespace Dune;
+
+// reference results from sequential loops in long double
+template<class X, class Y>
+long double referenceDot(const X& x, const Y& y)
+{
+  long double result = 0;
+  for (std::size_t i = 0; i < x.size(); ++i)
+    result += (long double)(x[i]) * (long double)(y[i]);
+  return result;
+}
+
+template<class X>
+long double referenceMax(const X& x)
+{
+  long double result = 0;
+  for (std::size_t i = 0; i < x.size(); ++i)
+    result = std::max(result, std::abs((long double)(x[i])));
+  return result;
+}
+
+template<class K>
+bool near(K a, long double b, std::size_t n)
+{
+  const long double tol = 4 * (n+1) * std::numeric_limits<K>::epsilon() * (1 + std::abs(b));
+  return std::abs((long double)(a) - b) <= tol;
+}
+
+template<class Vector>
+void fill(Vector& x, Vector& y)
+{
+  using K = typename Vector::value_type;
+  for (std::size_t i = 0; i < x.size(); ++i)
+  {
+    x[i] = K(std::sin(0.7*i) * (1 + i%5));
+    y[i] = K(std::cos(1.3*i) - 0.25);
+  }
+}
+
+template<class Vector>
+void checkReductions(TestSuite& t, const Vector& x, const Vector& y)
+{
+  using K = typename Vector::value_type;
+  const std::size_t n = x.size();
+  const std::string size = " for size " + std::to_string(n);
+
+  t.check(near(x.dot(y), referenceDot(x, y), n)) << "dot" << size;
+  t.check(near(x*y, referenceDot(x, y), n)) << "operator*" << size;
+  t.check(near(x.two_norm2(), referenceDot(x, x), n)) << "two_norm2" << size;
+  t.check(near(x.two_norm(), std::sqrt(referenceDot(x, x)), n)) << "two_norm" << size;
+  t.check(x.infinity_norm() == K(referenceMax(x))) << "infinity_norm" << size;
+  t.check(x.infinity_norm_real() == K(referenceMax(x))) << "infinity_norm_real" << size;
+
+  long double oneNorm = 0;
+  for (std::size_t i = 0; i < n; ++i)
+    oneNorm += std::abs((long double)(x[i]));
+  t.check(near(x.one_norm(), oneNorm, n)) << "one_norm" << size;
+  t.check(near(x.one_norm_real(), oneNorm, n)) << "one_norm_real" << size;
+}
+
+template<class K>
+void testDynamicVector(TestSuite& test)
+{
+  TestSuite t(className<DynamicVector<K>>());
+
+  // all remainders of the lane blocking
+  for (std::size_t n = 0; n < 200; n += (n < 70 ? 1 : 37))
+  {
+    DynamicVector<K> x(n), y(n);
+    fill(x, y);
+    checkReductions(t, x, y);
+  }
+
+  // NaN entries anywhere in the vector yield NaN norms
+  for (std::size_t pos : {0, 5, 63, 64, 99})
+  {
+    DynamicVector<K> x(100, K(1));
+    x[pos] = std::numeric_limits<K>::quiet_NaN();
+    t.check(std::isnan(x.infinity_norm())) << "infinity_norm with NaN at " << pos;
+    t.check(std::isnan(x.infinity_norm_real())) << "infinity_norm_real with NaN at " << pos;
+    t.check(std::isnan(x.two_norm())) << "two_norm with NaN at " << pos;
+    t.check(std::isnan(x.dot(x))) << "dot with NaN at " << pos;
+
+    // as in the generic implementation, infinite entries yield NaN as well
+    x[pos] = std::numeric_limits<K>::infinity();
+    t.check(std::isnan(x.infinity_norm())) << "infinity_norm with inf at " << pos;
+    t.check(std::isnan(x.infinity_norm_real())) << "infinity_norm_real with inf at " << pos;
+  }
+
+  // and so does an overflow of the sum of the absolute values
+  for (std::size_t n : {3, 100})
+  {
+    DynamicVector<K> x(n, std::numeric_limits<K>::max() / 2);
+    t.check(std::isnan(x.infinity_norm())) << "infinity_norm with overflow, n=" << n;
+    x[n-1] = std::numeric_limits<K>::max() / (K(4) * K(n+1));
+    x[0] = -x[n-1];
+    for (std::size_t i = 1; i+1 < n; ++i)
+      x[i] = 1;
+    t.check(x.infinity_norm() == x[n-1]) << "infinity_norm without overflow, n=" << n;
+  }
+
+  test.subTest(t);
+}
+
+template<class K, int n>
+void testFieldVector(TestSuite& test)
+{
+  TestSuite t(className<FieldVector<K,n>>());
+  FieldVector<K,n> x, y;
+  fill(x, y);
+  checkReductions(t, x, y);
+  test.subTest(t);
+}
+
+int main()
+{
+  TestSuite test;
+
+  testDynamicVector<float>(test);
+  testDynamicVector<double>(test);
+  testDynamicVector<long double>(test);
+
+  testFieldVector<double,3>(test);
+  testFieldVector<double,67>(test);
+  testFieldVector<float,129>(test);
+
+  // rows of a ContiguousDynamicMatrix are contiguous as well
+  {
+    ContiguousDynamicMatrix<double> A(3, 45);
+    for (std::size_t i = 0; i < A.N(); ++i)
+      for (std::size_t j = 0; j < A.M(); ++j)
+        A[i][j] = std::sin(double(i+1)*j);
+    checkReductions(test, A[0], A[2]);
+  }
+
+  // vectors without contiguous floating-point storage use the generic loops
+  {
+    DynamicVector<std::complex<double>> x = {{1, 2}, {3, -1}};
+    test.check(x.dot(x) == std::complex<double>(15, 0)) << "complex dot";
+    test.check(x.two_norm2() == 15) << "complex two_norm2";
+
+    FieldVector<FieldVector<double,2>,2> b = {{1, 2}, {3, 4}};
+    test.check(b.two_norm2() == 30) << "blocked two_norm2";
+
+    DynamicVector<int> k = {3, -4};
+    test.check(k.dot(k) == 25 && k.infinity_norm() == 4) << "integer reductions";
+  }
+
+  // the kernels treat infinite entries as the generic loops, which also run in constant evaluation
+  {
+    constexpr FieldVector<double,3> g = {1, -3, 2};
+    static_assert(g.infinity_norm() == 3 && g.infinity_norm_real() == 3);
+
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    FieldVector<double,3> f = {1, -inf, 2};
+    test.check(std::isnan(f.infinity_norm()) && std::isnan(f.infinity_norm_real()))
+      << "FieldVector infinity_norm with inf";
+
+    DynamicVector<std::complex<double>> c = {{1, 0}, {-inf, 0}};
+    test.check(std::isnan(c.infinity_norm()) && std::isnan(c.infinity_norm_real()))
+      << "complex infinity_norm with inf";
+  }
+
+  // mixed element types are promoted as before
+  {
+    DynamicVector<float> x = {1, 2};
+    DynamicVector<double> y = {0.5, 0.25};
+    static_assert(std::is_same_v<decltype(x.dot(y)), double>);
+    test.check(x.dot(y) == 1.0) << "mixed dot";
+  }
+
+  // the results only depend on the entries, not on the vector type
+  {
+    FieldVector<double,50> f;
+    DynamicVector<double> d(50);
+    for (int i = 0; i < 50; ++i)
+      f[i] = d[i] = 1.0 / (i+1);
+    test.check(f.two_norm2() == d.two_norm2()) << "reproducible two_norm2";
+  }
+
+  // compensated summation keeps the error of long sums small
+  {
+    const std::size_t n = 1 << 20;
+    DynamicVector<float> x(n, 0.1f), ones(n, 1.0f);
+    const long double exact = (long double)(0.1f) * n;
+    const float error = std::abs((long double)(x.dot(ones)) - exact) / exact;
+#if DUNE_DENSEVECTOR_COMPENSATED_SUMMATION
+    test.check(error <= 2*std::numeric_limits<float>::epsilon())
+      << "compensated dot has relative error " << error;
+#else
+    test.check(error <= 1e-3) << "dot has relative error " << error;
+#endif
+  }
+
+  return test.exit();
+}
@@ -0,0 +1,211 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <algorithm>
+#include <complex>
+#include <limits>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <dune/common/classname.hh>
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynmatrixev.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/common/test/testsuite.hh>
+
+using namespace Dune;
+
+template<class K>
+DynamicMatrix<K> randomMatrix(std::size_t n, bool symmetric, std::mt19937& gen)
+{
+  std::uniform_real_distribution<K> dist(-1, 1);
+  DynamicMatrix<K> A(n, n);
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < n; ++j)
+      A[i][j] = dist(gen);
+  if (symmetric)
+    for (std::size_t i = 0; i < n; ++i)
+      for (std::size_t j = 0; j < i; ++j)
+        A[j][i] = A[i][j];
+  return A;
+}
+
+template<class K>
+K tolerance(std::size_t n)
+{
+  return 1000*n*std::numeric_limits<K>::epsilon();
+}
+
+template<class K>
+void testSymmetric(TestSuite& test, std::size_t n)
+{
+  TestSuite t("SymmetricEigenSolver<" + className<K>() + "> n=" + std::to_string(n));
+  std::mt19937 gen(n);
+  const K tol = tolerance<K>(n);
+
+  DynamicMatrixHelp::SymmetricEigenSolver<K> solver(n);
+  t.check(solver.size() == n) << "size";
+
+  DynamicVector<K> ev, evSubset;
+  std::vector<DynamicVector<K>> vecs, vecsSubset;
+  for (int r = 0; r < 3; ++r)
+  {
+    const auto A = randomMatrix<K>(n, true, gen);
+    solver.compute(A, ev, &vecs);
+    t.require(ev.size() == n && vecs.size() == n) << "number of eigenpairs";
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      DynamicVector<K> Av(n);
+      A.mv(vecs[i], Av);
+      Av.axpy(-ev[i], vecs[i]);
+      t.check(Av.infinity_norm() <= tol) << "residual of eigenpair " << i;
+      t.check(std::abs(vecs[i].two_norm() - K(1)) <= tol) << "normalization of eigenvector " << i;
+      if (i > 0)
+        t.check(ev[i-1] <= ev[i]) << "ascending order";
+    }
+
+    // eigenvalues only
+    DynamicVector<K> ev2;
+    solver.compute(A, ev2);
+    t.check((ev - ev2).infinity_norm() <= tol) << "eigenvalues with and without eigenvectors";
+
+    // index range
+    const std::size_t first = n/4, last = n/2 + 1;
+    solver.computeIndexRange(A, first, last, evSubset, &vecsSubset);
+    t.require(evSubset.size() == last - first && vecsSubset.size() == last - first)
+      << "size of the index range";
+    for (std::size_t i = first; i < last; ++i)
+    {
+      t.check(std::abs(evSubset[i-first] - ev[i]) <= tol) << "eigenvalue " << i << " of the index range";
+      DynamicVector<K> Av(n);
+      A.mv(vecsSubset[i-first], Av);
+      Av.axpy(-evSubset[i-first], vecsSubset[i-first]);
+      t.check(Av.infinity_norm() <= tol) << "residual of eigenpair " << i << " of the index range";
+    }
+
+    // value range, the bounds lie halfway between neighbouring eigenvalues
+    const K lower = (ev[first-1] + ev[first]) / 2;
+    const K upper = (ev[last-1] + ev[last]) / 2;
+    solver.computeValueRange(A, lower, upper, evSubset);
+    t.require(evSubset.size() == last - first) << "size of the value range";
+    for (std::size_t i = first; i < last; ++i)
+      t.check(std::abs(evSubset[i-first] - ev[i]) <= tol) << "eigenvalue " << i << " of the value range";
+  }
+
+  // repeated calls with the same size reuse the output storage
+  {
+    const auto A = randomMatrix<K>(n, true, gen);
+    solver.compute(A, ev, &vecs);
+    const K* evData = &ev[0];
+    const K* vecData = &vecs[0][0];
+    solver.compute(A, ev, &vecs);
+    t.check(evData == &ev[0] && vecData == &vecs[0][0]) << "output storage was reallocated";
+  }
+
+  // the workspace adapts to other matrix sizes
+  {
+    const auto A = randomMatrix<K>(n+3, true, gen);
+    solver.compute(A, ev);
+    t.check(solver.size() == n+3 && ev.size() == n+3) << "resizing the workspace";
+  }
+
+  // only the lower triangle is referenced, garbage above the diagonal is ignored
+  {
+    const auto A = randomMatrix<K>(n, true, gen);
+    auto B = A;
+    for (std::size_t i = 0; i < n; ++i)
+      for (std::size_t j = i+1; j < n; ++j)
+        B[i][j] = K(10) + K(i) - K(j);
+    DynamicVector<K> evB;
+    solver.compute(A, ev);
+    solver.compute(B, evB);
+    t.check((ev - evB).infinity_norm() <= tol) << "entries above the diagonal were referenced";
+  }
+
+  t.checkThrow<RangeError>([&]{ solver.computeIndexRange(randomMatrix<K>(n, true, gen), 2, n+1, ev); })
+    << "index range exceeding the matrix size";
+  t.checkThrow<RangeError>([&]{ solver.computeValueRange(randomMatrix<K>(n, true, gen), K(1), K(0), ev); })
+    << "empty value range";
+
+  test.subTest(t);
+}
+
+template<class K>
+void testNonSymmetric(TestSuite& test, std::size_t n)
+{
+  using Complex = std::complex<K>;
+  TestSuite t("NonSymmetricEigenSolver<" + className<K>() + "> n=" + std::to_string(n));
+  std::mt19937 gen(n);
+  const K tol = tolerance<K>(n);
+
+  DynamicMatrixHelp::NonSymmetricEigenSolver<K> solver;
+  DynamicVector<Complex> ev, ev2;
+  std::vector<DynamicVector<K>> vecs;
+  for (int r = 0; r < 3; ++r)
+  {
+    const auto A = randomMatrix<K>(n, false, gen);
+    solver.compute(A, ev, &vecs);
+    t.require(ev.size() == n && vecs.size() == n) << "number of eigenpairs";
+
+    // A (x + iy) = lambda (x + iy), with y = 0 for real eigenvalues
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const bool pair = ev[i].imag() != K(0);
+      const DynamicVector<K>& x = vecs[i];
+      const DynamicVector<K> y = pair ? vecs[i+1] : DynamicVector<K>(n, K(0));
+      DynamicVector<K> Ax(n), Ay(n);
+      A.mv(x, Ax);
+      A.mv(y, Ay);
+      const K re = ev[i].real(), im = ev[i].imag();
+      K residual = 0;
+      for (std::size_t k = 0; k < n; ++k)
+        residual = std::max(residual, std::abs(Complex(Ax[k], Ay[k]) - Complex(re*x[k] - im*y[k], re*y[k] + im*x[k])));
+      t.check(residual <= tol) << "residual of eigenpair " << i;
+      if (pair)
+      {
+        t.check(std::abs(ev[i+1] - std::conj(ev[i])) <= tol) << "conjugate pair " << i;
+        ++i;
+      }
+    }
+
+    solver.compute(A, ev2);
+    t.check((ev - ev2).infinity_norm() <= tol) << "eigenvalues with and without eigenvectors";
+
+    if constexpr (std::is_same_v<K, double>)
+    {
+      // eigenValuesNonSym works on the transposed matrix, so the order may differ
+      DynamicVector<Complex> evReference;
+      DynamicMatrixHelp::eigenValuesNonSym(A, evReference);
+      auto byValue = [](const Complex& a, const Complex& b) {
+        return a.real() < b.real() || (a.real() == b.real() && a.imag() < b.imag());
+      };
+      std::vector<Complex> sorted(ev.begin(), ev.end()), sortedReference(evReference.begin(), evReference.end());
+      std::sort(sorted.begin(), sorted.end(), byValue);
+      std::sort(sortedReference.begin(), sortedReference.end(), byValue);
+      K diff = 0;
+      for (std::size_t i = 0; i < n; ++i)
+        diff = std::max(diff, std::abs(sorted[i] - sortedReference[i]));
+      t.check(diff <= tol) << "comparison with eigenValuesNonSym";
+    }
+  }
+
+  test.subTest(t);
+}
+
+int main()
+{
+  TestSuite test;
+
+  for (std::size_t n : {4, 17, 60})
+  {
+    testSymmetric<double>(test, n);
+    testSymmetric<float>(test, n);
+    testNonSymmetric<double>(test, n);
+    testNonSymmetric<float>(test, n);
+  }
+
+  return test.exit();
+}
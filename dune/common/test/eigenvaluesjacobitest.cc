@@ -0,0 +1,160 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <dune-common-config.hh> // HAVE_LAPACK
+
+#include <dune/common/classname.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fmatrixbatch.hh>
+#include <dune/common/fmatrixev.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/simd/loop.hh>
+#include <dune/common/test/testsuite.hh>
+
+using namespace Dune;
+
+template<class K, int dim>
+FieldMatrix<K,dim,dim> randomSymmetricMatrix(std::mt19937& gen)
+{
+  std::uniform_real_distribution<K> dist(-1, 1);
+  FieldMatrix<K,dim,dim> A;
+  for (int i = 0; i < dim; ++i)
+    for (int j = 0; j <= i; ++j)
+      A[i][j] = A[j][i] = dist(gen);
+  return A;
+}
+
+// check A v_i = lambda_i v_i, orthonormality and ascending order
+template<class K, int dim>
+void checkEigenPairs(TestSuite& t, const FieldMatrix<K,dim,dim>& A,
+                     const FieldVector<K,dim>& ev, const FieldMatrix<K,dim,dim>& V)
+{
+  using std::abs;
+  const K tol = 100*dim*std::numeric_limits<K>::epsilon()*(1 + A.infinity_norm());
+  for (int i = 0; i < dim; ++i)
+  {
+    FieldVector<K,dim> Av;
+    A.mv(V[i], Av);
+    t.check((Av - ev[i]*V[i]).infinity_norm() <= tol)
+      << "eigenpair " << i << " residual " << (Av - ev[i]*V[i]).infinity_norm();
+    for (int j = 0; j < dim; ++j)
+      t.check(abs(V[i]*V[j] - K(i == j ? 1 : 0)) <= tol) << "orthonormality " << i << "," << j;
+    if (i > 0)
+      t.check(ev[i-1] <= ev[i]) << "ascending order";
+  }
+}
+
+template<class K, int dim>
+void testScalar(TestSuite& test)
+{
+  TestSuite t(className<K>() + " dim=" + std::to_string(dim));
+  std::mt19937 gen(dim);
+  for (int r = 0; r < 10; ++r)
+  {
+    const auto A = randomSymmetricMatrix<K,dim>(gen);
+    FieldVector<K,dim> ev, ev2;
+    FieldMatrix<K,dim,dim> V;
+    FMatrixHelp::eigenValuesVectorsJacobi(A, ev, V);
+    checkEigenPairs(t, A, ev, V);
+
+    FMatrixHelp::eigenValuesJacobi(A, ev2);
+    t.check((ev - ev2).infinity_norm() <= 10*std::numeric_limits<K>::epsilon()*dim)
+      << "eigenvalues with and without eigenvectors differ";
+
+#if HAVE_LAPACK
+    FieldVector<K,dim> evLapack;
+    FMatrixHelp::eigenValuesLapack(A, evLapack);
+    t.check((ev - evLapack).infinity_norm() <= 100*std::numeric_limits<K>::epsilon()*dim)
+      << "eigenvalues differ from LAPACK";
+#endif
+  }
+
+  // diagonal matrix with repeated eigenvalues
+  FieldMatrix<K,dim,dim> D(0);
+  for (int i = 0; i < dim; ++i)
+    D[i][i] = K((dim - i) / 2);
+  FieldVector<K,dim> ev;
+  FieldMatrix<K,dim,dim> V;
+  FMatrixHelp::eigenValuesVectorsJacobi(D, ev, V);
+  checkEigenPairs(t, D, ev, V);
+
+  test.subTest(t);
+}
+
+// all lanes of a LoopSIMD matrix must give the scalar results
+template<int dim>
+void testSimd(TestSuite& test)
+{
+  TestSuite t("LoopSIMD<double,4> dim=" + std::to_string(dim));
+  using S = LoopSIMD<double,4>;
+  std::mt19937 gen(42);
+
+  std::vector<FieldMatrix<double,dim,dim>> matrices;
+  FieldMatrix<S,dim,dim> A;
+  for (std::size_t l = 0; l < 4; ++l)
+  {
+    matrices.push_back(randomSymmetricMatrix<double,dim>(gen));
+    // one lane is diagonal already, so it converges first
+    if (l == 2)
+      for (int i = 0; i < dim; ++i)
+        for (int j = 0; j < dim; ++j)
+          if (i != j)
+            matrices.back()[i][j] = 0;
+    for (int i = 0; i < dim; ++i)
+      for (int j = 0; j < dim; ++j)
+        Simd::lane(l, A[i][j]) = matrices.back()[i][j];
+  }
+
+  FieldVector<S,dim> ev;
+  FieldMatrix<S,dim,dim> V;
+  FMatrixHelp::eigenValuesVectors(A, ev, V);
+  for (std::size_t l = 0; l < 4; ++l)
+  {
+    FieldVector<double,dim> evl;
+    FieldMatrix<double,dim,dim> Vl;
+    for (int i = 0; i < dim; ++i)
+    {
+      evl[i] = Simd::lane(l, ev[i]);
+      for (int j = 0; j < dim; ++j)
+        Vl[i][j] = Simd::lane(l, V[i][j]);
+    }
+    checkEigenPairs(t, matrices[l], evl, Vl);
+  }
+
+  // batched interface
+  std::vector<FieldVector<double,dim>> evs(matrices.size()), evs2(matrices.size());
+  std::vector<FieldMatrix<double,dim,dim>> vecs(matrices.size());
+  batchEigenValuesVectors<4>(matrices, evs, vecs);
+  batchEigenValues(matrices, evs2);
+  for (std::size_t k = 0; k < matrices.size(); ++k)
+  {
+    checkEigenPairs(t, matrices[k], evs[k], vecs[k]);
+    t.check((evs[k] - evs2[k]).infinity_norm() <= 1e-12) << "batched eigenvalues";
+  }
+
+  test.subTest(t);
+}
+
+int main()
+{
+  TestSuite test;
+
+  testScalar<double,4>(test);
+  testScalar<double,6>(test);
+  testScalar<double,9>(test);
+  testScalar<double,12>(test);
+  testScalar<float,5>(test);
+  testScalar<float,8>(test);
+
+  testSimd<4>(test);
+  testSimd<7>(test);
+
+  return test.exit();
+}
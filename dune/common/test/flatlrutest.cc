@@ -0,0 +1,181 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/flatlru.hh>
+
+int check(bool ok, int line)
+{
+  if(!ok)
+    std::cerr<<"Check failed! "<<__FILE__<<":"<<line<<std::endl;
+  return !ok;
+}
+
+// the operations of lrutest
+int testInterface()
+{
+  int ret = 0;
+  Dune::FlatLRU<int, double> lru;
+  lru.insert(10, 1.0);
+  ret += check(lru.front() == lru.back(), __LINE__);
+  lru.insert(11, 2.0);
+  ret += check(lru.front() == 2.0 && lru.back() == 1.0, __LINE__);
+  lru.insert(12, 99);
+  lru.insert(13, 1.125);
+  lru.insert(14, 12345);
+  lru.insert(15, -17);
+  ret += check(lru.front() == -17 && lru.back() == 1.0, __LINE__);
+  // update
+  lru.insert(10);
+  ret += check(lru.front() == 1.0 && lru.back() == 2.0, __LINE__);
+  // update
+  lru.touch(13);
+  ret += check(lru.front() == 1.125 && lru.back() == 2.0, __LINE__);
+  // replace
+  lru.insert(12, 3.0);
+  ret += check(lru.front() == 3.0 && lru.size() == 6, __LINE__);
+  // remove item
+  lru.pop_front();
+  ret += check(lru.front() == 1.125 && lru.back() == 2.0, __LINE__);
+  // remove item
+  lru.pop_back();
+  ret += check(lru.front() == 1.125 && lru.back() == 12345, __LINE__);
+
+  // iterate from the most to the least recently used entry
+  std::vector<int> keys;
+  for(const auto& [key, data] : lru)
+    keys.push_back(key);
+  ret += check(keys == std::vector<int>({13, 10, 15, 14}), __LINE__);
+  auto it = lru.end();
+  --it;
+  ret += check(it->first == 14, __LINE__);
+
+  ret += check(lru.find(15)->second == -17 && lru.find(11) == lru.end(), __LINE__);
+  ret += check(lru.statistics().hits == 1 && lru.statistics().misses == 1, __LINE__);
+
+  try {
+    lru.touch(11);
+    ret += check(false, __LINE__);
+  } catch(const Dune::RangeError&) {}
+
+  lru.resize(2);
+  ret += check(lru.size() == 2 && lru.back() == 1.0, __LINE__);
+  lru.clear();
+  ret += check(lru.empty() && lru.begin() == lru.end(), __LINE__);
+  return ret;
+}
+
+// Compare random operations with a list ordered from the most to the least recent entry
+int testRandom(std::size_t capacity)
+{
+  int ret = 0;
+  Dune::FlatLRU<int, int> lru(capacity);
+  std::list<std::pair<int,int> > reference;
+  std::size_t evictions = 0;
+
+  std::srand(capacity);
+  for(int i = 0; i < 20000; ++i) {
+    // multiples of 64 collide in a badly mixed table
+    int key = 64*(std::rand() % 300);
+    auto ref = std::find_if(reference.begin(), reference.end(), [&](auto& e){ return e.first == key; });
+    switch(std::rand() % 4) {
+    case 0 :
+    case 1 : {
+      lru.insert(key, i);
+      if(ref != reference.end())
+        reference.erase(ref);
+      else if(capacity > 0 && reference.size() == capacity) {
+        reference.pop_back();
+        ++evictions;
+      }
+      reference.emplace_front(key, i);
+      break;
+    }
+    case 2 : {
+      auto it = lru.find(key);
+      if(ref == reference.end())
+        ret += check(it == lru.end(), __LINE__);
+      else {
+        ret += check(it != lru.end() && it->second == ref->second, __LINE__);
+        lru.touch(key);
+        reference.splice(reference.begin(), reference, ref);
+      }
+      break;
+    }
+    default :
+      if(ref != reference.end() && ref == reference.begin()) {
+        lru.pop_front();
+        reference.pop_front();
+      }
+      else if(!reference.empty() && std::rand() % 2) {
+        lru.pop_back();
+        reference.pop_back();
+      }
+    }
+    if(lru.size() != reference.size()) {
+      std::cerr<<"Sizes differ! "<<__FILE__<<":"<<__LINE__<<std::endl;
+      return ret + 1;
+    }
+  }
+  ret += check(std::equal(lru.begin(), lru.end(), reference.begin(), reference.end()), __LINE__);
+  ret += check(lru.statistics().evictions == evictions, __LINE__);
+  return ret;
+}
+
+int testConcurrent()
+{
+  int ret = 0;
+  const int numThreads = 4;
+  const int keys = 1000;
+  Dune::ConcurrentFlatLRU<int, long> cache(500, 8);
+  std::atomic<int> errors(0), computed(0);
+
+  std::vector<std::thread> threads;
+  for(int t = 0; t < numThreads; ++t)
+    threads.emplace_back([&, t](){
+        for(int i = 0; i < 20000; ++i) {
+          int key = (i*7 + t*13) % keys;
+          long value = cache.findOrInsert(key, [&](){ ++computed; return 3L*key; });
+          if(value != 3L*key)
+            ++errors;
+        }
+      });
+  for(auto& t : threads)
+    t.join();
+
+  ret += check(errors == 0, __LINE__);
+  ret += check(cache.size() <= 500 + 8, __LINE__);
+  Dune::LRUStatistics statistics = cache.statistics();
+  ret += check(statistics.hits + statistics.misses == numThreads*20000, __LINE__);
+  ret += check(statistics.misses == std::size_t(computed), __LINE__);
+  ret += check(statistics.evictions > 0, __LINE__);
+
+  cache.insert(-1, 5);
+  ret += check(cache.find(-1) == 5L && !cache.find(-2), __LINE__);
+  cache.clear();
+  cache.resetStatistics();
+  ret += check(cache.size() == 0 && cache.statistics().hits == 0, __LINE__);
+  return ret;
+}
+
+int main()
+{
+  int ret = 0;
+
+  ret += testInterface();
+  ret += testRandom(0);
+  ret += testRandom(100);
+  ret += testConcurrent();
+
+  return ret;
+}
@@ -0,0 +1,145 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <dune/common/classname.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fmatrixbatch.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/std/mdspan.hh>
+#include <dune/common/test/testsuite.hh>
+
+// diagonally dominant random matrices, so that all of them are regular
+template<class K, int n>
+std::vector<Dune::FieldMatrix<K,n,n>> randomMatrices(std::size_t count)
+{
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<K> dist(-1, 1);
+  std::vector<Dune::FieldMatrix<K,n,n>> matrices(count);
+  for (auto& A : matrices)
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < n; ++j)
+        A[i][j] = dist(gen) + (i == j ? K(n) : K(0));
+  return matrices;
+}
+
+template<class K, int n, std::size_t lanes>
+void testBatch(Dune::TestSuite& test, std::size_t count)
+{
+  using std::abs;
+  const K tol = 1e-10;
+  Dune::TestSuite t(Dune::className<K>() + ", n=" + std::to_string(n)
+                    + ", lanes=" + std::to_string(lanes)
+                    + ", count=" + std::to_string(count));
+
+  auto matrices = randomMatrices<K,n>(count);
+  std::vector<Dune::FieldVector<K,n>> b(count), x(count);
+  for (std::size_t k = 0; k < count; ++k)
+    for (int i = 0; i < n; ++i)
+      b[k][i] = K(k+i);
+
+  // determinant
+  std::vector<K> det(count);
+  Dune::batchDeterminant<lanes>(matrices, det);
+  for (std::size_t k = 0; k < count; ++k)
+    t.check(abs(det[k] - matrices[k].determinant()) <= tol*abs(det[k]))
+      << "determinant of matrix " << k;
+
+  // solve
+  Dune::batchSolve<lanes>(matrices, x, b);
+  for (std::size_t k = 0; k < count; ++k)
+  {
+    Dune::FieldVector<K,n> xk;
+    matrices[k].solve(xk, b[k]);
+    t.check((x[k] - xk).infinity_norm() <= tol*(1 + xk.infinity_norm()))
+      << "solution of system " << k;
+  }
+
+  // invert
+  auto inverses = matrices;
+  Dune::batchInvert<lanes>(inverses);
+  for (std::size_t k = 0; k < count; ++k)
+  {
+    auto inv = matrices[k];
+    inv.invert();
+    t.check((inverses[k] - inv).infinity_norm() <= tol*(1 + inv.infinity_norm()))
+      << "inverse of matrix " << k;
+  }
+
+  test.subTest(t);
+}
+
+template<std::size_t lanes>
+void testSizes(Dune::TestSuite& test)
+{
+  // counts below, equal to and above a multiple of the lane count
+  for (std::size_t count : {std::size_t(0), std::size_t(1), lanes, 3*lanes+1})
+  {
+    testBatch<double,1,lanes>(test, count);
+    testBatch<double,2,lanes>(test, count);
+    testBatch<double,3,lanes>(test, count);
+    testBatch<double,4,lanes>(test, count);
+    testBatch<double,7,lanes>(test, count);
+  }
+}
+
+int main()
+{
+  Dune::TestSuite test;
+
+  testSizes<1>(test);
+  testSizes<4>(test);
+  testSizes<0>(test);
+
+  // ranges given as rank-1 mdspan
+  {
+    auto matrices = randomMatrices<double,4>(10);
+    std::vector<double> det(matrices.size());
+    Dune::Std::mdspan<const Dune::FieldMatrix<double,4,4>, Dune::Std::dextents<std::size_t,1>>
+      mspan(matrices.data(), matrices.size());
+    Dune::Std::mdspan<double, Dune::Std::dextents<std::size_t,1>> dspan(det.data(), det.size());
+    Dune::batchDeterminant(mspan, dspan);
+    for (std::size_t k = 0; k < matrices.size(); ++k)
+      test.check(std::abs(det[k] - matrices[k].determinant()) <= 1e-10*std::abs(det[k]))
+        << "mdspan determinant of matrix " << k;
+  }
+
+  // singular matrices: determinant is zero, solve and invert throw
+  {
+    auto matrices = randomMatrices<double,5>(9);
+    matrices[6] = 0.0;
+    std::vector<double> det(matrices.size());
+    Dune::batchDeterminant<4>(matrices, det);
+    test.check(det[6] == 0.0) << "determinant of a singular matrix";
+    test.checkThrow<Dune::FMatrixError>([&]{ Dune::batchInvert<4>(matrices); })
+      << "inversion of a singular matrix";
+
+    std::vector<Dune::FieldVector<double,5>> x(matrices.size()), b(matrices.size());
+    test.checkThrow<Dune::FMatrixError>([&]{ Dune::batchSolve<4>(matrices, x, b); })
+      << "solving with a singular matrix";
+  }
+
+  // too small output ranges
+  {
+    auto matrices = randomMatrices<double,3>(5);
+    std::vector<double> det(3);
+    test.checkThrow<Dune::RangeError>([&]{ Dune::batchDeterminant(matrices, det); })
+      << "output range too small";
+  }
+
+  // single precision
+  {
+    auto matrices = randomMatrices<float,4>(20);
+    std::vector<float> det(matrices.size());
+    Dune::batchDeterminant(matrices, det);
+    for (std::size_t k = 0; k < matrices.size(); ++k)
+      test.check(std::abs(det[k] - matrices[k].determinant()) <= 1e-4f*std::abs(det[k]))
+        << "float determinant of matrix " << k;
+  }
+
+  return test.exit();
+}
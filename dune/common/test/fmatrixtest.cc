@@ -762,6 +762,64 @@ void test_invert ()
   A.invert();
 }
 
+// compare the (tiled) matrix-matrix products with a naive reference
+template< class K, int n, int k, int m >
+int test_tiled_product ()
+{
+  FieldMatrix< K, n, k > A;
+  FieldMatrix< K, k, m > B;
+  FieldMatrix< K, m, m > S;
+  FieldMatrix< K, n, n > T;
+  for( int i = 0; i < n; ++i )
+    for( int j = 0; j < k; ++j )
+      A[ i ][ j ] = K( (i*7 + j*3) % 11 ) - K( 5 );
+  for( int i = 0; i < k; ++i )
+    for( int j = 0; j < m; ++j )
+      B[ i ][ j ] = K( (i*5 + j*2) % 13 ) - K( 6 );
+  for( int i = 0; i < m; ++i )
+    for( int j = 0; j < m; ++j )
+      S[ i ][ j ] = K( (i + j) % 3 );
+  for( int i = 0; i < n; ++i )
+    for( int j = 0; j < n; ++j )
+      T[ i ][ j ] = K( (2*i + j) % 5 );
+
+  FieldMatrix< K, n, m > reference( 0 );
+  for( int i = 0; i < n; ++i )
+    for( int j = 0; j < m; ++j )
+      for( int l = 0; l < k; ++l )
+        reference[ i ][ j ] += A[ i ][ l ] * B[ l ][ j ];
+
+  int errors = 0;
+  // all entries are small integers, so the results have to be exact
+  if( A * B != reference )
+  {
+    std::cerr << "Error: tiled product " << n << "x" << k << " * " << k << "x" << m
+              << " of type " << className<K>() << " is wrong" << std::endl;
+    ++errors;
+  }
+
+  FieldMatrix< K, n, m > right = reference;
+  right.rightmultiply( S );
+  FieldMatrix< K, n, m > left = reference;
+  left.leftmultiply( T );
+  FieldMatrix< K, n, m > rightRef( 0 ), leftRef( 0 );
+  for( int i = 0; i < n; ++i )
+    for( int j = 0; j < m; ++j )
+    {
+      for( int l = 0; l < m; ++l )
+        rightRef[ i ][ j ] += reference[ i ][ l ] * S[ l ][ j ];
+      for( int l = 0; l < n; ++l )
+        leftRef[ i ][ j ] += T[ i ][ l ] * reference[ l ][ j ];
+    }
+  if( right != rightRef || left != leftRef )
+  {
+    std::cerr << "Error: rightmultiply/leftmultiply of a " << n << "x" << m
+              << " matrix of type " << className<K>() << " is wrong" << std::endl;
+    ++errors;
+  }
+  return errors;
+}
+
 template <class M>
 void checkNormNAN(M const &v, int line) {
   if (!std::isnan(v.frobenius_norm())) {
@@ -967,6 +1025,14 @@ int main()
     test_invert< std::complex< float >, 2 >();
     errors += test_invert_solve();
 
+    errors += test_tiled_product< double, 8, 8, 8 >();
+    errors += test_tiled_product< double, 9, 13, 17 >();
+    errors += test_tiled_product< double, 33, 7, 40 >();
+    errors += test_tiled_product< double, 64, 64, 64 >();
+    errors += test_tiled_product< float, 20, 20, 20 >();
+    errors += test_tiled_product< int, 10, 12, 11 >();
+    errors += test_tiled_product< std::complex<double>, 8, 8, 8 >();
+
     {  // Test whether multiplying one-column matrices by scalars work
       FieldMatrix<double,3,1> A = {1,2,3};
       double v = 0;
@@ -3,9 +3,14 @@
 // SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
 // SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
 #include <array>
+#include <complex>
+#include <vector>
 
+#include <dune/common/binaryfunctions.hh>
+#include <dune/common/fvector.hh>
 #include <dune/common/parallel/mpihelper.hh>
 #include <dune/common/parallel/mpicommunication.hh>
+#include <dune/common/simd/loop.hh>
 #include <dune/common/test/testsuite.hh>
 
 #include <iostream>
@@ -54,6 +59,58 @@ int main(int argc, char** argv)
       t.check(sum == comm.size())
         << "sum of 1 must be equal to number of processes";
     }
+
+    // reductions of types with intrinsic entries
+    {
+      using Vector = Dune::FieldVector<double,3>;
+      const Vector sum = comm.sum(Vector{1.0, 2.0, 3.0});
+      t.check(sum == Vector{1.0*comm.size(), 2.0*comm.size(), 3.0*comm.size()})
+        << "sum of FieldVector is wrong";
+
+      std::vector<Vector> vectors(4, Vector{1.0, 2.0, 3.0});
+      comm.sum(vectors.data(), vectors.size());
+      for(const Vector& v : vectors)
+        t.check(v == sum) << "sum of FieldVector array is wrong";
+
+      using ComplexVector = Dune::FieldVector<std::complex<double>,2>;
+      const ComplexVector csum = comm.sum(ComplexVector{std::complex<double>(1.0, -1.0), 2.0});
+      t.check(csum == ComplexVector{std::complex<double>(comm.size(), -comm.size()), 2.0*comm.size()})
+        << "sum of complex FieldVector is wrong";
+
+      using Simd = Dune::LoopSIMD<double,4>;
+      Simd lanes;
+      for(int l = 0; l < 4; ++l)
+        lanes[l] = (l%2 == 0) ? comm.rank() : -comm.rank();
+      const Simd max = comm.max(lanes);
+      const Simd min = comm.min(lanes);
+      const Simd simdSum = comm.sum(Simd(1.0));
+      for(int l = 0; l < 4; ++l) {
+        t.check(max[l] == ((l%2 == 0) ? comm.size()-1 : 0)) << "max of LoopSIMD is wrong";
+        t.check(min[l] == ((l%2 == 0) ? 0 : 1-comm.size())) << "min of LoopSIMD is wrong";
+        t.check(simdSum[l] == comm.size()) << "sum of LoopSIMD is wrong";
+      }
+
+#if HAVE_MPI
+      static_assert(Dune::Impl::IntrinsicReduction<std::plus<Vector> >::value);
+      static_assert(Dune::Impl::IntrinsicReduction<std::plus<ComplexVector> >::value);
+      static_assert(Dune::Impl::IntrinsicReduction<Dune::Max<Simd> >::value);
+      static_assert(!Dune::Impl::IntrinsicReduction<std::multiplies<Vector> >::value);
+#endif
+    }
+
+    // segmented reduction of a long array
+    {
+      const int len = 10007;
+      std::vector<double> in(len), out(len);
+      for(int i = 0; i < len; ++i)
+        in[i] = i + comm.rank();
+      comm.allreduce<std::plus<double> >(in.data(), out.data(), len, 1000);
+      const double ranks = comm.size()*(comm.size()-1)/2.0;
+      bool correct = true;
+      for(int i = 0; i < len; ++i)
+        correct = correct && out[i] == double(i)*comm.size() + ranks;
+      t.check(correct) << "segmented allreduce is wrong";
+    }
   }
 
   std::cout << "We are at the end!"<<std::endl;
@@ -0,0 +1,268 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include <dune/common/sllist.hh>
+#include <dune/common/vectorlist.hh>
+#include <dune/common/test/iteratortest.hh>
+
+template<typename T, class A>
+int check(const Dune::VectorList<T,A>& alist, std::initializer_list<T> vals, int line)
+{
+  int ret = 0;
+  if(alist.size() != int(vals.size())) {
+    std::cerr<<"Expected "<<vals.size()<<" entries, got "<<alist.size()<<"! "<<__FILE__<<":"<<line<<std::endl;
+    return 1;
+  }
+  auto val = vals.begin();
+  for(auto iter = alist.begin(); iter != alist.end(); ++iter, ++val)
+    if(*iter != *val) {
+      std::cerr<<"Expected "<<*val<<", got "<<*iter<<"! "<<__FILE__<<":"<<line<<std::endl;
+      ++ret;
+    }
+  return ret;
+}
+
+int testPushPop()
+{
+  Dune::VectorList<int> alist;
+  int ret = 0;
+
+  if(alist.begin() != alist.end() || !alist.empty()) {
+    std::cerr<<"Newly created list not empty! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ret++;
+  }
+
+  alist.push_back(1);
+  alist.push_back(2);
+  alist.push_front(3);
+  ret += check(alist, {3, 1, 2}, __LINE__);
+
+  alist.pop_front();
+  ret += check(alist, {1, 2}, __LINE__);
+
+  alist.clear();
+  if(!alist.empty() || alist.size() != 0) {
+    std::cerr<<"Emptied list not empty! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ret++;
+  }
+  return ret;
+}
+
+int testInsert()
+{
+  typedef Dune::VectorList<int> List;
+  List alist;
+  int ret = 0;
+
+  alist.push_back(3);
+  List::ModifyIterator iter = alist.beginModify();
+  iter.insert(7);
+
+  if(*iter != 3) {
+    std::cerr<<"Value at current position changed due to insert! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ret++;
+  }
+  alist.finishModify();
+  ret += check(alist, {7, 3}, __LINE__);
+
+  iter = alist.beginModify();
+  iter.insert(5);
+  ++iter;
+  iter.insert(6);
+  iter = alist.endModify();
+  if(iter != alist.end()) {
+    std::cerr<<"Iterator got by endModify does not equal that got by end()! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ret++;
+  }
+  iter.insert(20);
+  if(iter != alist.end()) {
+    std::cerr<<"Insertion changed end iterator! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ret++;
+  }
+  alist.finishModify();
+  ret += check(alist, {5, 7, 6, 3, 20}, __LINE__);
+
+  alist.clear();
+  iter = alist.beginModify();
+  iter.insert(5);
+  if(iter != alist.end()) {
+    std::cerr<<"Insertion into empty list failed! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ret++;
+  }
+  alist.finishModify();
+  ret += check(alist, {5}, __LINE__);
+  return ret;
+}
+
+int testDelete()
+{
+  typedef Dune::VectorList<int> List;
+  List alist;
+  int ret = 0;
+
+  for(int i = 0; i < 6; ++i)
+    alist.push_back(i);
+
+  List::ModifyIterator iter = alist.beginModify();
+  iter.remove();
+  if(*iter != 1) {
+    std::cerr<<"Remove did not advance the iterator! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ret++;
+  }
+  ++iter;
+  iter.insert(10);
+  iter.remove();
+  iter.insert(11);
+  ++iter;
+  iter.remove();
+  iter.remove();
+  if(iter != alist.end()) {
+    std::cerr<<"Removing the last entry did not reach the end! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ret++;
+  }
+  alist.finishModify();
+  ret += check(alist, {1, 10, 11, 3}, __LINE__);
+
+  // size() must not invalidate the modify iterator
+  iter = alist.beginModify();
+  iter.remove();
+  if(alist.size() != 3 || *iter != 10) {
+    std::cerr<<"size() changed the modify iterator! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ret++;
+  }
+  iter.insert(12);
+  if(alist.size() != 4 || alist.empty()) {
+    std::cerr<<"size() ignores pending insertions! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ret++;
+  }
+  alist.finishModify();
+  ret += check(alist, {12, 10, 11, 3}, __LINE__);
+  return ret;
+}
+
+int testBulkInsert()
+{
+  Dune::VectorList<int> alist;
+  int ret = 0;
+
+  std::vector<std::pair<std::size_t,int> > entries = {{0, 1}, {0, 2}, {0, 3}};
+  alist.insert(entries.begin(), entries.end());
+  ret += check(alist, {1, 2, 3}, __LINE__);
+
+  // the pending removal is merged before the positions are resolved
+  alist.beginModify().remove();
+  entries = {{0, 4}, {1, 5}, {2, 6}, {2, 7}};
+  alist.insert(entries.begin(), entries.end());
+  ret += check(alist, {4, 2, 5, 3, 6, 7}, __LINE__);
+  return ret;
+}
+
+// Modify a VectorList and an SLList in lockstep and compare them.
+int testRandom()
+{
+  Dune::VectorList<int> vlist;
+  Dune::SLList<int> slist;
+  int ret = 0;
+
+  std::srand(12);
+  for(int round = 0; round < 20; ++round) {
+    auto viter = vlist.beginModify();
+    auto siter = slist.beginModify();
+    auto send = slist.endModify();
+    for(; siter != send; ) {
+      switch(std::rand() % 4) {
+      case 0 :
+        viter.remove();
+        siter.remove();
+        break;
+      case 1 : {
+        int value = std::rand();
+        viter.insert(value);
+        siter.insert(value);
+        break;
+      }
+      default :
+        if(*viter != *siter) {
+          std::cerr<<"Modify iterators disagree! "<<__FILE__<<":"<<__LINE__<<std::endl;
+          ret++;
+        }
+        ++viter;
+        ++siter;
+      }
+    }
+    for(int i = std::rand() % 10; i > 0; --i) {
+      int value = std::rand();
+      viter.insert(value);
+      siter.insert(value);
+    }
+    if(viter != vlist.end()) {
+      std::cerr<<"Modify iterator did not reach the end! "<<__FILE__<<":"<<__LINE__<<std::endl;
+      ret++;
+    }
+
+    if(vlist.size() != slist.size()) {
+      std::cerr<<"Sizes differ! "<<__FILE__<<":"<<__LINE__<<std::endl;
+      ret++;
+      continue;
+    }
+    auto siter1 = slist.begin();
+    for(auto viter1 = vlist.begin(); viter1 != vlist.end(); ++viter1, ++siter1)
+      if(*viter1 != *siter1) {
+        std::cerr<<"Entries differ! "<<__FILE__<<":"<<__LINE__<<std::endl;
+        ret++;
+      }
+  }
+  return ret;
+}
+
+int testCompare()
+{
+  Dune::VectorList<int> alist, blist;
+  int ret = 0;
+
+  alist.push_back(1);
+  blist.push_back(2);
+  if(alist == blist) {
+    std::cerr<<"Different lists compare equal! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ret++;
+  }
+  // both become (2, 1) when the pending inserts are merged
+  alist.beginModify().insert(2);
+  blist.endModify().insert(1);
+  alist.finishModify();
+  blist.finishModify();
+  if(alist != blist) {
+    std::cerr<<"Equal lists compare different! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ret++;
+  }
+  return ret;
+}
+
+int main()
+{
+  int ret = 0;
+
+  Dune::VectorList<double> list;
+  for(int i = 0; i < 100; ++i)
+    list.push_back(i * 0.5);
+  ret += testIterator(list);
+
+  Dune::VectorList<double>::ModifyIterator lbegin = list.beginModify(), lend = list.endModify();
+  Printer<double> print;
+  ret += testConstIterator(lbegin, lend, print);
+
+  ret += testPushPop();
+  ret += testInsert();
+  ret += testDelete();
+  ret += testBulkInsert();
+  ret += testRandom();
+  ret += testCompare();
+
+  return ret;
+}
@@ -0,0 +1,606 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_VECTORLIST_HH
+#define DUNE_COMMON_VECTORLIST_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include <dune/common/iteratorfacades.hh>
+
+namespace Dune
+{
+  /**
+   * @addtogroup Common
+   *
+   * @{
+   */
+  /**
+   * @file
+   * \brief Implements a contiguously stored list with the interface of SLList.
+   */
+
+  template<typename T, class A>
+  class VectorListIterator;
+
+  template<typename T, class A>
+  class VectorListConstIterator;
+
+  template<typename T, class A>
+  class VectorListModifyIterator;
+
+  /**
+   * @brief A list stored contiguously with the interface of SLList.
+   *
+   * The entries are stored in a std::vector, which avoids chasing pointers
+   * when iterating. Insertions and removals through a ModifyIterator are not
+   * carried out immediately but collected and merged into the vector in one
+   * pass by finishModify() or by the next non-constant traversal, i.e. by
+   * begin(), beginModify(), push_back() and the like. Thus k modifications
+   * cost O(n+k) instead of the O(nk) of inserting into a vector one by one.
+   * Several entries can also be inserted at once by insert(). size() and
+   * empty() take the pending modifications into account without merging
+   * them.
+   *
+   * Until then ModifyIterators traverse the entries without the pending
+   * modifications: an inserted entry is placed before the current entry
+   * (as with SLList) and a removed one is skipped. Merging the modifications
+   * invalidates all iterators except end().
+   *
+   * The constant methods never change the list, such that several threads
+   * may traverse it at the same time. Therefore there must not be pending
+   * modifications when calling them.
+   *
+   * Unlike for SLList, the allocator has to allocate arrays, so allocators
+   * for single nodes like PoolAllocator cannot be used.
+   */
+  template<typename T, class A=std::allocator<T> >
+  class VectorList
+  {
+    friend class VectorListIterator<T,A>;
+    friend class VectorListConstIterator<T,A>;
+    friend class VectorListModifyIterator<T,A>;
+
+  public:
+    /**
+     * @brief The size type.
+     */
+    typedef typename std::allocator_traits<A>::size_type size_type;
+
+    /**
+     * @brief The type we store.
+     */
+    typedef T MemberType;
+
+    /**
+     * @brief The allocator to use.
+     */
+    using Allocator = typename std::allocator_traits<A>::template rebind_alloc<T>;
+
+    /**
+     * @brief The mutable iterator of the list.
+     */
+    typedef VectorListIterator<T,A> iterator;
+
+    /**
+     * @brief The constant iterator of the list.
+     */
+    typedef VectorListConstIterator<T,A> const_iterator;
+
+    /**
+     * @brief The type of the iterator capable of deletion
+     * and insertion.
+     */
+    typedef VectorListModifyIterator<T,A> ModifyIterator;
+
+    /**
+     * @brief Add a new entry to the end of the list.
+     * @param item The item to add.
+     */
+    inline void push_back(const MemberType& item);
+
+    /**
+     * @brief Add a new entry to the beginning of the list.
+     * @param item The item to add.
+     */
+    inline void push_front(const MemberType& item);
+
+    /**
+     * @brief Remove the first item in the list.
+     */
+    inline void pop_front();
+
+    /** @brief Remove all elements from the list. */
+    inline void clear();
+
+    /**
+     * @brief Reserve storage for a number of entries.
+     */
+    inline void reserve(size_type size);
+
+    /**
+     * @brief Insert several entries in one pass.
+     *
+     * Pending modifications are merged first.
+     * @param first The first of pairs of the position to insert before
+     * and the entry to insert, sorted by position. A position equal
+     * to size() appends the entry.
+     * @param last The end of the pairs.
+     */
+    template<class Iterator>
+    void insert(Iterator first, Iterator last);
+
+    /**
+     * @brief Merge the pending insertions and removals of the
+     * ModifyIterators into the entries.
+     *
+     * Invalidates all iterators except end().
+     */
+    void finishModify();
+
+    /**
+     * @brief Get an iterator pointing to the first element in the list.
+     */
+    inline iterator begin();
+
+    /**
+     * @brief Get an iterator pointing to the first element in the list.
+     *
+     * There must not be pending modifications.
+     */
+    inline const_iterator begin() const;
+
+    /**
+     * @brief Get an iterator capable of deleting and inserting elements.
+     *
+     * @return Modification iterator positioned at the beginning of the list.
+     */
+    inline ModifyIterator beginModify();
+
+    /**
+     * @brief Get an iterator capable of deleting and inserting elements.
+     *
+     * @return Modification iterator positioned behind the end of the list.
+     */
+    inline ModifyIterator endModify();
+
+    /**
+     * @brief Get an iterator pointing to the end of the list.
+     */
+    inline iterator end();
+
+    /**
+     * @brief Get an iterator pointing to the end of the list.
+     */
+    inline const_iterator end() const;
+
+    /**
+     * @brief Check whether the list is empty.
+     */
+    inline bool empty() const;
+
+    /**
+     * @brief Get the number of elements the list contains.
+     */
+    inline int size() const;
+
+    bool operator==(const VectorList& other) const;
+
+    bool operator!=(const VectorList& other) const;
+
+  private:
+    /** @brief The position marking the end of the list. */
+    constexpr static size_type npos = std::numeric_limits<size_type>::max();
+
+    /** @brief Whether there are no pending modifications. */
+    bool isFinished() const;
+
+    /** @brief The entries of the list. */
+    std::vector<T,Allocator> entries_;
+
+    /** @brief The pending insertions together with the position to insert before. */
+    std::vector<std::pair<size_type,T>,
+        typename std::allocator_traits<A>::template rebind_alloc<std::pair<size_type,T> > > inserted_;
+
+    /** @brief The positions of the pending removals. */
+    std::vector<size_type,
+        typename std::allocator_traits<A>::template rebind_alloc<size_type> > removed_;
+  };
+
+  /**
+   * @brief A mutable iterator for the VectorList.
+   */
+  template<typename T, class A>
+  class VectorListIterator : public Dune::ForwardIteratorFacade<VectorListIterator<T,A>, T, T&, std::size_t>
+  {
+    friend class VectorList<T,A>;
+    friend class VectorListConstIterator<T,A>;
+    friend class VectorListModifyIterator<T,A>;
+
+  public:
+    inline VectorListIterator()
+      : list_(nullptr), position_(VectorList<T,A>::npos)
+    {}
+
+    inline VectorListIterator(const VectorListModifyIterator<T,A>& other)
+      : list_(other.list_), position_(other.position_)
+    {}
+
+    /**
+     * @brief Dereferencing function for the iterator facade.
+     * @return A reference to the element at the current position.
+     */
+    inline T& dereference() const
+    {
+      return list_->entries_[position_];
+    }
+
+    /**
+     * @brief Equality test for the iterator facade.
+     * @param other The other iterator to check.
+     * @return true If the other iterator is at the same position.
+     */
+    template<class I>
+    inline bool equals(const I& other) const
+    {
+      return index() == other.index();
+    }
+
+    /**
+     * @brief Increment function for the iterator facade.
+     */
+    inline void increment()
+    {
+      ++position_;
+    }
+
+  private:
+    inline VectorListIterator(VectorList<T,A>* list, std::size_t position)
+      : list_(list), position_(position)
+    {}
+
+    /** @brief The position with the end resolved. */
+    inline std::size_t index() const
+    {
+      return (list_ && position_ == VectorList<T,A>::npos) ? list_->entries_.size() : position_;
+    }
+
+    /** @brief The list we iterate over. */
+    VectorList<T,A>* list_;
+    /** @brief The current position. */
+    std::size_t position_;
+  };
+
+  /**
+   * @brief A constant iterator for the VectorList.
+   */
+  template<class T, class A>
+  class VectorListConstIterator : public Dune::ForwardIteratorFacade<VectorListConstIterator<T,A>, const T, const T&, std::size_t>
+  {
+    friend class VectorList<T,A>;
+    friend class VectorListIterator<T,A>;
+    friend class VectorListModifyIterator<T,A>;
+
+  public:
+    inline VectorListConstIterator()
+      : list_(nullptr), position_(VectorList<T,A>::npos)
+    {}
+
+    inline VectorListConstIterator(const VectorListIterator<T,A>& other)
+      : list_(other.list_), position_(other.position_)
+    {}
+
+    inline VectorListConstIterator(const VectorListModifyIterator<T,A>& other)
+      : list_(other.list_), position_(other.position_)
+    {}
+
+    /**
+     * @brief Dereferencing function for the facade.
+     * @return A reference to the element at the current position.
+     */
+    inline const T& dereference() const
+    {
+      return list_->entries_[position_];
+    }
+
+    /**
+     * @brief Equality test for the iterator facade.
+     * @param other The other iterator to check.
+     * @return true If the other iterator is at the same position.
+     */
+    template<class I>
+    inline bool equals(const I& other) const
+    {
+      return index() == other.index();
+    }
+
+    /**
+     * @brief Increment function for the iterator facade.
+     */
+    inline void increment()
+    {
+      ++position_;
+    }
+
+  private:
+    inline VectorListConstIterator(const VectorList<T,A>* list, std::size_t position)
+      : list_(list), position_(position)
+    {}
+
+    /** @brief The position with the end resolved. */
+    inline std::size_t index() const
+    {
+      return (list_ && position_ == VectorList<T,A>::npos) ? list_->entries_.size() : position_;
+    }
+
+    /** @brief The list we iterate over. */
+    const VectorList<T,A>* list_;
+    /** @brief The current position. */
+    std::size_t position_;
+  };
+
+  /**
+   * @brief A mutable iterator for the VectorList that can insert and remove
+   * entries.
+   */
+  template<typename T, class A>
+  class VectorListModifyIterator : public Dune::ForwardIteratorFacade<VectorListModifyIterator<T,A>, T, T&, std::size_t>
+  {
+    friend class VectorList<T,A>;
+    friend class VectorListIterator<T,A>;
+    friend class VectorListConstIterator<T,A>;
+
+  public:
+    inline VectorListModifyIterator()
+      : list_(nullptr), position_(VectorList<T,A>::npos)
+    {}
+
+    /**
+     * @brief Dereferencing function for the iterator facade.
+     * @return A reference to the element at the current position.
+     */
+    inline T& dereference() const
+    {
+      return list_->entries_[position_];
+    }
+
+    /**
+     * @brief Test whether another iterator is equal.
+     * @return true if the other iterator is at the same position as
+     * this one.
+     */
+    template<class I>
+    inline bool equals(const I& other) const
+    {
+      return index() == other.index();
+    }
+
+    /**
+     * @brief Increment function for the iterator facade.
+     */
+    inline void increment()
+    {
+      ++position_;
+    }
+
+    /**
+     * @brief Insert an element in the underlying list before the current position.
+     *
+     * Starting from the element at the current position all elements will
+     * be shifted by one position to the back when the modifications are
+     * merged. The iterator will point to the same element as before.
+     * @param v The value to insert.
+     */
+    inline void insert(const T& v)
+    {
+      list_->inserted_.emplace_back(index(), v);
+    }
+
+    /**
+     * @brief Delete the entry at the current position.
+     *
+     * The iterator will be positioned at the next position afterwards.
+     */
+    inline void remove()
+    {
+      list_->removed_.push_back(position_);
+      ++position_;
+    }
+
+  private:
+    inline VectorListModifyIterator(VectorList<T,A>* list, std::size_t position)
+      : list_(list), position_(position)
+    {}
+
+    /** @brief The position with the end resolved. */
+    inline std::size_t index() const
+    {
+      return (list_ && position_ == VectorList<T,A>::npos) ? list_->entries_.size() : position_;
+    }
+
+    /** @brief The list we modify. */
+    VectorList<T,A>* list_;
+    /** @brief The current position. */
+    std::size_t position_;
+  };
+
+  template<typename T, typename A>
+  std::ostream& operator<<(std::ostream& os, const VectorList<T,A>& list)
+  {
+    typedef typename VectorList<T,A>::const_iterator Iterator;
+    Iterator end = list.end();
+    Iterator current= list.begin();
+
+    os << "(";
+
+    if(current!=end) {
+      os<<*current<<" ("<<static_cast<const void*>(&(*current))<<")";
+      ++current;
+
+      for(; current != end; ++current)
+        os<<", "<<*current<<" ("<<static_cast<const void*>(&(*current))<<")";
+    }
+    os<<") ";
+    return os;
+  }
+
+  template<typename T, class A>
+  inline void VectorList<T,A>::push_back(const MemberType& item)
+  {
+    finishModify();
+    entries_.push_back(item);
+  }
+
+  template<typename T, class A>
+  inline void VectorList<T,A>::push_front(const MemberType& item)
+  {
+    finishModify();
+    entries_.insert(entries_.begin(), item);
+  }
+
+  template<typename T, class A>
+  inline void VectorList<T,A>::pop_front()
+  {
+    finishModify();
+    entries_.erase(entries_.begin());
+  }
+
+  template<typename T, class A>
+  inline void VectorList<T,A>::clear()
+  {
+    entries_.clear();
+    inserted_.clear();
+    removed_.clear();
+  }
+
+  template<typename T, class A>
+  inline void VectorList<T,A>::reserve(size_type size)
+  {
+    entries_.reserve(size);
+  }
+
+  template<typename T, class A>
+  template<class Iterator>
+  void VectorList<T,A>::insert(Iterator first, Iterator last)
+  {
+    finishModify();
+    inserted_.insert(inserted_.end(), first, last);
+    finishModify();
+  }
+
+  template<typename T, class A>
+  inline typename VectorList<T,A>::iterator VectorList<T,A>::begin()
+  {
+    finishModify();
+    return iterator(this, 0);
+  }
+
+  template<typename T, class A>
+  inline typename VectorList<T,A>::const_iterator VectorList<T,A>::begin() const
+  {
+    assert(isFinished());
+    return const_iterator(this, 0);
+  }
+
+  template<typename T, class A>
+  inline typename VectorList<T,A>::ModifyIterator VectorList<T,A>::beginModify()
+  {
+    finishModify();
+    return ModifyIterator(this, 0);
+  }
+
+  template<typename T, class A>
+  inline typename VectorList<T,A>::ModifyIterator VectorList<T,A>::endModify()
+  {
+    finishModify();
+    return ModifyIterator(this, npos);
+  }
+
+  template<typename T, class A>
+  inline typename VectorList<T,A>::iterator VectorList<T,A>::end()
+  {
+    return iterator(this, npos);
+  }
+
+  template<typename T, class A>
+  inline typename VectorList<T,A>::const_iterator VectorList<T,A>::end() const
+  {
+    return const_iterator(this, npos);
+  }
+
+  template<typename T, class A>
+  inline bool VectorList<T,A>::empty() const
+  {
+    return size() == 0;
+  }
+
+  template<typename T, class A>
+  inline int VectorList<T,A>::size() const
+  {
+    // Each position is removed at most once
+    return entries_.size() + inserted_.size() - removed_.size();
+  }
+
+  template<typename T, class A>
+  bool VectorList<T,A>::operator==(const VectorList& other) const
+  {
+    assert(isFinished() && other.isFinished());
+    return entries_.size() == other.entries_.size()
+           && std::equal(entries_.begin(), entries_.end(), other.entries_.begin());
+  }
+
+  template<typename T, class A>
+  bool VectorList<T,A>::operator!=(const VectorList& other) const
+  {
+    return !(*this == other);
+  }
+
+  template<typename T, class A>
+  inline bool VectorList<T,A>::isFinished() const
+  {
+    return inserted_.empty() && removed_.empty();
+  }
+
+  template<typename T, class A>
+  void VectorList<T,A>::finishModify()
+  {
+    if(isFinished())
+      return;
+
+    // Several ModifyIterators might have been used
+    std::stable_sort(inserted_.begin(), inserted_.end(),
+                     [](const auto& a, const auto& b){ return a.first < b.first; });
+    std::sort(removed_.begin(), removed_.end());
+
+    std::vector<T,Allocator> entries;
+    entries.reserve(entries_.size() + inserted_.size());
+    auto inserted = inserted_.begin();
+    auto removed = removed_.begin();
+    for(size_type i=0; i <= entries_.size(); ++i) {
+      for(; inserted != inserted_.end() && inserted->first == i; ++inserted)
+        entries.push_back(std::move(inserted->second));
+      if(i == entries_.size())
+        break;
+      if(removed != removed_.end() && *removed == i) {
+        while(removed != removed_.end() && *removed == i)
+          ++removed;
+        continue;
+      }
+      entries.push_back(std::move(entries_[i]));
+    }
+    entries_.swap(entries);
+    inserted_.clear();
+    removed_.clear();
+  }
+
+  /** }@ */
+}
+#endif